@@ -0,0 +1,96 @@
+/********************************************************************************
+ * File: bench_byte_search.cpp
+ * Author: ppkantorski
+ * Description:
+ *   Host benchmark for the byte-pattern search kernel in source/byte_search.hpp.
+ *   Reports GB/s for findBytePattern, its scalar fallback and std::string_view::find
+ *   on synthetic 1-64 MB buffers, and checks that all three agree.
+ *
+ *   Build and run from the repository root:
+ *     g++ -O2 -std=c++17 -Isource extra/bench_byte_search.cpp -o bench_byte_search
+ *     ./bench_byte_search
+ *
+ *  Licensed under GPLv2
+ *  Copyright (c) 2023-2025 ppkantorski
+ ********************************************************************************/
+
+#include <byte_search.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Candidate {
+    const char* name;
+    size_t (*search)(const uint8_t* data, size_t size, const uint8_t* pattern, size_t patternLen);
+};
+
+size_t searchKernel(const uint8_t* data, size_t size, const uint8_t* pattern, size_t patternLen) {
+    return findBytePattern(data, size, pattern, patternLen);
+}
+
+size_t searchScalar(const uint8_t* data, size_t size, const uint8_t* pattern, size_t patternLen) {
+    return findBytePatternScalar(data, size, pattern, patternLen);
+}
+
+size_t searchStd(const uint8_t* data, size_t size, const uint8_t* pattern, size_t patternLen) {
+    const std::string_view haystack(reinterpret_cast<const char*>(data), size);
+    return haystack.find(std::string_view(reinterpret_cast<const char*>(pattern), patternLen));
+}
+
+// Random bytes, or a kip-like buffer that is mostly zero with sparse non-zero words
+std::vector<uint8_t> makeBuffer(size_t size, bool zeroHeavy, std::mt19937& rng) {
+    std::vector<uint8_t> buffer(size);
+    if (zeroHeavy) {
+        for (size_t i = 0; i + 4 <= size; i += 64)
+            for (size_t b = 0; b < 4; ++b)
+                buffer[i + b] = static_cast<uint8_t>(rng());
+    } else {
+        for (auto& byte : buffer)
+            byte = static_cast<uint8_t>(rng());
+    }
+    return buffer;
+}
+
+}
+
+int main() {
+    const Candidate candidates[] = {
+        {"findBytePattern", searchKernel},
+        {"scalar", searchScalar},
+        {"string_view::find", searchStd},
+    };
+    // The pattern is planted at the very end so every search walks the whole buffer
+    const uint8_t pattern[] = {0x00, 0x00, 0xA0, 0xE3, 0x1E, 0xFF, 0x2F, 0xE1};
+    std::mt19937 rng(0x5EED);
+    bool agree = true;
+
+    std::printf("%-9s %-10s %-18s %10s\n", "size", "buffer", "search", "GB/s");
+    for (size_t megabytes = 1; megabytes <= 64; megabytes *= 2) {
+        for (const bool zeroHeavy : {false, true}) {
+            auto buffer = makeBuffer(megabytes << 20, zeroHeavy, rng);
+            std::memcpy(buffer.data() + buffer.size() - sizeof(pattern), pattern, sizeof(pattern));
+            const size_t expected = buffer.size() - sizeof(pattern);
+
+            for (const auto& candidate : candidates) {
+                const int rounds = static_cast<int>(std::max<size_t>(1, 256 / megabytes));
+                size_t found = 0;
+                const auto start = std::chrono::steady_clock::now();
+                for (int round = 0; round < rounds; ++round)
+                    found = candidate.search(buffer.data(), buffer.size(), pattern, sizeof(pattern));
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                if (found != expected) {
+                    std::printf("%s returned %zu, expected %zu\n", candidate.name, found, expected);
+                    agree = false;
+                }
+                const double gigabytes = static_cast<double>(buffer.size()) * rounds / 1e9;
+                std::printf("%4zu MB   %-10s %-18s %10.2f\n", megabytes, zeroHeavy ? "zero-heavy" : "random",
+                            candidate.name, gigabytes / elapsed.count());
+            }
+        }
+    }
+    return agree ? 0 : 1;
+}
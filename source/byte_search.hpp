@@ -0,0 +1,119 @@
+/********************************************************************************
+ * File: byte_search.hpp
+ * Author: ppkantorski
+ * Description:
+ *   This header file contains the byte-pattern search kernel used by the hex
+ *   scans in utils.hpp. It only depends on the C++ standard library so it can
+ *   also be built and benchmarked on a host (see extra/bench_byte_search.cpp).
+ *
+ *   For the latest updates and contributions, visit the project's GitHub repository.
+ *   (GitHub Repository: https://github.com/ppkantorski/Ultrahand-Overlay)
+ *
+ *   Note: Please be aware that this notice cannot be altered or removed. It is a part
+ *   of the project's documentation and must remain intact.
+ *
+ *  Licensed under GPLv2
+ *  Copyright (c) 2023-2025 ppkantorski
+ ********************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Scalar byte-pattern search starting at pos: memchr on the first byte, then a
+ * last-byte check and memcmp. Used for buffer tails and on targets without SIMD.
+ */
+inline size_t findBytePatternScalar(const uint8_t* data, size_t size, const uint8_t* pattern, size_t patternLen, size_t pos = 0) {
+    if (patternLen == 0 || patternLen > size)
+        return std::string::npos;
+
+    const size_t last = patternLen - 1;
+    const size_t positions = size - last;  // number of possible start positions
+    while (pos < positions) {
+        const void* hit = std::memchr(data + pos, pattern[0], positions - pos);
+        if (!hit)
+            break;
+        pos = static_cast<size_t>(static_cast<const uint8_t*>(hit) - data);
+        if (data[pos + last] == pattern[last] && (patternLen < 3 || std::memcmp(data + pos + 1, pattern + 1, patternLen - 2) == 0))
+            return pos;
+        ++pos;
+    }
+    return std::string::npos;
+}
+
+/**
+ * @brief Finds the first occurrence of a byte pattern in a buffer.
+ *
+ * Candidate positions are filtered 16 at a time by comparing the pattern's first and last
+ * bytes (NEON on the Switch, SSE2 on x86 hosts) and confirmed with memcmp; the remainder and
+ * targets without SIMD use findBytePatternScalar.
+ *
+ * @param data The buffer to search.
+ * @param size Size of the buffer in bytes.
+ * @param pattern The bytes to find.
+ * @param patternLen Length of the pattern in bytes.
+ * @return Offset of the first match, or std::string::npos if there is none.
+ */
+inline size_t findBytePattern(const uint8_t* data, size_t size, const uint8_t* pattern, size_t patternLen) {
+    if (patternLen == 0 || patternLen > size)
+        return std::string::npos;
+
+    if (patternLen == 1) {
+        const void* hit = std::memchr(data, pattern[0], size);
+        return hit ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - data) : std::string::npos;
+    }
+
+    const size_t last = patternLen - 1;
+    const size_t positions = size - last;  // number of possible start positions
+    size_t pos = 0;
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    const uint8x16_t firstBytes = vdupq_n_u8(pattern[0]);
+    const uint8x16_t lastBytes = vdupq_n_u8(pattern[last]);
+    for (; pos + 16 <= positions; pos += 16) {
+        const uint8x16_t candidates = vandq_u8(vceqq_u8(vld1q_u8(data + pos), firstBytes),
+                                               vceqq_u8(vld1q_u8(data + pos + last), lastBytes));
+        if (vmaxvq_u8(candidates) == 0)
+            continue;
+
+        // Narrow to one nibble per byte so the candidates fit in a 64-bit mask
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(candidates), 4)), 0);
+        while (mask) {
+            const size_t lane = static_cast<size_t>(__builtin_ctzll(mask)) >> 2;
+            if (std::memcmp(data + pos + lane + 1, pattern + 1, patternLen - 2) == 0)
+                return pos + lane;
+            mask &= ~(0xFULL << (lane * 4));
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i firstBytes = _mm_set1_epi8(static_cast<char>(pattern[0]));
+    const __m128i lastBytes = _mm_set1_epi8(static_cast<char>(pattern[last]));
+    for (; pos + 16 <= positions; pos += 16) {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + last));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstBytes), _mm_cmpeq_epi8(blockLast, lastBytes))));
+        while (mask) {
+            const size_t lane = static_cast<size_t>(__builtin_ctz(mask));
+            if (std::memcmp(data + pos + lane + 1, pattern + 1, patternLen - 2) == 0)
+                return pos + lane;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    return findBytePatternScalar(data, size, pattern, patternLen, pos);
+}
+
+inline size_t findBytePattern(std::string_view data, std::string_view pattern) {
+    return findBytePattern(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                           reinterpret_cast<const uint8_t*>(pattern.data()), pattern.size());
+}
@@ -101,12 +101,15 @@ static const std::string WIDGET_PATTERN = ";widget=";
 
 static const std::string MINI_PATTERN = ";mini=";
 static const std::string SELECTION_MINI_PATTERN = ";selection_mini=";
+static const std::string NATURAL_SORT_PATTERN = ";natural_sort="; // true or false
+static const std::string BATCH_PATTERN = ";batch="; // true or false
 
 // Toggle option patterns
 static const std::string PROGRESS_PATTERN = ";progress=";
 
 // Table option patterns
 static const std::string POLLING_PATTERN = ";polling=";
+static const std::string POLLING_INTERVAL_PATTERN = ";polling_interval="; // milliseconds
 static const std::string SCROLLABLE_PATTERN = ";scrollable=";
 static const std::string TOP_PIVOT_PATTERN = ";top_pivot=";
 static const std::string BOTTOM_PIVOT_PATTERN = ";bottom_pivot=";
@@ -274,6 +277,7 @@ bool handleRunningInterpreter(uint64_t& keysDown, uint64_t& keysHeld) {
     static uint8_t lastOp = 255;
     static bool inProg = true;
     static uint8_t currentOpIndex = 0;  // Track which operation to check first
+    static int lastBatchPct = -1;
     
     static bool wasHoldingR = false;
 
@@ -281,8 +285,9 @@ bool handleRunningInterpreter(uint64_t& keysDown, uint64_t& keysHeld) {
     const bool releasedR = wasHoldingR && !(isHoldingR);
     wasHoldingR = isHoldingR;
 
-    // FIX: More robust abort handling
-    if ((releasedR && !(keysHeld & ~KEY_R & ALL_KEYS_MASK) && !stillTouching.load(acquire)) || externalAbortCommands.load(acquire)) {
+    // FIX: More robust abort handling (boot commands are never aborted half way)
+    if (!deferredBootCommands.active() &&
+        ((releasedR && !(keysHeld & ~KEY_R & ALL_KEYS_MASK) && !stillTouching.load(acquire)) || externalAbortCommands.load(acquire))) {
         // Set all abort flags with proper ordering
         abortDownload.store(true, release);
         abortUnzip.store(true, release);
@@ -295,6 +300,7 @@ bool handleRunningInterpreter(uint64_t& keysDown, uint64_t& keysHeld) {
         lastOp = 255;
         inProg = true;
         currentOpIndex = 0;  // Reset operation tracking
+        lastBatchPct = -1;
         
         return true;
     }
@@ -360,6 +366,8 @@ bool handleRunningInterpreter(uint64_t& keysDown, uint64_t& keysHeld) {
         }
     }
     
+    const int batchPct = batchPercentage.load(acquire);
+
     // Update UI only when necessary
     if (currentOp != 255 && (currentPct != lastPct || currentOp != lastOp)) {
         if (!displayed100) {
@@ -370,12 +378,24 @@ bool handleRunningInterpreter(uint64_t& keysDown, uint64_t& keysHeld) {
         lastPct = currentPct;
         lastOp = currentOp;
         inProg = true;  // Reset inProg when we have active operations
+        lastBatchPct = -1;
+    } else if (currentOp == 255 && batchPct >= 0) {
+        // Between file operations a command batch shows its overall progress
+        if (batchPct != lastBatchPct || inProg) {
+            displayPercentage.store(batchPct, release);
+            if (lastSelectedListItem && nextToggleState.empty())
+                lastSelectedListItem->setValue(INPROGRESS_SYMBOL + " " + ult::to_string(batchPct) + "%");
+            lastBatchPct = batchPct;
+            inProg = false;
+            lastPct = -1;
+        }
     } else if (currentOp == 255 && inProg) {  // Remove lastPct < 0 condition
         displayPercentage.store(-1, release);
         if (lastSelectedListItem && nextToggleState.empty())
             lastSelectedListItem->setValue(INPROGRESS_SYMBOL);
         inProg = false;
         lastPct = -1;  // Reset lastPct for next cycle
+        lastBatchPct = -1;
     }
     
     return false;
@@ -420,8 +440,10 @@ private:
             if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
 
                 if (targetMenu == "softwareUpdateMenu") {
-                    deleteFileOrDirectory(SETTINGS_PATH+"RELEASE.ini");
-                    downloadFile(LATEST_RELEASE_INFO_URL, SETTINGS_PATH);
+                    // Conditional request: an unchanged release costs a 304, a failed check leaves no stale info
+                    if (!networkSession.acquire() || !downloadFileResumable(LATEST_RELEASE_INFO_URL, SETTINGS_PATH))
+                        deleteFileOrDirectory(SETTINGS_PATH+"RELEASE.ini");
+                    networkSession.release();
                     downloadPercentage.store(-1, release);
                 } else if (targetMenu == "themeMenu") {
                     if (!isFile(THEMES_PATH+"ultra.ini")) {
@@ -559,7 +581,7 @@ private:
                 
 
                 if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, iniKey, item);
+                    settingsStore.setString(findSetting(iniKey), item);
                     
                     if (targetMenu == KEY_COMBO_STR) {
                         // Also set it in tesla config
@@ -618,11 +640,7 @@ private:
             executingCommands = true;
             isDownloadCommand.store(true, release);
             
-            std::vector<std::vector<std::string>> interpreterCommands = {
-                {"try:"},
-                {"delete", targetPath},
-                {"download", downloadUrl, DOWNLOADS_PATH}
-            };
+            std::vector<std::vector<std::string>> interpreterCommands = {{"try:"}};
     
             // === UPDATE_ULTRAHAND case ===
             if (title == UPDATE_ULTRAHAND) {
@@ -631,6 +649,7 @@ private:
                 const std::string versionLabel = cleanVersionLabel(parseValueFromIniSection((SETTINGS_PATH+"RELEASE.ini"), "Release Info", "latest_version"));
                 
                 // All downloads first
+                interpreterCommands.push_back({"download", downloadUrl, DOWNLOADS_PATH});
                 interpreterCommands.push_back({"download", UPDATER_PAYLOAD_URL, PAYLOADS_PATH});
                 interpreterCommands.push_back({"download", INCLUDED_THEME_FOLDER_URL + "ultra.ini", THEMES_PATH});
                 interpreterCommands.push_back({"download", INCLUDED_THEME_FOLDER_URL + "ultra-blue.ini", THEMES_PATH});
@@ -640,22 +659,19 @@ private:
                     interpreterCommands.push_back({"download", loaderUrl, DOWNLOADS_PATH});
                 }
                 
+                // Sound effects are extracted while they download
                 if (!disableSoundEffectsUpdate) {
-                    interpreterCommands.push_back({"download", SOUND_EFFECTS_URL, SOUNDS_PATH});
-                }
-                
-                // Process downloaded files
-                if (!disableSoundEffectsUpdate) {
-                    interpreterCommands.push_back({"unzip", SOUNDS_PATH + "sounds.zip", SOUNDS_PATH});
-                    interpreterCommands.push_back({"delete", SOUNDS_PATH + "sounds.zip"});
+                    interpreterCommands.push_back({"download-unzip", SOUND_EFFECTS_URL, SOUNDS_PATH});
                 }
                 
+                // Process downloaded files; the downloads stay in place so the next update
+                // check can be answered with a 304 instead of a full download
                 if (!disableLoaderUpdate) {
                     interpreterCommands.push_back({"unzip", DOWNLOADS_PATH + "nx-ovlloader.zip", ROOT_PATH});
-                    interpreterCommands.push_back({"delete", DOWNLOADS_PATH + "nx-ovlloader.zip"});
                 }
                 
-                interpreterCommands.push_back({"move", targetPath, movePath});
+                interpreterCommands.push_back({"copy", targetPath, movePath + ".tmp"});
+                interpreterCommands.push_back({"move", movePath + ".tmp", movePath});
                 
                 if (!versionLabel.empty()) {
                     interpreterCommands.push_back({"set-json-val", HB_APPSTORE_JSON, "version", versionLabel});
@@ -663,10 +679,9 @@ private:
             } 
             // === UPDATE_LANGUAGES case ===
             else {
-                interpreterCommands.push_back({"unzip", targetPath, movePath});
+                interpreterCommands.push_back({"download-unzip", downloadUrl, movePath});
+                interpreterCommands.push_back({"delete", targetPath});
             }
-            
-            interpreterCommands.push_back({"delete", targetPath});
     
             runningInterpreter.store(true, release);
             executeInterpreterCommands(std::move(interpreterCommands), "", "");
@@ -687,13 +702,13 @@ private:
                               const bool invertLogic = false, const bool useReloadMenu = false, const bool useReloadMenu2 = false, const bool isMini = true) {
 
         auto* toggleListItem = new tsl::elm::ToggleListItem(title, invertLogic ? !state : state, ON, OFF, isMini);
-        toggleListItem->setStateChangedListener([this, &state, iniKey, invertLogic, useReloadMenu, useReloadMenu2, listItem = toggleListItem, firstState = std::make_shared<std::optional<bool>>()](bool newState) {
+        toggleListItem->setStateChangedListener([this, &state, iniKey, setting = findSetting(iniKey), invertLogic, useReloadMenu, useReloadMenu2, listItem = toggleListItem, firstState = std::make_shared<std::optional<bool>>()](bool newState) {
             tsl::Overlay::get()->getCurrentGui()->requestFocus(listItem, tsl::FocusDirection::None);
             
             // Calculate the actual logical state first
             const bool actualState = invertLogic ? !newState : newState;
             
-            setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, iniKey, actualState ? TRUE_STR : FALSE_STR);
+            settingsStore.setBool(setting, actualState);
 
             // Store actualState on first click
             if (!firstState->has_value()) {
@@ -776,6 +791,7 @@ public:
 
     ~UltrahandSettingsMenu() {
         lastSelectedListItemFooter = "";
+        settingsStore.flush(); // leaving the settings menu writes the queued changes
         //tsl::elm::clearFrameCache();
     }
 
@@ -795,39 +811,12 @@ public:
         if (dropdownSelection.empty()) {
             addHeader(list, MAIN_SETTINGS);
             
-            // Load INI once and extract all values
-            auto ultrahandIniData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-            auto sectionIt = ultrahandIniData.find(ULTRAHAND_PROJECT_NAME);
-            
-            // Extract all values with defaults
-            std::string defaultLang = "";
-            std::string keyCombo = "";
-            std::string currentTheme = "";
-            std::string currentWallpaper = "";
-            
-            if (sectionIt != ultrahandIniData.end()) {
-                auto langIt = sectionIt->second.find(DEFAULT_LANG_STR);
-                if (langIt != sectionIt->second.end()) {
-                    defaultLang = langIt->second;
-                }
-                
-                auto comboIt = sectionIt->second.find(KEY_COMBO_STR);
-                if (comboIt != sectionIt->second.end()) {
-                    keyCombo = comboIt->second;
-                }
-                
-                auto themeIt = sectionIt->second.find("current_theme");
-                if (themeIt != sectionIt->second.end()) {
-                    currentTheme = themeIt->second;
-                }
-                
-                if (expandedMemory) {
-                    auto wallpaperIt = sectionIt->second.find("current_wallpaper");
-                    if (wallpaperIt != sectionIt->second.end()) {
-                        currentWallpaper = wallpaperIt->second;
-                    }
-                }
-            }
+            // Read the settings section once and extract all values
+            const auto ultrahandSection = settingsStore.section();
+            std::string defaultLang = getValueOrDefault(ultrahandSection, DEFAULT_LANG_STR, "");
+            std::string keyCombo = getValueOrDefault(ultrahandSection, KEY_COMBO_STR, "");
+            std::string currentTheme = getValueOrDefault(ultrahandSection, "current_theme", "");
+            std::string currentWallpaper = expandedMemory ? getValueOrDefault(ultrahandSection, "current_wallpaper", "") : "";
             
             // Apply defaults and processing
             trim(keyCombo);
@@ -855,12 +844,12 @@ public:
 
         } else if (dropdownSelection == KEY_COMBO_STR) {
             addHeader(list, KEY_COMBO);
-            std::string defaultCombo = parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, KEY_COMBO_STR);
+            std::string defaultCombo = settingsStore.getString(Setting::KeyCombo);
             trim(defaultCombo);
             handleSelection(list, defaultCombos, defaultCombo, KEY_COMBO_STR, KEY_COMBO_STR);
         } else if (dropdownSelection == "languageMenu") {
             addHeader(list, LANGUAGE);
-            const std::string defaulLang = parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, DEFAULT_LANG_STR);
+            const std::string defaulLang = settingsStore.getString(Setting::DefaultLang);
             size_t index = 0;
             std::string langFile;
             //tsl::elm::ListItem* listItem;
@@ -895,7 +884,7 @@ public:
                     }
                     if (triggerClick && tsl::elm::s_currentScrollVelocity <= 1.0f && tsl::elm::s_currentScrollVelocity >= -1.0f) {
                         triggerClick = false;
-                        setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, DEFAULT_LANG_STR, defaultLangMode);
+                        settingsStore.setString(Setting::DefaultLang, defaultLangMode);
                         reloadMenu = reloadMenu2 = true;
                         parseLanguage(langFile);
                         if (skipLang && defaultLangMode == "en") reinitializeLangVars();
@@ -1180,7 +1169,7 @@ public:
                 
         } else if (dropdownSelection == "themeMenu") {
             addHeader(list, THEME);
-            std::string currentTheme = parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_theme");
+            std::string currentTheme = settingsStore.getString(Setting::CurrentTheme);
             currentTheme = currentTheme.empty() ? DEFAULT_STR : currentTheme;
             auto* listItem = new tsl::elm::ListItem(DEFAULT);
             if (currentTheme == DEFAULT_STR) {
@@ -1192,7 +1181,7 @@ public:
                 if (runningInterpreter.load(acquire)) return false;
 
                 if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_theme", DEFAULT_STR);
+                    settingsStore.setString(Setting::CurrentTheme, DEFAULT_STR);
                     deleteFileOrDirectory(THEME_CONFIG_INI_PATH);
                     if (isFile(defaultTheme)) {
                         copyFileOrDirectory(defaultTheme, THEME_CONFIG_INI_PATH);
@@ -1237,7 +1226,7 @@ public:
                     if (runningInterpreter.load(acquire)) return false;
 
                     if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                        setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_theme", themeName);
+                        settingsStore.setString(Setting::CurrentTheme, themeName);
                         //deleteFileOrDirectory(THEME_CONFIG_INI_PATH);
                         copyFileOrDirectory(themeFile, THEME_CONFIG_INI_PATH);
                         copyPercentage.store(-1, release);
@@ -1263,7 +1252,7 @@ public:
             }
         } else if (dropdownSelection == "wallpaperMenu") {
             addHeader(list, WALLPAPER);
-            std::string currentWallpaper = parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_wallpaper");
+            std::string currentWallpaper = settingsStore.getString(Setting::CurrentWallpaper);
             currentWallpaper = currentWallpaper.empty() ? OPTION_SYMBOL : currentWallpaper;
 
             auto* listItem = new tsl::elm::ListItem(OPTION_SYMBOL);
@@ -1277,7 +1266,7 @@ public:
                 if (runningInterpreter.load(acquire)) return false;
 
                 if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_wallpaper", "");
+                    settingsStore.setString(Setting::CurrentWallpaper, "");
                     deleteFileOrDirectory(WALLPAPER_PATH);
                     reloadWallpaper();
                     //reloadMenu = reloadMenu2 = true;
@@ -1316,7 +1305,7 @@ public:
                     if (runningInterpreter.load(acquire)) return false;
 
                     if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                        setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_wallpaper", wallpaperName);
+                        settingsStore.setString(Setting::CurrentWallpaper, wallpaperName);
                         //deleteFileOrDirectory(THEME_CONFIG_INI_PATH);
                         copyFileOrDirectory(wallpaperFile, WALLPAPER_PATH);
                         copyPercentage.store(-1, release);
@@ -1351,8 +1340,8 @@ public:
             createToggleListItem(list, EXTENDED_BACKDROP, extendedWidgetBackdrop, "extended_widget_backdrop", true);
 
         } else if (dropdownSelection == "miscMenu") {
-            // Load INI section once instead of 14 separate file reads
-            auto ultrahandSection = getKeyValuePairsFromSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME);
+            // Read the settings section once instead of 14 separate lookups
+            const auto ultrahandSection = settingsStore.section();
             
             // Helper lambda to safely get boolean values
             auto getBoolValue = [&](const std::string& key, bool defaultValue = false) -> bool {
@@ -1960,10 +1949,7 @@ public:
             const std::string currentCombo = getValue(KEY_COMBO_STR);
             
             // Get global default combo
-            auto uhData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-            auto uhIt = uhData.find(ULTRAHAND_PROJECT_NAME);
-            std::string globalDefault = (uhIt != uhData.end() && uhIt->second.count(KEY_COMBO_STR))
-                ? uhIt->second.at(KEY_COMBO_STR) : "";
+            std::string globalDefault = settingsStore.getString(Setting::KeyCombo);
             trim(globalDefault);
             
             // No combo option
@@ -2042,10 +2028,7 @@ public:
             const std::string currentCombo = comboList[idx];
     
             // Get global default
-            auto uhData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-            auto uhIt = uhData.find(ULTRAHAND_PROJECT_NAME);
-            std::string globalDefault = (uhIt != uhData.end() && uhIt->second.count(KEY_COMBO_STR))
-                ? uhIt->second.at(KEY_COMBO_STR) : "";
+            std::string globalDefault = settingsStore.getString(Setting::KeyCombo);
             trim(globalDefault);
     
             // No combo option
@@ -2195,7 +2178,7 @@ public:
                 inMainMenu.store(false, std::memory_order_release);
                 inHiddenMode = true;
                 if (entryMode == OVERLAY_STR)
-                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_HIDDEN_OVERLAY_STR, TRUE_STR);
+                    settingsStore.setBool(Setting::InHiddenOverlay, true);
                 else
                     popCount = 2;
             } else {
@@ -2337,7 +2320,7 @@ public:
                             inMainMenu.store(false, std::memory_order_release);
                             inHiddenMode = true;
                             if (entryMode == OVERLAY_STR)
-                                setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_HIDDEN_OVERLAY_STR, TRUE_STR);
+                                settingsStore.setBool(Setting::InHiddenOverlay, true);
                             else
                                 popCount = 2;
                         } else {
@@ -2848,7 +2831,7 @@ private:
 
     // Variables moved from createUI to class scope
     std::vector<std::string> filesList, filesListOn, filesListOff;
-    std::vector<std::string> filterList, filterListOn, filterListOff;
+    PathHashSet filterSet, filterSetOn, filterSetOff;
     std::string sourceType, sourceTypeOn, sourceTypeOff;
     std::string jsonPath, jsonPathOn, jsonPathOff;
     std::string jsonKey, jsonKeyOn, jsonKeyOff;
@@ -2874,6 +2857,8 @@ private:
 
     bool usingProgress = false;
     bool isMini = false;
+    bool useNaturalSort = false;
+    bool useBatch = false;
 
     size_t maxItemsLimit = 250;     // 0 = uncapped, any other value = max size
     
@@ -2884,6 +2869,420 @@ private:
         vec.shrink_to_fit();
     }
 
+    // Compact row index for the selection list. Entry paths share one arena and rows are
+    // only turned into list items once focus comes near them (see materializeNearFocus).
+    static constexpr size_t ROW_INITIAL_COUNT = 48;
+    static constexpr size_t ROW_BATCH_SIZE = 32;
+    static constexpr size_t ROW_PREFETCH_DISTANCE = 12;
+
+    tsl::elm::List* selectionList = nullptr;
+    std::string rowArena;
+    std::vector<u32> rowOffsets;        // row r spans rowArena[rowOffsets[r], rowOffsets[r + 1])
+    std::vector<u32> rowSourceIndex;    // original entry index, used for {index} and toggle tracking
+    std::vector<bool> rowToggleOn;
+    std::vector<tsl::elm::ListItem*> rowItems; // materialized rows, in row order
+    std::string defaultRowHeader;
+
+    struct SelectionRowText {
+        std::string itemName;
+        std::string footer;
+        std::string groupName;
+        bool faintFooter = false;
+    };
+
+    size_t rowCount() const {
+        return rowSourceIndex.size();
+    }
+
+    std::string rowPath(size_t row) const {
+        return rowArena.substr(rowOffsets[row], rowOffsets[row + 1] - rowOffsets[row]);
+    }
+
+    const std::string& rowHeader(const SelectionRowText& text) const {
+        return (sourceType == FILE_STR && commandGrouping != DEFAULT_STR) ? text.groupName : defaultRowHeader;
+    }
+
+    // Returns one past the first row whose raw name (and footer) matches the jump target, or 0 when none does.
+    // Works on the row arena alone so no row is described, stat'ed or materialized while searching.
+    size_t findJumpRow(const std::string& name, const std::string& value, bool exactMatch) const {
+        const auto matches = [exactMatch](std::string_view candidate, std::string_view target) {
+            return exactMatch ? (candidate == target) : (candidate.find(target) != std::string_view::npos);
+        };
+
+        std::string_view checkedName;
+        if (value == CHECKMARK_SYMBOL) {
+            if (commandMode != OPTION_STR) return 0;
+            const auto it = selectedFooterDict.find(specifiedFooterKey);
+            if (it == selectedFooterDict.end()) return 0;
+            checkedName = it->second;
+        }
+
+        const std::string_view arena(rowArena);
+        for (size_t row = 0; row < rowCount(); ++row) {
+            std::string_view entry = arena.substr(rowOffsets[row], rowOffsets[row + 1] - rowOffsets[row]);
+            std::string_view footer;
+
+            if (sourceType == FILE_STR) {
+                while (!entry.empty() && entry.back() == '/') entry.remove_suffix(1);
+                const size_t slash = entry.rfind('/');
+                if (slash != std::string_view::npos) entry.remove_prefix(slash + 1);
+            }
+            const size_t dash = entry.find(" - ");
+            if (dash != std::string_view::npos) footer = entry.substr(dash + 3);
+
+            // Candidate display names: the raw name, the name before/after " - " and the name without extension
+            std::string_view stem = entry;
+            const size_t dot = stem.rfind('.');
+            if (dot != std::string_view::npos && dot > 0) stem = stem.substr(0, dot);
+            const std::string_view head = (dash != std::string_view::npos) ? entry.substr(0, dash) : entry;
+
+            const std::string_view target = checkedName.empty() ? std::string_view(name) : checkedName;
+            if (!matches(entry, target) && !matches(stem, target) && !matches(head, target) &&
+                !(footer.size() && matches(footer, target)))
+                continue;
+
+            if (!value.empty() && checkedName.empty() && !matches(footer, value))
+                continue;
+
+            return row + 1;
+        }
+        return 0;
+    }
+
+    // Derives the display strings of a row from its path (grouping, footer and translations)
+    void describeRow(size_t row, SelectionRowText& text) const {
+        const std::string selectedItem = rowPath(row);
+        text.itemName = getNameFromPath(selectedItem);
+        text.footer.clear();
+        text.groupName.clear();
+        text.faintFooter = false;
+
+        std::string tmpSelectedItem = selectedItem;
+        preprocessPath(tmpSelectedItem, filePath);
+        if (!isDirectory(tmpSelectedItem))
+            dropExtension(text.itemName);
+
+        size_t pos;
+        if (sourceType == FILE_STR) {
+            if (commandGrouping == "split") {
+                text.groupName = getParentDirNameFromPath(selectedItem);
+                removeQuotes(text.groupName);
+            } else if (commandGrouping == "split2" || commandGrouping == "split3" || commandGrouping == "split5") {
+                text.groupName = (commandGrouping == "split3") ? getNameFromPath(selectedItem) : getParentDirNameFromPath(selectedItem);
+                removeQuotes(text.groupName);
+
+                pos = text.groupName.find(" - ");
+                if (pos != std::string::npos) {
+                    text.itemName = text.groupName.substr(pos + 3);
+                    text.groupName = text.groupName.substr(0, pos);
+                    text.faintFooter = true;
+                }
+            } else if (commandGrouping == "split4") {
+                text.groupName = getParentDirNameFromPath(selectedItem, 2);
+                removeQuotes(text.groupName);
+                text.itemName = getNameFromPath(selectedItem);
+                dropExtension(text.itemName);
+                removeQuotes(text.itemName);
+                trim(text.itemName);
+                text.footer = getParentDirNameFromPath(selectedItem);
+                removeQuotes(text.footer);
+            }
+        }
+
+        if (commandMode == DEFAULT_STR || commandMode == OPTION_STR) {
+            if (sourceType != FILE_STR && commandGrouping != "split2" && commandGrouping != "split3" && commandGrouping != "split4" && commandGrouping != "split5") {
+                pos = selectedItem.find(" - ");
+                text.itemName = selectedItem;
+                text.faintFooter = (pos != std::string::npos);
+                if (text.faintFooter) {
+                    text.footer = selectedItem.substr(pos + 2);
+                    text.itemName = selectedItem.substr(0, pos);
+                }
+            } else if (commandGrouping == "split2") {
+                text.footer = getNameFromPath(selectedItem);
+                dropExtension(text.footer);
+            }
+
+            // for handling footers that use translations / replacements
+            applyLangReplacements(text.footer, true);
+            convertComboToUnicode(text.footer);
+            applyLangReplacements(text.itemName, true);
+            convertComboToUnicode(text.itemName);
+        }
+    }
+
+    // Appends list items for rows up to (but not including) rowLimit
+    void materializeRows(size_t rowLimit) {
+        rowLimit = std::min(rowLimit, rowCount());
+        if (rowItems.size() >= rowLimit) return;
+        rowItems.reserve(rowLimit);
+
+        const bool groupedHeaders = (sourceType == FILE_STR && commandGrouping != DEFAULT_STR);
+        SelectionRowText text;
+
+        for (size_t row = rowItems.size(); row < rowLimit; ++row) {
+            describeRow(row, text);
+
+            if (groupedHeaders && lastGroupingName != text.groupName) {
+                addHeader(selectionList, text.groupName);
+                lastGroupingName = text.groupName;
+            }
+
+            if (commandMode == DEFAULT_STR || commandMode == OPTION_STR) {
+                auto* listItem = new tsl::elm::ListItem(text.itemName, "", isMini);
+
+                if (commandMode == OPTION_STR) {
+                    if (selectedFooterDict[specifiedFooterKey] == text.itemName) {
+                        lastSelectedListItem = listItem;
+                        lastSelectedListItemFooter2 = text.footer;
+                        listItem->setValue(CHECKMARK_SYMBOL);
+                    } else {
+                        listItem->setValue(text.footer, text.faintFooter);
+                    }
+                } else {
+                    listItem->setValue(text.footer, true);
+                }
+
+                listItem->setClickListener([this, row](uint64_t keys) {
+                    return handleRowClick(row, keys);
+                });
+                selectionList->addItem(listItem);
+                rowItems.push_back(listItem);
+
+            } else if (commandMode == TOGGLE_STR) {
+                auto* toggleListItem = new tsl::elm::ToggleListItem(text.itemName, false, ON, OFF, isMini, true);
+                toggleListItem->setState(rowToggleOn[row]);
+
+                toggleListItem->setStateChangedListener([this, row](bool state) {
+                    handleRowToggle(row, state);
+                });
+                // Set the script key listener (for SCRIPT_KEY)
+                toggleListItem->setScriptKeyListener([this, row](bool state) {
+                    handleRowToggleScript(row, state);
+                });
+                selectionList->addItem(toggleListItem);
+                rowItems.push_back(toggleListItem);
+            } else {
+                break;
+            }
+        }
+    }
+
+    // Extends the materialized rows once focus (or touch scrolling) nears the end of them
+    void materializeNearFocus() {
+        if (!selectionList || rowItems.size() >= rowCount()) return;
+
+        bool nearTail = stillTouching.load(acquire);
+        if (!nearTail) {
+            const auto* focusedElement = getFocusedElement();
+            const size_t tailStart = rowItems.size() > ROW_PREFETCH_DISTANCE ? rowItems.size() - ROW_PREFETCH_DISTANCE : 0;
+            for (size_t row = tailStart; row < rowItems.size(); ++row) {
+                if (rowItems[row] == focusedElement) {
+                    nearTail = true;
+                    break;
+                }
+            }
+        }
+
+        if (nearTail)
+            materializeRows(rowItems.size() + ROW_BATCH_SIZE);
+    }
+
+    bool handleRowClick(size_t row, uint64_t keys) {
+        if (runningInterpreter.load(acquire)) {
+            return false;
+        }
+
+        auto* listItem = rowItems[row];
+        const size_t i = rowSourceIndex[row];
+
+        if (((keys & KEY_A) && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
+            
+            isDownloadCommand.store(false, release);
+            runningInterpreter.store(true, release);
+
+            executeInterpreterCommands(getSourceReplacement(selectionCommands, rowPath(row), i, filePath), filePath, specificKey);
+            listItem->disableClickAnimation();
+            //startInterpreterThread(filePath);
+
+            listItem->setValue(INPROGRESS_SYMBOL);
+
+            
+            if (commandMode == OPTION_STR) {
+                SelectionRowText text;
+                describeRow(row, text);
+
+                selectedFooterDict[specifiedFooterKey] = listItem->getText();
+                if (lastSelectedListItem && listItem && lastSelectedListItem != listItem) {
+                
+                    lastSelectedListItem->setValue(lastSelectedListItemFooter2, true);
+                    
+                }
+                lastSelectedListItemFooter2 = text.footer;
+                
+            }
+            
+            lastSelectedListItem = listItem;
+            shiftItemFocus(listItem);
+
+            lastRunningInterpreter.store(true, std::memory_order_release);
+            if (lastSelectedListItem)
+                lastSelectedListItem->triggerClickAnimation();
+            return true;
+        }
+
+        else if (keys & SCRIPT_KEY && !(keys & ~SCRIPT_KEY & ALL_KEYS_MASK)) {
+            //inSelectionMenu = false;
+            SelectionRowText text;
+            describeRow(row, text);
+
+            auto modifiedCmds = getSourceReplacement(selectionCommands, rowPath(row), i, filePath);
+            applyPlaceholderReplacementsToCommands(modifiedCmds, filePath);
+            tsl::changeTo<ScriptOverlay>(std::move(modifiedCmds), filePath, text.itemName, "selection", false, rowHeader(text), showWidget);
+            return true;
+        }
+
+        return false;
+    }
+
+    void handleRowToggle(size_t row, bool state) {
+        if (runningInterpreter.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        auto* toggleListItem = rowItems[row];
+        const size_t i = rowSourceIndex[row];
+        
+        tsl::Overlay::get()->getCurrentGui()->requestFocus(toggleListItem, tsl::FocusDirection::None);
+    
+        if (toggleCount.find(i) == toggleCount.end()) toggleCount[i] = 0;
+        if (isInitialized.find(i) == isInitialized.end() || !isInitialized[i]) {
+            currentSelectedItems[i] = rowPath(row);
+            isInitialized[i] = true;
+            currentPatternIsOriginal[i] = true;  // start in original pattern
+        }
+
+        const auto& activeCommands = !state ? selectionCommandsOn : selectionCommandsOff;
+        const auto& inactiveCommands = !state ? selectionCommandsOff : selectionCommandsOn;
+    
+        // Optimized pattern search with early exit
+        std::string oldPattern, newPattern;
+        for (const auto& cmd : inactiveCommands) {
+            if (cmd.size() > 1 && cmd[0] == "file_source") {
+                oldPattern = cmd[1];
+                break; // Early exit once found
+            }
+        }
+        for (const auto& cmd : activeCommands) {
+            if (cmd.size() > 1 && cmd[0] == "file_source") {
+                newPattern = cmd[1];
+                break; // Early exit once found
+            }
+        }
+
+        preprocessPath(oldPattern,filePath);
+        preprocessPath(newPattern,filePath);
+
+        std::string pathToUse;
+        
+        if (toggleCount[i] % 2 == 0) {
+            // Even toggle: use the original row path (pattern A)
+            pathToUse = rowPath(row);
+            currentPatternIsOriginal[i] = true;
+        } else {
+            // Odd toggle: resolve from previous path
+            if (currentPatternIsOriginal[i]) {
+                // currentSelectedItems[i] corresponds to pattern A, resolve to pattern B
+                pathToUse = resolveWildcardFromKnownPath(oldPattern, currentSelectedItems[i], newPattern);
+                currentPatternIsOriginal[i] = false;
+            } else {
+                // currentSelectedItems[i] corresponds to pattern B, resolve back to pattern A
+                pathToUse = resolveWildcardFromKnownPath(newPattern, currentSelectedItems[i], oldPattern);
+                currentPatternIsOriginal[i] = true;
+            }
+        }
+    
+        auto modifiedCmds = getSourceReplacement(activeCommands, pathToUse, i, filePath);
+    
+        if (sourceType == FILE_STR) {
+            // Optimized search with early exit
+            for (const auto& cmd : modifiedCmds) {
+                if (cmd.size() > 1 && cmd[0] == "sourced_path") {
+                    currentSelectedItems[i] = cmd[1];
+                    break; // Early exit once found
+                }
+            }
+        }
+        
+        if (usingProgress)
+            toggleListItem->setValue(INPROGRESS_SYMBOL);
+
+        nextToggleState = !state ? CAPITAL_OFF_STR : CAPITAL_ON_STR;
+        runningInterpreter.store(true, release);
+        lastRunningInterpreter.store(true, release);
+        lastSelectedListItem = toggleListItem;
+        //interpretAndExecuteCommands(std::move(modifiedCmds), filePath, specificKey);
+        executeInterpreterCommands(std::move(modifiedCmds), filePath, specificKey);
+        //resetPercentages();
+    
+        toggleCount[i]++;
+    }
+
+    void handleRowToggleScript(size_t row, bool state) {
+        const size_t i = rowSourceIndex[row];
+
+        // Initialize currentSelectedItem for this index if it does not exist
+        if (isInitialized.find(i) == isInitialized.end() || !isInitialized[i]) {
+            currentSelectedItems[i] = rowPath(row);
+            isInitialized[i] = true;
+        }
+
+        SelectionRowText text;
+        describeRow(row, text);
+
+        //inSelectionMenu = false;
+        // Custom logic for SCRIPT_KEY handling
+        auto modifiedCmds = getSourceReplacement(state ? selectionCommandsOn : selectionCommandsOff, currentSelectedItems[i], i, filePath);
+        applyPlaceholderReplacementsToCommands(modifiedCmds, filePath);
+        tsl::changeTo<ScriptOverlay>(std::move(modifiedCmds), filePath, text.itemName, "selection", false, rowHeader(text), showWidget);
+    }
+
+    // Adds an item that applies the selection commands to every listed entry in one interpreter run
+    void addBatchItem(const std::string& label) {
+        auto* batchItem = new tsl::elm::ListItem(label, "", isMini);
+        batchItem->setValue(ult::to_string(rowCount()), true);
+
+        batchItem->setClickListener([this, batchItem](uint64_t keys) {
+            if (runningInterpreter.load(acquire)) {
+                return false;
+            }
+
+            if (((keys & KEY_A) && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
+                std::vector<std::string> entries;
+                entries.reserve(rowCount());
+                for (size_t row = 0; row < rowCount(); ++row) {
+                    entries.push_back(rowPath(row));
+                }
+
+                isDownloadCommand.store(false, release);
+                runningInterpreter.store(true, release);
+
+                executeInterpreterBatch(selectionCommands, std::move(entries), std::vector<u32>(rowSourceIndex), filePath, specificKey);
+                batchItem->disableClickAnimation();
+                batchItem->setValue(INPROGRESS_SYMBOL);
+
+                lastSelectedListItem = batchItem;
+                shiftItemFocus(batchItem);
+
+                lastRunningInterpreter.store(true, std::memory_order_release);
+                batchItem->triggerClickAnimation();
+                return true;
+            }
+            return false;
+        });
+        selectionList->addItem(batchItem);
+    }
+
 public:
     SelectionOverlay(const std::string& path, const std::string& key, const std::string& footerKey, const std::string& _lastPackageHeader, const std::vector<std::vector<std::string>>& commands, bool showWidget = false)
         : filePath(path), specificKey(key), specifiedFooterKey(footerKey), lastPackageHeader(_lastPackageHeader), selectionCommands(commands), showWidget(showWidget) {
@@ -2925,6 +3324,8 @@ public:
         static const size_t GROUPING_PATTERN_LEN = GROUPING_PATTERN.length();
         static const size_t SELECTION_MINI_PATTERN_LEN = SELECTION_MINI_PATTERN.length();
         static const size_t PROGRESS_PATTERN_LEN = PROGRESS_PATTERN.length();
+        static const size_t NATURAL_SORT_PATTERN_LEN = NATURAL_SORT_PATTERN.length();
+        static const size_t BATCH_PATTERN_LEN = BATCH_PATTERN.length();
     
         updateGeneralPlaceholders();
         
@@ -2973,6 +3374,12 @@ public:
                 } else if (commandName.size() > PROGRESS_PATTERN_LEN && 
                            commandName.compare(0, PROGRESS_PATTERN_LEN, PROGRESS_PATTERN) == 0) {
                     usingProgress = (commandName.substr(PROGRESS_PATTERN_LEN) == TRUE_STR);
+                } else if (commandName.size() > NATURAL_SORT_PATTERN_LEN && 
+                           commandName.compare(0, NATURAL_SORT_PATTERN_LEN, NATURAL_SORT_PATTERN) == 0) {
+                    useNaturalSort = (commandName.substr(NATURAL_SORT_PATTERN_LEN) == TRUE_STR);
+                } else if (commandName.size() > BATCH_PATTERN_LEN && 
+                           commandName.compare(0, BATCH_PATTERN_LEN, BATCH_PATTERN) == 0) {
+                    useBatch = (commandName.substr(BATCH_PATTERN_LEN) == TRUE_STR);
                 }
     
                 if (commandMode == TOGGLE_STR) {
@@ -3004,30 +3411,22 @@ public:
                             // Get files directly into temporary, avoid intermediate storage
                             tempFiles.clear();
                             tempFiles = getFilesListByWildcards(filterEntry, maxItemsLimit);
-                            if (currentSection == GLOBAL_STR) {
-                                filterList.insert(filterList.end(), 
-                                                std::make_move_iterator(tempFiles.begin()),
-                                                std::make_move_iterator(tempFiles.end()));
-                            } else if (currentSection == ON_STR) {
-                                filterListOn.insert(filterListOn.end(), 
-                                                  std::make_move_iterator(tempFiles.begin()),
-                                                  std::make_move_iterator(tempFiles.end()));
-                            } else if (currentSection == OFF_STR) {
-                                filterListOff.insert(filterListOff.end(), 
-                                                   std::make_move_iterator(tempFiles.begin()),
-                                                   std::make_move_iterator(tempFiles.end()));
+                            PathHashSet* targetSet = (currentSection == ON_STR) ? &filterSetOn :
+                                                     (currentSection == OFF_STR) ? &filterSetOff : &filterSet;
+                            targetSet->reserve(targetSet->size() + tempFiles.size());
+                            for (const auto& filteredPath : tempFiles) {
+                                targetSet->insert(filteredPath);
                             }
-                            //tempFiles.clear(); // automatically cleared since it is moved out of list.
+                            tempFiles = {};
                         } else {
                             if (currentSection == GLOBAL_STR)
-                                filterList.push_back(std::move(filterEntry));
+                                filterSet.insert(filterEntry);
                             else if (currentSection == ON_STR)
-                                filterListOn.push_back(std::move(filterEntry));
+                                filterSetOn.insert(filterEntry);
                             else if (currentSection == OFF_STR)
-                                filterListOff.push_back(std::move(filterEntry));
-                            //filterEntry.shrink_to_fit();
+                                filterSetOff.insert(filterEntry);
                         }
-                        filterEntry.shrink_to_fit();
+                        filterEntry = {};
                     } else if (commandName == "file_source") {
                         sourceType = FILE_STR;
                         if (currentSection == GLOBAL_STR) {
@@ -3283,39 +3682,7 @@ public:
         }
 
         if (sourceType == FILE_STR) {
-            if (commandGrouping == "split2" || commandGrouping == "split4") {
-                std::sort(selectedItemsList.begin(), selectedItemsList.end(), [](const std::string& a, const std::string& b) {
-                    const std::string& parentDirA = getParentDirNameFromPath(a);
-                    const std::string& parentDirB = getParentDirNameFromPath(b);
-                    return (parentDirA != parentDirB) ? (parentDirA < parentDirB) : (getNameFromPath(a) < getNameFromPath(b));
-                });
-            } else if (commandGrouping == "split5") {
-                std::sort(selectedItemsList.begin(), selectedItemsList.end(),
-                    [](const std::string& a, const std::string& b) {
-                        std::string ga = getParentDirNameFromPath(a);
-                        std::string gb = getParentDirNameFromPath(b);
-                        removeQuotes(ga);
-                        removeQuotes(gb);
-            
-                        const size_t posA = ga.find(" - ");
-                        const size_t posB = gb.find(" - ");
-            
-                        if (posA != posB) {
-                            if (posA == std::string::npos) return true;
-                            if (posB == std::string::npos) return false;
-                        }
-            
-                        const int cmp = ga.compare(0, posA, gb, 0, posB);
-                        if (cmp != 0) return cmp < 0;
-            
-                        if (posA == std::string::npos) return false;
-                        return ga.compare(posA + 3, std::string::npos, gb, posB + 3, std::string::npos) < 0;
-                    });
-            } else {
-                std::sort(selectedItemsList.begin(), selectedItemsList.end(), [](const std::string& a, const std::string& b) {
-                    return getNameFromPath(a) < getNameFromPath(b);
-                });
-            }
+            sortSelectionItems(selectedItemsList, commandGrouping, useNaturalSort);
         }
     
         if (commandGrouping == DEFAULT_STR) {
@@ -3323,14 +3690,9 @@ public:
             removeTag(cleanSpecificKey);
             addHeader(list, cleanSpecificKey);
             currentPackageHeader = cleanSpecificKey;
+            defaultRowHeader = cleanSpecificKey;
         }
     
-        //tsl::elm::ListItem* listItem;
-        size_t pos;
-        std::string parentDirName;
-        std::string footer;
-        std::string optionName;
-    
         if (selectedItemsList.empty()) {
             if (commandGrouping != DEFAULT_STR) {
                 std::string cleanSpecificKey = specificKey.substr(1);
@@ -3352,393 +3714,91 @@ public:
             noClickableItems = true;
         }
     
-        std::string tmpSelectedItem;
+        // Hashed lookup for initial toggle states (avoids a linear scan per item)
+        PathHashSet selectedItemsSetOn;
+        if (commandMode == TOGGLE_STR) {
+            selectedItemsSetOn.reserve(selectedItemsListOn.size());
+            for (const auto& item : selectedItemsListOn) {
+                selectedItemsSetOn.insert(item);
+            }
+        }
+
         const size_t selectedItemsSize = selectedItemsList.size(); // Cache size to avoid repeated calls
         
-        
-        // Pre-process filtered items for reduced memory imprint
+        size_t arenaSize = 0;
+        for (const auto& item : selectedItemsList) {
+            arenaSize += item.size();
+        }
+        rowArena.reserve(arenaSize);
+        rowOffsets.reserve(selectedItemsSize + 1);
+        rowSourceIndex.reserve(selectedItemsSize);
+        rowOffsets.push_back(0);
+
+        // Filter items and pack the survivors into the compact row index
         for (size_t i = 0; i < selectedItemsSize; ++i) {
             std::string& selectedItem = selectedItemsList[i];
             
-            //if (isFileOrDirectory(selectedItem)) {
             const std::string itemName = getNameFromPath(selectedItem);
-            if (itemName.front() == '.') { // Skip hidden items
+            if (itemName.empty() || itemName.front() == '.') { // Skip empty lines and hidden items
                 selectedItem = "";
                 continue;
             }
-            //}
 
             if (commandMode == TOGGLE_STR) {
-                auto it = std::find(filterListOn.begin(), filterListOn.end(), selectedItem);
-                if (it != filterListOn.end()) {
-                    filterListOn.erase(it);
-                    selectedItem = "";
-                    continue;
-                }
-                it = std::find(filterListOff.begin(), filterListOff.end(), selectedItem);
-                if (it != filterListOff.end()) {
-                    filterListOff.erase(it);
-                    selectedItem = "";
-                    continue;
-                }
-            } else {
-                auto it = std::find(filterList.begin(), filterList.end(), selectedItem);
-                if (it != filterList.end()) {
-                    filterList.erase(it);
+                if (filterSetOn.contains(selectedItem) || filterSetOff.contains(selectedItem)) {
                     selectedItem = "";
                     continue;
                 }
+                rowToggleOn.push_back(selectedItemsSetOn.contains(selectedItem));
+            } else if (filterSet.contains(selectedItem)) {
+                selectedItem = "";
+                continue;
             }
+
+            rowArena += selectedItem;
+            rowOffsets.push_back(static_cast<u32>(rowArena.size()));
+            rowSourceIndex.push_back(static_cast<u32>(i));
+            selectedItem = "";
         }
 
-        filterList = {};
-        filterListOn = {};
-        filterListOff = {};
+        filterSet.clear();
+        filterSetOn.clear();
+        filterSetOff.clear();
 
-        //filterList.clear();
-        //filterList.shrink_to_fit();
-        //filterListOn.clear();
-        //filterListOn.shrink_to_fit();
-        //filterListOff.clear();
-        //filterListOff.shrink_to_fit();
+        // for handling footers that use translations / replacements
+        if (commandMode == OPTION_STR) {
+            applyLangReplacements(specifiedFooterKey, true);
+            convertComboToUnicode(specifiedFooterKey);
+            applyLangReplacements(selectedFooterDict[specifiedFooterKey], true);
+            convertComboToUnicode(selectedFooterDict[specifiedFooterKey]);
+        }
 
-        std::string itemName;
-        for (size_t i = 0; i < selectedItemsSize; ++i) {
-            std::string& selectedItem = selectedItemsList[i];
-            
+        // Only the first screens worth of rows are built now; handleInput adds the rest as focus approaches
+        selectionList = list;
+        if (useBatch && commandMode == DEFAULT_STR && rowCount() > 1) {
+            std::string cleanSpecificKey = specificKey.substr(1);
+            removeTag(cleanSpecificKey);
+            addBatchItem(cleanSpecificKey);
+        }
+        materializeRows(ROW_INITIAL_COUNT);
 
-            itemName = getNameFromPath(selectedItem);
-            if (itemName.empty()) // Skip empty lines
-                continue;
-    
-            tmpSelectedItem = selectedItem;
-            preprocessPath(tmpSelectedItem, filePath);
-            if (!isDirectory(tmpSelectedItem))
-                dropExtension(itemName);
-    
-            if (sourceType == FILE_STR) {
-                if (commandGrouping == "split") {
-                    groupingName = getParentDirNameFromPath(selectedItem);
-                    removeQuotes(groupingName);
-    
-                    if (lastGroupingName != groupingName) { // Simplified comparison
-                        addHeader(list, groupingName);
-                        currentPackageHeader = groupingName;
-                        lastGroupingName = groupingName;
-                    }
-                } else if (commandGrouping == "split2") {
-                    groupingName = getParentDirNameFromPath(selectedItem);
-                    removeQuotes(groupingName);
-    
-                    pos = groupingName.find(" - ");
-                    if (pos != std::string::npos) {
-                        itemName = groupingName.substr(pos + 3);
-                        groupingName = groupingName.substr(0, pos);
-                    }
-    
-                    if (lastGroupingName != groupingName) { // Simplified comparison
-                        addHeader(list, groupingName);
-                        currentPackageHeader = groupingName;
-                        lastGroupingName = groupingName;
-                    }
-                } else if (commandGrouping == "split3") {
-                    groupingName = getNameFromPath(selectedItem);
-                    removeQuotes(groupingName);
-    
-                    pos = groupingName.find(" - ");
-                    if (pos != std::string::npos) {
-                        itemName = groupingName.substr(pos + 3);
-                        groupingName = groupingName.substr(0, pos);
-                    }
-    
-                    if (lastGroupingName != groupingName) { // Simplified comparison
-                        addHeader(list, groupingName);
-                        currentPackageHeader = groupingName;
-                        lastGroupingName = groupingName;
-                    }
-                } else if (commandGrouping == "split4") {
-                    groupingName = getParentDirNameFromPath(selectedItem, 2);
-                    removeQuotes(groupingName);
-                    itemName = getNameFromPath(selectedItem);
-                    dropExtension(itemName);
-                    removeQuotes(itemName);
-                    trim(itemName);
-                    footer = getParentDirNameFromPath(selectedItem);
-                    removeQuotes(footer);
-    
-                    if (lastGroupingName != groupingName) { // Simplified comparison
-                        addHeader(list, groupingName);
-                        currentPackageHeader = groupingName;
-                        lastGroupingName = groupingName;
-                    }
-                } else if (commandGrouping == "split5") {
-                    groupingName = getParentDirNameFromPath(selectedItem);
-                    removeQuotes(groupingName);
-    
-                    pos = groupingName.find(" - ");
-                    if (pos != std::string::npos) {
-                        itemName = groupingName.substr(pos + 3);
-                        groupingName = groupingName.substr(0, pos);
-                    }
-    
-                    if (lastGroupingName != groupingName) { // Simplified comparison
-                        addHeader(list, groupingName);
-                        currentPackageHeader = groupingName;
-                        lastGroupingName = groupingName;
-                    }
-                }
-            //} else {
-            //    if (commandMode == TOGGLE_STR) {
-            //        auto it = std::find(filterListOn.begin(), filterListOn.end(), itemName);
-            //        if (it != filterListOn.end()) {
-            //            filterListOn.erase(it);
-            //            selectedItem.clear();
-            //            continue;
-            //        }
-            //        it = std::find(filterListOff.begin(), filterListOff.end(), itemName);
-            //        if (it != filterListOff.end()) {
-            //            filterListOff.erase(it);
-            //            selectedItem.clear();
-            //            continue;
-            //        }
-            //    } else {
-            //        auto it = std::find(filterList.begin(), filterList.end(), itemName);
-            //        if (it != filterList.end()) {
-            //            filterList.erase(it);
-            //            selectedItem.clear();
-            //            continue;
-            //        }
-            //    }
-            }
-    
-            if (commandMode == DEFAULT_STR || commandMode == OPTION_STR) {
-                if (sourceType != FILE_STR && commandGrouping != "split2" && commandGrouping != "split3" && commandGrouping != "split4" && commandGrouping != "split5") {
-                    pos = selectedItem.find(" - ");
-                    footer = "";
-                    itemName = selectedItem;
-                    if (pos != std::string::npos) {
-                        footer = selectedItem.substr(pos + 2);
-                        itemName = selectedItem.substr(0, pos);
-                    }
-                } else if (commandGrouping == "split2") {
-                    footer = getNameFromPath(selectedItem);
-                    dropExtension(footer);
-                }
-    
-                tsl::elm::ListItem* listItem = new tsl::elm::ListItem(itemName, "", isMini);
-    
-                // for handling footers that use translations / replacements
-                applyLangReplacements(footer, true);
-                convertComboToUnicode(footer);
-                applyLangReplacements(specifiedFooterKey, true);
-                convertComboToUnicode(specifiedFooterKey);
-    
-                applyLangReplacements(itemName, true);
-                convertComboToUnicode(itemName);
-                applyLangReplacements(selectedFooterDict[specifiedFooterKey], true);
-                convertComboToUnicode(selectedFooterDict[specifiedFooterKey]);
-    
-                if (commandMode == OPTION_STR) {
-                    if (selectedFooterDict[specifiedFooterKey] == itemName) {
-                        lastSelectedListItem = listItem;
-                        lastSelectedListItemFooter2 = footer;
-                        listItem->setValue(CHECKMARK_SYMBOL);
-                    } else {
-                        if (pos != std::string::npos) {
-                            listItem->setValue(footer, true);
-                        } else {
-                            listItem->setValue(footer);
-                        }
-                    }
-                } else {
-                    listItem->setValue(footer, true);
-                }
-    
-                listItem->setClickListener([this, i, selectedItem, footer, listItem, currentPackageHeader, itemName](uint64_t keys) {
-    
-                    if (runningInterpreter.load(acquire)) {
-                        return false;
-                    }
-    
-                    if (((keys & KEY_A) && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                        
-                        isDownloadCommand.store(false, release);
-                        runningInterpreter.store(true, release);
-    
-                        executeInterpreterCommands(getSourceReplacement(selectionCommands, selectedItem, i, filePath), filePath, specificKey);
-                        listItem->disableClickAnimation();
-                        //startInterpreterThread(filePath);
-    
-                        listItem->setValue(INPROGRESS_SYMBOL);
-    
-                        
-                        if (commandMode == OPTION_STR) {
-                            selectedFooterDict[specifiedFooterKey] = listItem->getText();
-                            if (lastSelectedListItem && listItem && lastSelectedListItem != listItem) {
-                            
-                                lastSelectedListItem->setValue(lastSelectedListItemFooter2, true);
-                                
-                            }
-                            lastSelectedListItemFooter2 = footer;
-                            
-                        }
-                        
-                        lastSelectedListItem = listItem;
-                        shiftItemFocus(listItem);
-    
-                        lastRunningInterpreter.store(true, std::memory_order_release);
-                        if (lastSelectedListItem)
-                            lastSelectedListItem->triggerClickAnimation();
-                        return true;
-                    }
-    
-                    else if (keys & SCRIPT_KEY && !(keys & ~SCRIPT_KEY & ALL_KEYS_MASK)) {
-                        //inSelectionMenu = false;
-    
-                        auto modifiedCmds = getSourceReplacement(selectionCommands, selectedItem, i, filePath);
-                        applyPlaceholderReplacementsToCommands(modifiedCmds, filePath);
-                        tsl::changeTo<ScriptOverlay>(std::move(modifiedCmds), filePath, itemName, "selection", false, currentPackageHeader, showWidget);
-                        return true;
-                    }
-    
-                    return false;
-                });
-                list->addItem(listItem);
-    
-            } else if (commandMode == TOGGLE_STR) {
-                auto* toggleListItem = new tsl::elm::ToggleListItem(itemName, false, ON, OFF, isMini, true);
-    
-                // Use const iterators for better performance
-                const bool toggleStateOn = std::find(selectedItemsListOn.cbegin(), selectedItemsListOn.cend(), selectedItem) != selectedItemsListOn.cend();
-                toggleListItem->setState(toggleStateOn);
-    
-                toggleListItem->setStateChangedListener([this, i, toggleListItem, selectedItem, itemName](bool state) {
-                    if (runningInterpreter.load(std::memory_order_acquire)) {
-                        return;
-                    }
-
-                    
-                    tsl::Overlay::get()->getCurrentGui()->requestFocus(toggleListItem, tsl::FocusDirection::None);
-                
-                    if (toggleCount.find(i) == toggleCount.end()) toggleCount[i] = 0;
-                    if (isInitialized.find(i) == isInitialized.end() || !isInitialized[i]) {
-                        currentSelectedItems[i] = selectedItem;
-                        isInitialized[i] = true;
-                        currentPatternIsOriginal[i] = true;  // start in original pattern
-                    }
-    
-                    const auto& activeCommands = !state ? selectionCommandsOn : selectionCommandsOff;
-                    const auto& inactiveCommands = !state ? selectionCommandsOff : selectionCommandsOn;
-                
-                    // Optimized pattern search with early exit
-                    std::string oldPattern, newPattern;
-                    for (const auto& cmd : inactiveCommands) {
-                        if (cmd.size() > 1 && cmd[0] == "file_source") {
-                            oldPattern = cmd[1];
-                            break; // Early exit once found
-                        }
-                    }
-                    for (const auto& cmd : activeCommands) {
-                        if (cmd.size() > 1 && cmd[0] == "file_source") {
-                            newPattern = cmd[1];
-                            break; // Early exit once found
-                        }
-                    }
-    
-                    preprocessPath(oldPattern,filePath);
-                    preprocessPath(newPattern,filePath);
-    
-                    std::string pathToUse;
-                    
-                    if (toggleCount[i] % 2 == 0) {
-                        // Even toggle: use original selectedItemsList[i] (pattern A)
-                        pathToUse = selectedItem;
-                        currentPatternIsOriginal[i] = true;
-                    } else {
-                        // Odd toggle: resolve from previous path
-                        if (currentPatternIsOriginal[i]) {
-                            // currentSelectedItems[i] corresponds to pattern A, resolve to pattern B
-                            pathToUse = resolveWildcardFromKnownPath(oldPattern, currentSelectedItems[i], newPattern);
-                            currentPatternIsOriginal[i] = false;
-                        } else {
-                            // currentSelectedItems[i] corresponds to pattern B, resolve back to pattern A
-                            pathToUse = resolveWildcardFromKnownPath(newPattern, currentSelectedItems[i], oldPattern);
-                            currentPatternIsOriginal[i] = true;
-                        }
-                    }
-                
-                    auto modifiedCmds = getSourceReplacement(activeCommands, pathToUse, i, filePath);
-                
-                    if (sourceType == FILE_STR) {
-                        // Optimized search with early exit
-                        for (const auto& cmd : modifiedCmds) {
-                            if (cmd.size() > 1 && cmd[0] == "sourced_path") {
-                                currentSelectedItems[i] = cmd[1];
-                                break; // Early exit once found
-                            }
-                        }
-                    }
-                    
-                    if (usingProgress)
-                        toggleListItem->setValue(INPROGRESS_SYMBOL);
-
-                    nextToggleState = !state ? CAPITAL_OFF_STR : CAPITAL_ON_STR;
-                    runningInterpreter.store(true, release);
-                    lastRunningInterpreter.store(true, release);
-                    lastSelectedListItem = toggleListItem;
-                    //interpretAndExecuteCommands(std::move(modifiedCmds), filePath, specificKey);
-                    executeInterpreterCommands(std::move(modifiedCmds), filePath, specificKey);
-                    //resetPercentages();
-                
-                    toggleCount[i]++;
-                });
-                                
-                // Set the script key listener (for SCRIPT_KEY)
-                toggleListItem->setScriptKeyListener([this, i, currentPackageHeader, itemName, selectedItem](bool state) {
-                    // Initialize currentSelectedItem for this index if it does not exist
-                    if (isInitialized.find(i) == isInitialized.end() || !isInitialized[i]) {
-                        currentSelectedItems[i] = selectedItem;
-                        isInitialized[i] = true;
-                    }
-    
-                    //inSelectionMenu = false;
-                    // Custom logic for SCRIPT_KEY handling
-                    auto modifiedCmds = getSourceReplacement(state ? selectionCommandsOn : selectionCommandsOff, currentSelectedItems[i], i, filePath);
-                    applyPlaceholderReplacementsToCommands(modifiedCmds, filePath);
-                    tsl::changeTo<ScriptOverlay>(std::move(modifiedCmds), filePath, itemName, "selection", false, currentPackageHeader, showWidget);
-                });
-    
-                list->addItem(toggleListItem);
-            }
-            selectedItem = "";
-            //selectedItem.clear();
-            //selectedItem.shrink_to_fit();
-        }
-
-        // clear everything
-        selectedItemsList = {};
-        selectedItemsListOn = {};
-        selectedItemsListOff = {};
-
-        //selectedItemsList.clear();
-        //selectedItemsList.shrink_to_fit();
-        //selectedItemsListOn.clear();
-        //selectedItemsListOn.shrink_to_fit();
-        //selectedItemsListOff.clear();
-        //selectedItemsListOff.shrink_to_fit();
-        
-        if (!packageRootLayerTitle.empty())
-            overrideTitle = true;
-        if (!packageRootLayerVersion.empty())
-            overrideVersion = true;
-        
-        PackageHeader packageHeader = getPackageHeaderFromIni(filePath + PACKAGE_FILENAME);
-        if (!packageHeader.title.empty() && packageRootLayerTitle.empty())
-            packageRootLayerTitle = packageHeader.title;
-        if (!packageHeader.version.empty() && packageRootLayerVersion.empty())
-            packageRootLayerVersion = packageHeader.version;
-        if (!packageHeader.color.empty() && packageRootLayerColor.empty())
-            packageRootLayerColor = packageHeader.color;
+        // clear everything
+        selectedItemsList = {};
+        selectedItemsListOn = {};
+        selectedItemsListOff = {};
+        
+        if (!packageRootLayerTitle.empty())
+            overrideTitle = true;
+        if (!packageRootLayerVersion.empty())
+            overrideVersion = true;
+        
+        PackageHeader packageHeader = getPackageHeaderFromIni(filePath + PACKAGE_FILENAME);
+        if (!packageHeader.title.empty() && packageRootLayerTitle.empty())
+            packageRootLayerTitle = packageHeader.title;
+        if (!packageHeader.version.empty() && packageRootLayerVersion.empty())
+            packageRootLayerVersion = packageHeader.version;
+        if (!packageHeader.color.empty() && packageRootLayerColor.empty())
+            packageRootLayerColor = packageHeader.color;
     
         if (packageHeader.title.empty() || overrideTitle)
             packageHeader.title = packageRootLayerTitle;
@@ -3760,6 +3820,10 @@ public:
                packageHeader.color);
         }
     
+        // Build rows up to the jump target so the list can find it
+        if (!jumpItemName.empty()) {
+            materializeRows(findJumpRow(jumpItemName, jumpItemValue, jumpItemExactMatch.load(acquire)));
+        }
         list->jumpToItem(jumpItemName, jumpItemValue, jumpItemExactMatch.load(acquire));
         
         list->disableCaching();
@@ -3829,6 +3893,8 @@ public:
             return true;
         }
         
+        materializeNearFocus();
+        
         // Cache touching state for refresh operations (used in same logical block)
         const bool isTouching = stillTouching.load(acquire);
         
@@ -4100,6 +4166,7 @@ bool drawCommandsMenu(
     bool usingProgress;
 
     bool isPolling;
+    size_t pollingInterval;
     bool isScrollableTable;
     bool usingTopPivot, usingBottomPivot;
     bool onlyTables = true;
@@ -4117,7 +4184,7 @@ bool drawCommandsMenu(
     // update general placeholders
     updateGeneralPlaceholders();
 
-    std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> options = loadOptionsFromIni(packageIniPath);
+    std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> options = packagePrefetchCache.loadOptions(packageIniPath);
     for (size_t i = 0; i < options.size(); ++i) {
         optionName.clear();
         commands.clear();
@@ -4147,6 +4214,7 @@ bool drawCommandsMenu(
 
         // Table settings
         isPolling = false;
+        pollingInterval = 1000;
         isScrollableTable = true;
         usingTopPivot = false;
         usingBottomPivot = false;
@@ -4564,6 +4632,9 @@ bool drawCommandsMenu(
                     } else if (commandName.find(POLLING_PATTERN) == 0) {
                         isPolling = (commandName.substr(POLLING_PATTERN.length()) == TRUE_STR);
                         continue;
+                    } else if (commandName.find(POLLING_INTERVAL_PATTERN) == 0) {
+                        pollingInterval = static_cast<size_t>(std::max(0, ult::stoi(commandName.substr(POLLING_INTERVAL_PATTERN.length()))));
+                        continue;
                     } else if (commandName.find(SCROLLABLE_PATTERN) == 0) {
                         isScrollableTable = (commandName.substr(SCROLLABLE_PATTERN.length()) != FALSE_STR);
                         continue;
@@ -4752,7 +4823,7 @@ bool drawCommandsMenu(
 
 
                     addTable(list, tableData, packagePath, tableColumnOffset, tableStartGap, tableEndGap, tableSpacing,
-                        tableSectionTextColor, tableInfoTextColor, tableInfoTextColor, tableAlignment, hideTableBackground, useHeaderIndent, isPolling, isScrollableTable, tableWrappingMode, useWrappingIndent);
+                        tableSectionTextColor, tableInfoTextColor, tableInfoTextColor, tableAlignment, hideTableBackground, useHeaderIndent, isPolling, isScrollableTable, tableWrappingMode, useWrappingIndent, pollingInterval);
                     tableData.clear();
 
                     if (usingBottomPivot) {
@@ -5564,7 +5635,7 @@ public:
         packageIniPath = packagePath + packageName;
         packageConfigIniPath = packagePath + CONFIG_FILENAME;
 
-        PackageHeader packageHeader = getPackageHeaderFromIni(packageIniPath);
+        PackageHeader packageHeader = packagePrefetchCache.loadHeader(packageIniPath);
         
         const bool showWidget = (!packageHeader.show_widget.empty() && packageHeader.show_widget == TRUE_STR);
         
@@ -5614,6 +5685,7 @@ public:
         rootFrame->setContent(list);
         if (showWidget)
             rootFrame->m_showWidget = true;
+        bootProfiler.mark("package menu");
         return rootFrame;
     }
     
@@ -5648,6 +5720,7 @@ public:
      * @return `true` if the input was handled within the overlay, `false` otherwise.
      */
     virtual bool handleInput(uint64_t keysDown, uint64_t keysHeld, touchPosition touchInput, JoystickPosition leftJoyStick, JoystickPosition rightJoyStick) override {
+        bootProfiler.finish();
     
         const bool isRunningInterp = runningInterpreter.load(acquire);
         const bool isTouching = stillTouching.load(acquire);
@@ -5912,7 +5985,7 @@ public:
         auto handleMainMenuReturn = [&]() {
             if (returningToMain || returningToHiddenMain) {
                 if (returningToHiddenMain) {
-                    setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_HIDDEN_PACKAGE_STR, TRUE_STR);
+                    settingsStore.setBool(Setting::InHiddenPackage, true);
                 }
                 {
                     //std::lock_guard<std::mutex> lock(jumpItemMutex);
@@ -6126,6 +6199,22 @@ private:
     //bool initializingSpawn = false;
     //std::string defaultLang = "en";
 
+    // Overlay/package entries are scanned off the UI thread and added to the list in update()
+    static constexpr size_t LIST_POPULATION_BATCH = 16;
+    MenuScan menuScan;
+    BackgroundJob menuScanJob;
+    tsl::elm::List* populatingList = nullptr;
+    size_t nextScanEntry = 0;
+    s32 listInsertIndex = 0;
+    bool populationInterrupted = false; // the user gave input while batches were still being added
+
+    // Package list items and their package.ini, for prefetching the one focus rests on
+    static constexpr u64 PREFETCH_DWELL_NS = 350'000'000ULL;
+    std::unordered_map<const tsl::elm::Element*, std::string> prefetchTargets;
+    const tsl::elm::Element* prefetchFocus = nullptr;
+    u64 prefetchFocusTick = 0;
+    bool prefetchIssued = false;
+
 
 public:
     /**
@@ -6154,6 +6243,7 @@ public:
      */
     ~MainMenu() {
         std::lock_guard<std::mutex> lock(transitionMutex);
+        menuScanJob.join();
     }
     
     /**
@@ -6168,34 +6258,18 @@ public:
         std::lock_guard<std::mutex> lock(transitionMutex);
     
         // Handle hidden mode flags
-        {
-            auto iniData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-            auto& ultrahandSection = iniData[ULTRAHAND_PROJECT_NAME];
-            bool needsUpdate = false;
-            
-            auto overlayIt = ultrahandSection.find(IN_HIDDEN_OVERLAY_STR);
-            if (overlayIt != ultrahandSection.end() && overlayIt->second == TRUE_STR) {
-                inMainMenu.store(false, std::memory_order_release);
-                inHiddenMode = true;
-                hiddenMenuMode = OVERLAYS_STR;
-                skipJumpReset.store(true, release);
-                ultrahandSection[IN_HIDDEN_OVERLAY_STR] = FALSE_STR;
-                needsUpdate = true;
-            } else {
-                auto packageIt = ultrahandSection.find(IN_HIDDEN_PACKAGE_STR);
-                if (packageIt != ultrahandSection.end() && packageIt->second == TRUE_STR) {
-                    inMainMenu.store(false, std::memory_order_release);
-                    inHiddenMode = true;
-                    hiddenMenuMode = PACKAGES_STR;
-                    skipJumpReset.store(true, release);
-                    ultrahandSection[IN_HIDDEN_PACKAGE_STR] = FALSE_STR;
-                    needsUpdate = true;
-                }
-            }
-            
-            if (needsUpdate) {
-                saveIniFileData(ULTRAHAND_CONFIG_INI_PATH, iniData);
-            }
+        if (settingsStore.getBool(Setting::InHiddenOverlay)) {
+            inMainMenu.store(false, std::memory_order_release);
+            inHiddenMode = true;
+            hiddenMenuMode = OVERLAYS_STR;
+            skipJumpReset.store(true, release);
+            settingsStore.setBool(Setting::InHiddenOverlay, false);
+        } else if (settingsStore.getBool(Setting::InHiddenPackage)) {
+            inMainMenu.store(false, std::memory_order_release);
+            inHiddenMode = true;
+            hiddenMenuMode = PACKAGES_STR;
+            skipJumpReset.store(true, release);
+            settingsStore.setBool(Setting::InHiddenPackage, false);
         }
     
         if (!inHiddenMode && dropdownSection.empty())
@@ -6214,7 +6288,7 @@ public:
         }
         
         if (toPackages) {
-            setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "to_packages", FALSE_STR);
+            settingsStore.setBool(Setting::ToPackages, false);
             toPackages = false;
             currentMenu = PACKAGES_STR;
         }
@@ -6232,7 +6306,9 @@ public:
     
         auto* rootFrame = new tsl::elm::OverlayFrame(CAPITAL_ULTRAHAND_PROJECT_NAME, versionLabel, noClickableItems, menuMode+hiddenMenuMode+dropdownSection, "", "", "");
         
-        list->jumpToItem(jumpItemName, jumpItemValue, jumpItemExactMatch.load(acquire));
+        // While entries are still being scanned the jump is applied once the last batch is added
+        if (!populatingList)
+            list->jumpToItem(jumpItemName, jumpItemValue, jumpItemExactMatch.load(acquire));
         //if (g_overlayFilename != "ovlmenu.ovl") {
         //    list->jumpToItem(jumpItemName, jumpItemValue, jumpItemExactMatch.load(acquire));
         //} else {
@@ -6241,16 +6317,112 @@ public:
 
         
         rootFrame->setContent(list);
+        bootProfiler.mark("main menu");
         return rootFrame;
     }
     
         
+    /**
+     * @brief Adds the scanned overlay/package entries to the list in batches.
+     *
+     * Waits for the menu scan thread, then appends LIST_POPULATION_BATCH items per frame at
+     * listInsertIndex, followed by the empty-selection drawer or hidden tab, and finally
+     * applies the pending jumpToItem. Once the user gives input, the remaining entries are
+     * added at once and the jump is dropped so the list stops shifting under them.
+     */
+    virtual void update() override {
+        bootProfiler.finish();
+
+        if (populatingList)
+            populateListBatch();
+        else if (!prefetchTargets.empty())
+            prefetchFocusedPackage();
+    }
+
+    void populateListBatch() {
+        if (!menuScanJob.finished())
+            return;
+        menuScanJob.join();
+
+        const bool overlaysMode = (menuMode == OVERLAYS_STR);
+        const auto& entries = menuScan.entries;
+
+        if (nextScanEntry == 0 && !overlaysMode && !entries.empty()) {
+            populatingList->addItem(new tsl::elm::CategoryHeader((!inHiddenMode ? PACKAGES : HIDDEN_PACKAGES)+" "+DIVIDER_SYMBOL+" \uE0E3 "+SETTINGS+" "+DIVIDER_SYMBOL+" \uE0E2 "+FAVORITE), 0, listInsertIndex++);
+        }
+
+        const size_t batchEnd = populationInterrupted ? entries.size() : std::min(nextScanEntry + LIST_POPULATION_BATCH, entries.size());
+        while (nextScanEntry < batchEnd) {
+            const MenuEntry& entry = entries[nextScanEntry++];
+            if (overlaysMode)
+                addOverlayListItem(entry);
+            else
+                addPackageListItem(entry);
+        }
+        if (nextScanEntry < entries.size())
+            return;
+
+        if (menuScan.hasSources) {
+            if (overlaysMode && entries.empty())
+                addSelectionIsEmptyDrawer(populatingList);
+            if (menuScan.drawHiddenTab && !inHiddenMode && !hideHidden) {
+                if (overlaysMode)
+                    addOverlaysHiddenTab();
+                else
+                    addPackagesHiddenTab();
+            }
+        }
+
+        if (!populationInterrupted)
+            populatingList->jumpToItem(jumpItemName, jumpItemValue, jumpItemExactMatch.load(acquire));
+        populatingList = nullptr;
+        populationInterrupted = false;
+        menuScan.clear();
+    }
+
+    // Starts a speculative parse of the highlighted package once focus has rested on it
+    void prefetchFocusedPackage() {
+        const tsl::elm::Element* focusedElement = getFocusedElement();
+        const u64 currentTick = armGetSystemTick();
+        if (focusedElement != prefetchFocus) {
+            prefetchFocus = focusedElement;
+            prefetchFocusTick = currentTick;
+            prefetchIssued = false;
+            return;
+        }
+        if (prefetchIssued || runningInterpreter.load(acquire) ||
+            armTicksToNs(currentTick - prefetchFocusTick) < PREFETCH_DWELL_NS)
+            return;
+
+        prefetchIssued = true;
+        auto it = prefetchTargets.find(focusedElement);
+        if (it != prefetchTargets.end())
+            packagePrefetchCache.request(it->second);
+    }
+
+    void startListPopulation(tsl::elm::List* list, s32 insertIndex, void (MainMenu::*scan)()) {
+        populatingList = list;
+        listInsertIndex = insertIndex;
+        nextScanEntry = 0;
+        populationInterrupted = false;
+        menuScan.clear();
+        menuScanJob.start([this, scan]() { (this->*scan)(); });
+    }
+
     void createOverlaysMenu(tsl::elm::List* list) {
         inOverlaysPage.store(true, std::memory_order_release);
         inPackagesPage.store(false, std::memory_order_release);
     
         addHeader(list, (!inHiddenMode ? OVERLAYS : HIDDEN_OVERLAYS)+" "+DIVIDER_SYMBOL+" \uE0E3 "+SETTINGS+" "+DIVIDER_SYMBOL+" \uE0E2 "+FAVORITE);
-        
+        startListPopulation(list, 1, &MainMenu::scanOverlays);
+    }
+
+    /**
+     * @brief Collects and sorts the overlay entries into menuScan.
+     *
+     * Runs on the menu scan thread; only touches the filesystem, overlays.ini and menuScan.
+     */
+    void scanOverlays() {
         std::vector<std::string> overlayFiles = getFilesListByWildcards(OVERLAY_PATH+"*.ovl");
         
         #if !USING_FSTREAM_DIRECTIVE
@@ -6266,9 +6438,8 @@ public:
         #endif
     
         if (overlayFiles.empty()) return;
+        menuScan.hasSources = true;
     
-        std::set<std::string> overlaySet;
-        bool drawHiddenTab = false;
 
         std::string base_lang{"en"};
         tsl::hlp::doWithSmSession([&base_lang] {
@@ -6336,6 +6507,8 @@ public:
             auto overlaysIniData = getParsedDataFromIniFile(OVERLAYS_INI_FILEPATH);
             bool overlaysNeedsUpdate = false;
             bool foundOvlmenu = false;
+            OverlayInfoCache overlayInfoCache;
+            overlayInfoCache.load();
     
             // Filter in one pass, remove ovlmenu and dot files
             overlayFiles.erase(
@@ -6351,16 +6524,17 @@ public:
                 overlayFiles.end()
             );
     
-            // Pre-allocate string buffers to avoid repeated allocations
-            std::string overlayFileName, overlayEntryKey;
+            // Pre-allocate so entries and their text are appended without regrowth
+            std::string overlayFileName;
             overlayFileName.reserve(64);
-            overlayEntryKey.reserve(256);
+            menuScan.entries.reserve(overlayFiles.size());
+            menuScan.arena.buffer.reserve(overlayFiles.size() * 96);
     
             for (auto& overlayFile : overlayFiles) {
                 overlayFileName = getNameFromPath(overlayFile);
                 overlayFile.clear(); // Free memory immediately
 
-                auto [result, overlayName, overlayVersion, usingLibUltrahand, supportsAMS110] = getOverlayInfo(OVERLAY_PATH + overlayFileName);
+                auto [result, overlayName, overlayVersion, usingLibUltrahand, supportsAMS110] = overlayInfoCache.get(OVERLAY_PATH, overlayFileName);
                 if (result != ResultSuccess) continue;
                 std::string pluginLangPath = std::string("sdmc:/switch/.overlays/lang/") + overlayName + "/" + base_lang + ".json";
                 if (isFileOrDirectory(pluginLangPath)) {
@@ -6382,30 +6556,26 @@ public:
                     overlaySection["custom_version"] = "";
                     overlaysNeedsUpdate = true;
     
-                    // Build entry key with single allocation
-                    //overlayEntryKey.clear();
-                    //overlayEntryKey.reserve(4 + overlayName.size() + 1 + overlayName.size() + 1 + 
-                    //                       overlayVersion.size() + 1 + overlayFileName.size() + 8);
-
-                    overlayEntryKey = "0020" + overlayName + ':' + overlayName + ':' + 
-                                      overlayVersion + ':' + overlayFileName + ':' + 
-                                      (usingLibUltrahand ? '1' : '0') + ':' + 
-                                      (supportsAMS110 ? '1' : '0') + ":0";
-                    overlaySet.emplace(std::move(overlayEntryKey));
+                    MenuEntry& entry = menuScan.entries.emplace_back();
+                    entry.flags = (usingLibUltrahand ? MENU_ENTRY_LIBULTRAHAND : 0) |
+                                  (supportsAMS110 ? MENU_ENTRY_SUPPORTS_AMS110 : 0);
+                    entry.name = menuScan.arena.append(overlayName);
+                    entry.version = menuScan.arena.append(overlayVersion);
+                    entry.fileName = menuScan.arena.append(overlayFileName);
                 } else {
                     const std::string& hide = getValueOrDefault(it->second, HIDE_STR, FALSE_STR);
                     const bool isHidden = (hide == TRUE_STR);
                     
                     if (isHidden) {
                         if (!hideUnsupported || !requiresLNY2 || 
-                            usingLNY2(OVERLAY_PATH + overlayFileName) || 
+                            supportsAMS110 || 
                             getValueOrDefault(it->second, "force_support", FALSE_STR) == TRUE_STR) {
-                            drawHiddenTab = true;
+                            menuScan.drawHiddenTab = true;
                         }
                     }
                     
                     if ((!inHiddenMode && !isHidden) || (inHiddenMode && isHidden)) {  
-                        const std::string& priority = (it->second.find(PRIORITY_STR) != it->second.end()) ? formatPriorityString(it->second[PRIORITY_STR]) : "0020";
+                        const int priority = (it->second.find(PRIORITY_STR) != it->second.end()) ? ult::stoi(formatPriorityString(it->second[PRIORITY_STR])) : 20;
                         const std::string& starred = getValueOrDefault(it->second, STAR_STR, FALSE_STR);
                         const std::string& customName = getValueOrDefault(it->second, "custom_name", "");
                         const std::string& customVersion = getValueOrDefault(it->second, "custom_version", "");
@@ -6414,20 +6584,15 @@ public:
                         const std::string& assignedVersion = !customVersion.empty() ? customVersion : overlayVersion;
                         const bool forceAMS110Support = getValueOrDefault(it->second, "force_support", FALSE_STR) == TRUE_STR;
     
-                        // Build entry key with single allocation
-                        //overlayEntryKey.clear();
-                        //const bool isStarred = (starred == TRUE_STR);
-                        //const size_t estimatedSize = (isStarred ? 3 : 0) + priority.size() + 
-                        //                            assignedName.size() * 2 + assignedVersion.size() + 
-                        //                            overlayFileName.size() + 10;
-                        //overlayEntryKey.reserve(estimatedSize);
-                        
-                        overlayEntryKey = (starred == TRUE_STR ? "-1:" : "") + priority + assignedName + ':' + 
-                                          assignedName + ':' + assignedVersion + ':' + overlayFileName + ':' + 
-                                          (usingLibUltrahand ? '1' : '0') + ':' + 
-                                          (supportsAMS110 ? '1' : '0') + ':' + 
-                                          (forceAMS110Support ? '1' : '0');
-                        overlaySet.emplace(std::move(overlayEntryKey));
+                        MenuEntry& entry = menuScan.entries.emplace_back();
+                        entry.priority = priority;
+                        entry.starred = (starred == TRUE_STR);
+                        entry.flags = (usingLibUltrahand ? MENU_ENTRY_LIBULTRAHAND : 0) |
+                                      (supportsAMS110 ? MENU_ENTRY_SUPPORTS_AMS110 : 0) |
+                                      (forceAMS110Support ? MENU_ENTRY_FORCE_AMS110 : 0);
+                        entry.name = menuScan.arena.append(assignedName);
+                        entry.version = menuScan.arena.append(assignedVersion);
+                        entry.fileName = menuScan.arena.append(overlayFileName);
                     }
                 }
             }
@@ -6435,240 +6600,201 @@ public:
             if (overlaysNeedsUpdate) {
                 saveIniFileData(OVERLAYS_INI_FILEPATH, overlaysIniData);
             }
+            overlayInfoCache.save();
         } // overlaysIniData freed here
         
         overlayFiles.clear();
         overlayFiles.shrink_to_fit();
+        sortMenuEntries(menuScan.entries, menuScan.arena);
+    }
+
+    void addOverlayListItem(const MenuEntry& overlayEntry) {
+        const std::string overlayFileName(menuScan.arena.view(overlayEntry.fileName));
+        const std::string overlayName(menuScan.arena.view(overlayEntry.name));
+        const std::string overlayVersion(menuScan.arena.view(overlayEntry.version));
+        const bool overlayStarred = overlayEntry.starred;
+        const bool usingLibUltrahand = overlayEntry.flags & MENU_ENTRY_LIBULTRAHAND;
+        const bool supportsAMS110 = overlayEntry.flags & MENU_ENTRY_SUPPORTS_AMS110;
+        const bool forceAMS110Support = overlayEntry.flags & MENU_ENTRY_FORCE_AMS110;
+
+        const bool requiresAMS110Handling = (requiresLNY2 && !supportsAMS110 && !forceAMS110Support);
+        if (hideUnsupported && requiresAMS110Handling)
+            return;
+
+        const std::string overlayFile = OVERLAY_PATH + overlayFileName;
+        if (!isFile(overlayFile)) return;
         
-        if (overlaySet.empty()) {
-            addSelectionIsEmptyDrawer(list);
+        // Build newOverlayName with single allocation
+        std::string newOverlayName;
+        if (overlayStarred) {
+            newOverlayName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
+            newOverlayName = STAR_SYMBOL;
+            newOverlayName += "  ";
+            newOverlayName += overlayName;
         } else {
-            // Pre-allocate string buffers for parsing loop
-            std::string overlayFileName, overlayName, overlayVersion, newOverlayName, displayVersion;
-            overlayFileName.reserve(64);
-            overlayName.reserve(128);
-            overlayVersion.reserve(64);
-            newOverlayName.reserve(192);
-            displayVersion.reserve(64);
+            newOverlayName = overlayName;
+        }
+        newOverlayName += '?';
+        newOverlayName += overlayFileName;
+        
+        const bool newStarred = !overlayStarred;
+        
+        tsl::elm::ListItem* listItem = new tsl::elm::ListItem(newOverlayName, "", false, false);
+        
+        std::string displayVersion;
+        if (!hideOverlayVersions) {
+            displayVersion = getFirstLongEntry(overlayVersion);
+            if (cleanVersionLabels) displayVersion = cleanVersionLabel(displayVersion);
+            listItem->setValue(displayVersion, true);
+            listItem->setValueColor(usingLibUltrahand ? (useLibultrahandVersions ? tsl::ultOverlayVersionTextColor : tsl::overlayVersionTextColor) : tsl::overlayVersionTextColor);
+        }
+        listItem->setTextColor(requiresAMS110Handling ? tsl::warningTextColor : usingLibUltrahand ? (useLibultrahandTitles ? tsl::ultOverlayTextColor : tsl::overlayTextColor) : tsl::overlayTextColor);
+        
+        if (overlayFileName == lastOverlayFilename) {
+            lastOverlayFilename = "";
+            jumpItemName = newOverlayName;
+            jumpItemValue = hideOverlayVersions ? "" : displayVersion;
+            jumpItemExactMatch.store(true, std::memory_order_release);
+        }
+        
+        listItem->setClickListener([overlayFile, newStarred, overlayFileName, overlayName, overlayVersion, requiresAMS110Handling, supportsAMS110](s64 keys) {
+            if (runningInterpreter.load(std::memory_order_acquire)) return false;
             
-            // Process overlay set and add to list
-            for (const auto& taintedOverlayFileName : overlaySet) {
-                overlayFileName.clear();
-                overlayName.clear();
-                overlayVersion.clear();
-                const bool overlayStarred = (taintedOverlayFileName.compare(0, 3, "-1:") == 0);
-                bool usingLibUltrahand = false;
-                bool supportsAMS110 = false;
-                bool forceAMS110Support = false;
-                
-                // Parse from the end - optimized with fewer branches
-                const size_t len = taintedOverlayFileName.size();
-                size_t pos = len;
-                size_t positions[6];
-                size_t count = 0;
+            if (simulatedMenu.load(std::memory_order_acquire)) {
+                keys |= SYSTEM_SETTINGS_KEY;
+            }
+            
+            if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK)) && !requiresAMS110Handling) {
+                disableSound.store(true, std::memory_order_release);
                 
-                // Unrolled loop for better performance on ARMv8-A
-                while (pos > 0 && count < 6) {
-                    pos = taintedOverlayFileName.rfind(':', pos - 1);
-                    if (pos == std::string::npos) break;
-                    positions[count++] = pos;
+                std::string useOverlayLaunchArgs, overlayLaunchArgs;
+                {
+                    auto overlaysIniData = getParsedDataFromIniFile(OVERLAYS_INI_FILEPATH);
+                    auto sectionIt = overlaysIniData.find(overlayFileName);
+                    if (sectionIt != overlaysIniData.end()) {
+                        auto useArgsIt = sectionIt->second.find(USE_LAUNCH_ARGS_STR);
+                        if (useArgsIt != sectionIt->second.end()) useOverlayLaunchArgs = useArgsIt->second;
+                        auto argsIt = sectionIt->second.find(LAUNCH_ARGS_STR);
+                        if (argsIt != sectionIt->second.end()) overlayLaunchArgs = argsIt->second;
+                    }
+                    removeQuotes(overlayLaunchArgs);
                 }
                 
-                if (count == 6) {
-                    // Direct character access instead of substr for single chars
-                    forceAMS110Support = (taintedOverlayFileName[positions[0] + 1] == '1');
-                    supportsAMS110 = (taintedOverlayFileName[positions[1] + 1] == '1');
-                    usingLibUltrahand = (taintedOverlayFileName[positions[2] + 1] == '1');
-                    overlayFileName.assign(taintedOverlayFileName, positions[3] + 1, positions[2] - positions[3] - 1);
-                    overlayVersion.assign(taintedOverlayFileName, positions[4] + 1, positions[3] - positions[4] - 1);
-                    overlayName.assign(taintedOverlayFileName, positions[5] + 1, positions[4] - positions[5] - 1);
-                }
-    
-                const bool requiresAMS110Handling = (requiresLNY2 && !supportsAMS110 && !forceAMS110Support);
-                if (hideUnsupported && requiresAMS110Handling)
-                    continue;
-    
-                const std::string overlayFile = OVERLAY_PATH + overlayFileName;
-                if (!isFile(overlayFile)) continue;
+                // Written out by exitServices once the overlay closes
+                if (inHiddenMode) settingsStore.setBool(Setting::InHiddenOverlay, true);
+                settingsStore.setBool(Setting::InOverlay, true);
                 
-                // Build newOverlayName with single allocation
-                newOverlayName.clear();
-                if (overlayStarred) {
-                    newOverlayName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
-                    newOverlayName = STAR_SYMBOL;
-                    newOverlayName += "  ";
-                    newOverlayName += overlayName;
+                launchComboHasTriggered.store(true, std::memory_order_acquire);
+                ult::launchingOverlay.store(true, std::memory_order_release);
+                if (useOverlayLaunchArgs == TRUE_STR) tsl::setNextOverlay(overlayFile, overlayLaunchArgs);
+                else tsl::setNextOverlay(overlayFile);
+
+                tsl::Overlay::get()->close(true);
+                return true;
+            } else if (keys & STAR_KEY && !(keys & ~STAR_KEY & ALL_KEYS_MASK)) {
+                if (!overlayFile.empty()) {
+                    setIniFileValue(OVERLAYS_INI_FILEPATH, overlayFileName, STAR_STR, newStarred ? TRUE_STR : FALSE_STR);
+                }
+                skipJumpReset.store(true, std::memory_order_release);
+                std::string jumpName;
+                if (newStarred) {
+                    jumpName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
+                    jumpName = STAR_SYMBOL;
+                    jumpName += "  ";
+                    jumpName += overlayName;
                 } else {
-                    newOverlayName = overlayName;
+                    jumpName = overlayName;
+                }
+                jumpName += '?';
+                jumpName += overlayFileName;
+                jumpItemName = jumpName;
+                jumpItemValue = hideOverlayVersions ? "" : overlayVersion;
+                jumpItemExactMatch.store(true, std::memory_order_release);
+                wasInHiddenMode = inHiddenMode;
+                if (inHiddenMode) {
+                    inMainMenu.store(false, std::memory_order_release);
+                    inHiddenMode = true;
+                    reloadMenu2 = true;
                 }
-                newOverlayName += '?';
-                newOverlayName += overlayFileName;
-                
-                const bool newStarred = !overlayStarred;
-                
-                tsl::elm::ListItem* listItem = new tsl::elm::ListItem(newOverlayName, "", false, false);
-                
-                if (!hideOverlayVersions) {
-                    displayVersion = getFirstLongEntry(overlayVersion);
-                    if (cleanVersionLabels) displayVersion = cleanVersionLabel(displayVersion);
-                    listItem->setValue(displayVersion, true);
-                    listItem->setValueColor(usingLibUltrahand ? (useLibultrahandVersions ? tsl::ultOverlayVersionTextColor : tsl::overlayVersionTextColor) : tsl::overlayVersionTextColor);
+                refreshPage.store(true, std::memory_order_release);
+                triggerRumbleClick.store(true, std::memory_order_release);
+                triggerMoveSound.store(true, std::memory_order_release);
+                return true;
+            } else if (keys & SETTINGS_KEY && !(keys & ~SETTINGS_KEY & ALL_KEYS_MASK)) {
+                if (!inHiddenMode) {
+                    lastMenu = "";
+                    inMainMenu.store(false, std::memory_order_release);
+                } else {
+                    lastMenu = "hiddenMenuMode";
+                    inHiddenMode = false;
                 }
-                listItem->setTextColor(requiresAMS110Handling ? tsl::warningTextColor : usingLibUltrahand ? (useLibultrahandTitles ? tsl::ultOverlayTextColor : tsl::overlayTextColor) : tsl::overlayTextColor);
-                
-                if (overlayFileName == lastOverlayFilename) {
-                    lastOverlayFilename = "";
-                    jumpItemName = newOverlayName;
-                    jumpItemValue = hideOverlayVersions ? "" : displayVersion;
-                    jumpItemExactMatch.store(true, std::memory_order_release);
+                std::string returnName;
+                if (!newStarred) {
+                    returnName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
+                    returnName = STAR_SYMBOL;
+                    returnName += "  ";
+                    returnName += overlayName;
+                } else {
+                    returnName = overlayName;
+                }
+                returnName += '?';
+                returnName += overlayFileName;
+                returnJumpItemName = returnName;
+                returnJumpItemValue = hideOverlayVersions ? "" : overlayVersion;
+                jumpItemName = jumpItemValue = "";
+                tsl::changeTo<SettingsMenu>(overlayFileName, OVERLAY_STR, overlayName, overlayVersion, "", !supportsAMS110);
+                triggerRumbleClick.store(true, std::memory_order_release);
+                triggerSettingsSound.store(true, std::memory_order_release);
+                return true;
+            } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
+                std::string returnName;
+                if (!newStarred) {
+                    returnName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
+                    returnName = STAR_SYMBOL;
+                    returnName += "  ";
+                    returnName += overlayName;
+                } else {
+                    returnName = overlayName;
                 }
-                
-                listItem->setClickListener([overlayFile, newStarred, overlayFileName, overlayName, overlayVersion, requiresAMS110Handling, supportsAMS110](s64 keys) {
-                    if (runningInterpreter.load(std::memory_order_acquire)) return false;
-                    
-                    if (simulatedMenu.load(std::memory_order_acquire)) {
-                        keys |= SYSTEM_SETTINGS_KEY;
-                    }
-                    
-                    if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK)) && !requiresAMS110Handling) {
-                        disableSound.store(true, std::memory_order_release);
-                        
-                        std::string useOverlayLaunchArgs, overlayLaunchArgs;
-                        {
-                            auto overlaysIniData = getParsedDataFromIniFile(OVERLAYS_INI_FILEPATH);
-                            auto sectionIt = overlaysIniData.find(overlayFileName);
-                            if (sectionIt != overlaysIniData.end()) {
-                                auto useArgsIt = sectionIt->second.find(USE_LAUNCH_ARGS_STR);
-                                if (useArgsIt != sectionIt->second.end()) useOverlayLaunchArgs = useArgsIt->second;
-                                auto argsIt = sectionIt->second.find(LAUNCH_ARGS_STR);
-                                if (argsIt != sectionIt->second.end()) overlayLaunchArgs = argsIt->second;
-                            }
-                            removeQuotes(overlayLaunchArgs);
-                        }
-                        
-                        {
-                            auto iniData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-                            auto& ultrahandSection = iniData[ULTRAHAND_PROJECT_NAME];
-                            if (inHiddenMode) ultrahandSection[IN_HIDDEN_OVERLAY_STR] = TRUE_STR;
-                            ultrahandSection[IN_OVERLAY_STR] = TRUE_STR;
-                            saveIniFileData(ULTRAHAND_CONFIG_INI_PATH, iniData);
-                        }
-                        
-                        launchComboHasTriggered.store(true, std::memory_order_acquire);
-                        ult::launchingOverlay.store(true, std::memory_order_release);
-                        if (useOverlayLaunchArgs == TRUE_STR) tsl::setNextOverlay(overlayFile, overlayLaunchArgs);
-                        else tsl::setNextOverlay(overlayFile);
-    
-                        tsl::Overlay::get()->close(true);
-                        return true;
-                    } else if (keys & STAR_KEY && !(keys & ~STAR_KEY & ALL_KEYS_MASK)) {
-                        if (!overlayFile.empty()) {
-                            setIniFileValue(OVERLAYS_INI_FILEPATH, overlayFileName, STAR_STR, newStarred ? TRUE_STR : FALSE_STR);
-                        }
-                        skipJumpReset.store(true, std::memory_order_release);
-                        std::string jumpName;
-                        if (newStarred) {
-                            jumpName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
-                            jumpName = STAR_SYMBOL;
-                            jumpName += "  ";
-                            jumpName += overlayName;
-                        } else {
-                            jumpName = overlayName;
-                        }
-                        jumpName += '?';
-                        jumpName += overlayFileName;
-                        jumpItemName = jumpName;
-                        jumpItemValue = hideOverlayVersions ? "" : overlayVersion;
-                        jumpItemExactMatch.store(true, std::memory_order_release);
-                        wasInHiddenMode = inHiddenMode;
-                        if (inHiddenMode) {
-                            inMainMenu.store(false, std::memory_order_release);
-                            inHiddenMode = true;
-                            reloadMenu2 = true;
-                        }
-                        refreshPage.store(true, std::memory_order_release);
-                        triggerRumbleClick.store(true, std::memory_order_release);
-                        triggerMoveSound.store(true, std::memory_order_release);
-                        return true;
-                    } else if (keys & SETTINGS_KEY && !(keys & ~SETTINGS_KEY & ALL_KEYS_MASK)) {
-                        if (!inHiddenMode) {
-                            lastMenu = "";
-                            inMainMenu.store(false, std::memory_order_release);
-                        } else {
-                            lastMenu = "hiddenMenuMode";
-                            inHiddenMode = false;
-                        }
-                        std::string returnName;
-                        if (!newStarred) {
-                            returnName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
-                            returnName = STAR_SYMBOL;
-                            returnName += "  ";
-                            returnName += overlayName;
-                        } else {
-                            returnName = overlayName;
-                        }
-                        returnName += '?';
-                        returnName += overlayFileName;
-                        returnJumpItemName = returnName;
-                        returnJumpItemValue = hideOverlayVersions ? "" : overlayVersion;
-                        jumpItemName = jumpItemValue = "";
-                        tsl::changeTo<SettingsMenu>(overlayFileName, OVERLAY_STR, overlayName, overlayVersion, "", !supportsAMS110);
-                        triggerRumbleClick.store(true, std::memory_order_release);
-                        triggerSettingsSound.store(true, std::memory_order_release);
-                        return true;
-                    } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
-                        std::string returnName;
-                        if (!newStarred) {
-                            returnName.reserve(STAR_SYMBOL.size() + 2 + overlayName.size() + 1 + overlayFileName.size());
-                            returnName = STAR_SYMBOL;
-                            returnName += "  ";
-                            returnName += overlayName;
-                        } else {
-                            returnName = overlayName;
-                        }
-                        returnName += '?';
-                        returnName += overlayFileName;
-                        returnJumpItemName = returnName;
-                        returnJumpItemValue = hideOverlayVersions ? "" : overlayVersion;
-                        return true;
-                    }
-                    return false;
-                });
-                if (requiresAMS110Handling) {
-                    listItem->isLocked = true;
-                }
-                listItem->disableClickAnimation();
-                list->addItem(listItem);
+                returnName += '?';
+                returnName += overlayFileName;
+                returnJumpItemName = returnName;
+                returnJumpItemValue = hideOverlayVersions ? "" : overlayVersion;
+                return true;
             }
-            
-            overlaySet.clear();
-        }
-        
-        if (drawHiddenTab && !inHiddenMode && !hideHidden) {
-            tsl::elm::ListItem* listItem = new tsl::elm::ListItem(HIDDEN, DROPDOWN_SYMBOL);
-            listItem->setClickListener([](uint64_t keys) {
-                if (runningInterpreter.load(std::memory_order_acquire)) return false;
-                if (simulatedMenu.load(std::memory_order_acquire)) {
-                    keys |= SYSTEM_SETTINGS_KEY;
-                }
-    
-                if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                    jumpItemName = "";
-                    jumpItemValue = "";
-                    jumpItemExactMatch.store(true, std::memory_order_release);
-                    inMainMenu.store(false, std::memory_order_release);
-                    inHiddenMode = true;
-                    tsl::changeTo<MainMenu>(OVERLAYS_STR);
-                    return true;
-                } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
-                    returnJumpItemName = "";
-                    returnJumpItemValue = DROPDOWN_SYMBOL;
-                    return true;
-                }
-                return false;
-            });
-            list->addItem(listItem);
+            return false;
+        });
+        if (requiresAMS110Handling) {
+            listItem->isLocked = true;
         }
+        listItem->disableClickAnimation();
+        populatingList->addItem(listItem, 0, listInsertIndex++);
+    }
+
+    void addOverlaysHiddenTab() {
+        tsl::elm::ListItem* listItem = new tsl::elm::ListItem(HIDDEN, DROPDOWN_SYMBOL);
+        listItem->setClickListener([](uint64_t keys) {
+            if (runningInterpreter.load(std::memory_order_acquire)) return false;
+            if (simulatedMenu.load(std::memory_order_acquire)) {
+                keys |= SYSTEM_SETTINGS_KEY;
+            }
+
+            if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
+                jumpItemName = "";
+                jumpItemValue = "";
+                jumpItemExactMatch.store(true, std::memory_order_release);
+                inMainMenu.store(false, std::memory_order_release);
+                inHiddenMode = true;
+                tsl::changeTo<MainMenu>(OVERLAYS_STR);
+                return true;
+            } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
+                returnJumpItemName = "";
+                returnJumpItemValue = DROPDOWN_SYMBOL;
+                return true;
+            }
+            return false;
+        });
+        populatingList->addItem(listItem, 0, listInsertIndex++);
     }
     
     bool createPackagesMenu(tsl::elm::List* list) {
@@ -6694,319 +6820,295 @@ public:
     
         bool noClickableItems = false;
     
-        if (dropdownSection.empty()) {
-            createDirectory(PACKAGE_PATH);
+        if (dropdownSection.empty())
+            startListPopulation(list, 0, &MainMenu::scanPackages);
+        
+        if (!inHiddenMode) {
+            std::string pageLeftName, pageRightName, pathPattern, pathPatternOn, pathPatternOff;
+            bool usingPages = false;
             
-            #if !USING_FSTREAM_DIRECTIVE
-            if (!isFile(PACKAGES_INI_FILEPATH)) {
-                FILE* createFile = fopen(PACKAGES_INI_FILEPATH.c_str(), "w");
-                if (createFile) fclose(createFile);
-            }
-            #else
-            if (!isFile(PACKAGES_INI_FILEPATH)) {
-                std::ofstream createFile(PACKAGES_INI_FILEPATH);
-                createFile.close();
-            }
-            #endif
+            const PackageHeader packageHeader = getPackageHeaderFromIni(PACKAGE_PATH);
+            noClickableItems = drawCommandsMenu(list, packageIniPath, packageConfigIniPath, packageHeader, "", pageLeftName, pageRightName,
+                PACKAGE_PATH, "left", "package.ini", this->dropdownSection, 0, pathPattern, pathPatternOn, pathPatternOff, usingPages, false);
     
-            std::set<std::string> packageSet;
-            bool drawHiddenTab = false;
+            if (!hideUserGuide && dropdownSection.empty()) addHelpInfo(list);
+        }
+        
+        return noClickableItems;
+    }
+
+    /**
+     * @brief Collects and sorts the package entries into menuScan.
+     *
+     * Runs on the menu scan thread; only touches the filesystem, packages.ini, packageIndex and menuScan.
+     */
+    void scanPackages() {
+        createDirectory(PACKAGE_PATH);
+        
+        #if !USING_FSTREAM_DIRECTIVE
+        if (!isFile(PACKAGES_INI_FILEPATH)) {
+            FILE* createFile = fopen(PACKAGES_INI_FILEPATH.c_str(), "w");
+            if (createFile) fclose(createFile);
+        }
+        #else
+        if (!isFile(PACKAGES_INI_FILEPATH)) {
+            std::ofstream createFile(PACKAGES_INI_FILEPATH);
+            createFile.close();
+        }
+        #endif
+
+        menuScan.hasSources = true;
+
+        // Scope to immediately free INI data
+        {
+            auto packagesIniData = getParsedDataFromIniFile(PACKAGES_INI_FILEPATH);
+            auto subdirectories = getSubdirectories(PACKAGE_PATH);
+
+            subdirectories.erase(
+                std::remove_if(subdirectories.begin(), subdirectories.end(),
+                    [](const std::string& dirName) { return dirName.front() == '.'; }),
+                subdirectories.end()
+            );
+            packageIndex.refresh(subdirectories);
+            menuScan.entries.reserve(subdirectories.size());
+            menuScan.arena.buffer.reserve(subdirectories.size() * 64);
+
+            bool packagesNeedsUpdate = false;
+
+            for (const auto& packageName : subdirectories) {
+                auto packageIt = packagesIniData.find(packageName);
+                if (packageIt == packagesIniData.end()) {
+                    const PackageIndex::Info* packageInfo = packageIndex.find(packageName);
+                    
+                    auto& packageSection = packagesIniData[packageName];
+                    packageSection[PRIORITY_STR] = "20";
+                    packageSection[STAR_STR] = FALSE_STR;
+                    packageSection[HIDE_STR] = FALSE_STR;
+                    packageSection[USE_BOOT_PACKAGE_STR] = TRUE_STR;
+                    packageSection[USE_EXIT_PACKAGE_STR] = TRUE_STR;
+                    packageSection[USE_QUICK_LAUNCH_STR] = FALSE_STR;
+                    packageSection["custom_name"] = "";
+                    packageSection["custom_version"] = "";
+                    packagesNeedsUpdate = true;
             
-            // Scope to immediately free INI data
-            {
-                auto packagesIniData = getParsedDataFromIniFile(PACKAGES_INI_FILEPATH);
-                auto subdirectories = getSubdirectories(PACKAGE_PATH);
-    
-                subdirectories.erase(
-                    std::remove_if(subdirectories.begin(), subdirectories.end(),
-                        [](const std::string& dirName) { return dirName.front() == '.'; }),
-                    subdirectories.end()
-                );
-    
-                bool packagesNeedsUpdate = false;
-    
-                for (const auto& packageName : subdirectories) {
-                    auto packageIt = packagesIniData.find(packageName);
-                    if (packageIt == packagesIniData.end()) {
-                        const PackageHeader packageHeader = getPackageHeaderFromIni(PACKAGE_PATH + packageName+ "/" +PACKAGE_FILENAME);
+                    MenuEntry& entry = menuScan.entries.emplace_back();
+                    entry.name = menuScan.arena.append((!packageInfo || packageInfo->title.empty()) ? packageName : packageInfo->title);
+                    entry.version = menuScan.arena.append(packageInfo ? packageInfo->version : "");
+                    entry.fileName = menuScan.arena.append(packageName);
+                } else {
+                    const std::string hide = (packageIt->second.find(HIDE_STR) != packageIt->second.end()) ? packageIt->second[HIDE_STR] : FALSE_STR;
+                    if (hide == TRUE_STR) menuScan.drawHiddenTab = true;
+                    
+                    if ((!inHiddenMode && hide == FALSE_STR) || (inHiddenMode && hide == TRUE_STR)) {
+                        const PackageIndex::Info* packageInfo = packageIndex.find(packageName);
+                        std::string packageTitle, packageVersion;
+                        if (packageInfo) {
+                            packageTitle = packageInfo->title;
+                            packageVersion = packageInfo->version;
+                        }
+                        if (cleanVersionLabels) {
+                            packageVersion = cleanVersionLabel(packageVersion);
+                            removeQuotes(packageVersion);
+                        }
                         
-                        auto& packageSection = packagesIniData[packageName];
-                        packageSection[PRIORITY_STR] = "20";
-                        packageSection[STAR_STR] = FALSE_STR;
-                        packageSection[HIDE_STR] = FALSE_STR;
-                        packageSection[USE_BOOT_PACKAGE_STR] = TRUE_STR;
-                        packageSection[USE_EXIT_PACKAGE_STR] = TRUE_STR;
-                        packageSection[USE_QUICK_LAUNCH_STR] = FALSE_STR;
-                        packageSection["custom_name"] = "";
-                        packageSection["custom_version"] = "";
-                        packagesNeedsUpdate = true;
-                
-                        const std::string assignedName = packageHeader.title.empty() ? packageName : packageHeader.title;
-                        std::string entry;
-                        entry.reserve(128);
-                        entry = "0020:";
-                        entry += assignedName;
-                        entry += ":";
-                        entry += packageHeader.version;
-                        entry += ":";
-                        entry += packageName;
-                        packageSet.emplace(std::move(entry));
-                    } else {
-                        const std::string hide = (packageIt->second.find(HIDE_STR) != packageIt->second.end()) ? packageIt->second[HIDE_STR] : FALSE_STR;
-                        if (hide == TRUE_STR) drawHiddenTab = true;
+                        const int priority = (packageIt->second.find(PRIORITY_STR) != packageIt->second.end()) ? ult::stoi(formatPriorityString(packageIt->second[PRIORITY_STR])) : 20;
+                        const std::string starred = (packageIt->second.find(STAR_STR) != packageIt->second.end()) ? packageIt->second[STAR_STR] : FALSE_STR;
+                        const std::string customName = getValueOrDefault(packageIt->second, "custom_name", "");
+                        const std::string customVersion = getValueOrDefault(packageIt->second, "custom_version", "");
                         
-                        if ((!inHiddenMode && hide == FALSE_STR) || (inHiddenMode && hide == TRUE_STR)) {
-                            PackageHeader packageHeader = getPackageHeaderFromIni(PACKAGE_PATH + packageName+ "/" +PACKAGE_FILENAME);
-                            if (cleanVersionLabels) {
-                                packageHeader.version = cleanVersionLabel(packageHeader.version);
-                                removeQuotes(packageHeader.version);
-                            }
-                            
-                            const std::string priority = (packageIt->second.find(PRIORITY_STR) != packageIt->second.end()) ? formatPriorityString(packageIt->second[PRIORITY_STR]) : "0020";
-                            const std::string starred = (packageIt->second.find(STAR_STR) != packageIt->second.end()) ? packageIt->second[STAR_STR] : FALSE_STR;
-                            const std::string customName = getValueOrDefault(packageIt->second, "custom_name", "");
-                            const std::string customVersion = getValueOrDefault(packageIt->second, "custom_version", "");
-                            
-                            const std::string assignedName = !customName.empty() ? customName : (packageHeader.title.empty() ? packageName : packageHeader.title);
-                            const std::string assignedVersion = !customVersion.empty() ? customVersion : packageHeader.version;
-                            
-                            std::string entry;
-                            entry.reserve(128);
-                            if (starred == TRUE_STR) {
-                                entry = "-1:";
-                            }
-                            entry += priority;
-                            entry += ":";
-                            entry += assignedName;
-                            entry += ":";
-                            entry += assignedVersion;
-                            entry += ":";
-                            entry += packageName;
-                            packageSet.emplace(std::move(entry));
-                        }
+                        const std::string assignedName = !customName.empty() ? customName : (packageTitle.empty() ? packageName : packageTitle);
+                        const std::string assignedVersion = !customVersion.empty() ? customVersion : packageVersion;
+                        
+                        MenuEntry& entry = menuScan.entries.emplace_back();
+                        entry.priority = priority;
+                        entry.starred = (starred == TRUE_STR);
+                        entry.name = menuScan.arena.append(assignedName);
+                        entry.version = menuScan.arena.append(assignedVersion);
+                        entry.fileName = menuScan.arena.append(packageName);
                     }
                 }
-    
-                if (packagesNeedsUpdate) {
-                    saveIniFileData(PACKAGES_INI_FILEPATH, packagesIniData);
-                }
-            } // packagesIniData freed here
+            }
+
+            if (packagesNeedsUpdate) {
+                saveIniFileData(PACKAGES_INI_FILEPATH, packagesIniData);
+            }
+        } // packagesIniData freed here
+        
+        sortMenuEntries(menuScan.entries, menuScan.arena);
+    }
+
+    void addPackageListItem(const MenuEntry& packageEntry) {
+        const std::string packageName(menuScan.arena.view(packageEntry.fileName));
+        const std::string packageVersion(menuScan.arena.view(packageEntry.version));
+        const std::string newPackageName(menuScan.arena.view(packageEntry.name));
+        const bool packageStarred = packageEntry.starred;
+        
+        const std::string packageFilePath = PACKAGE_PATH + packageName + "/";
+        if (!isFileOrDirectory(packageFilePath)) return;
+
+        const bool newStarred = !packageStarred;
+
+        std::string displayName;
+        if (packageStarred) {
+            displayName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
+            displayName = STAR_SYMBOL;
+            displayName += "  ";
+            displayName += newPackageName;
+        } else {
+            displayName = newPackageName;
+        }
+        displayName += "?";
+        displayName += packageName;
+
+        tsl::elm::ListItem* listItem = new tsl::elm::ListItem(displayName, "", false, false);
+        prefetchTargets.emplace(listItem, packageFilePath + PACKAGE_FILENAME);
+        if (!hidePackageVersions) {
+            listItem->setValue(packageVersion, true);
+            listItem->setValueColor(usePackageVersions ? tsl::ultPackageVersionTextColor : tsl::packageVersionTextColor);
+        }
+        listItem->setTextColor(usePackageTitles ? tsl::ultPackageTextColor : tsl::packageTextColor);
+        listItem->disableClickAnimation();
+        
+        listItem->setClickListener([packageFilePath, newStarred, packageName, newPackageName, packageVersion, packageStarred](s64 keys) {
+            if (runningInterpreter.load(acquire)) return false;
             
-            std::string packageName, packageVersion, newPackageName;
-    
-            bool firstItem = true;
-            for (const auto& taintedPackageName : packageSet) {
-                if (firstItem) {
-                    addHeader(list, (!inHiddenMode ? PACKAGES : HIDDEN_PACKAGES)+" "+DIVIDER_SYMBOL+" \uE0E3 "+SETTINGS+" "+DIVIDER_SYMBOL+" \uE0E2 "+FAVORITE);
-                    firstItem = false;
-                }
-                
-                packageName.clear();
-                packageVersion.clear();
-                newPackageName.clear();
-                const bool packageStarred = (taintedPackageName.compare(0, 3, "-1:") == 0);
-                const std::string& tempPackageName = packageStarred ? taintedPackageName : taintedPackageName;
-                const size_t offset = packageStarred ? 3 : 0;
-                
-                // Parse from the end more efficiently
-                size_t pos = tempPackageName.size();
-                size_t count = 0;
-                size_t positions[3];
+            if (simulatedMenu.load(std::memory_order_acquire)) {
+                keys |= SYSTEM_SETTINGS_KEY;
+            }
+
+            if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
+                inMainMenu.store(false, std::memory_order_release);
                 
-                while (pos > offset && count < 3) {
-                    pos = tempPackageName.rfind(':', pos - 1);
-                    if (pos == std::string::npos || pos < offset) break;
-                    positions[count++] = pos;
+                if (isFile(packageFilePath + BOOT_PACKAGE_FILENAME)) {
+                    bool useBootPackage = true;
+                    {
+                        const auto packagesIniData = getParsedDataFromIniFile(PACKAGES_INI_FILEPATH);
+                        auto sectionIt = packagesIniData.find(packageName);
+                        if (sectionIt != packagesIniData.end()) {
+                            auto bootIt = sectionIt->second.find(USE_BOOT_PACKAGE_STR);
+                            useBootPackage = (bootIt == sectionIt->second.end()) || (bootIt->second != FALSE_STR);
+                            if (!selectedPackage.empty()) {
+                                auto quickIt = sectionIt->second.find(USE_QUICK_LAUNCH_STR);
+                                const bool useQuickLaunch = (quickIt != sectionIt->second.end()) && (quickIt->second == TRUE_STR);
+                                useBootPackage = useBootPackage && !useQuickLaunch;
+                            }
+                        }
+                    }
+
+                    if (useBootPackage) {
+                        auto bootCommands = loadSpecificSectionFromIni(packageFilePath + BOOT_PACKAGE_FILENAME, "boot");
+                        if (!bootCommands.empty()) {
+                            const bool resetCommandSuccess = !commandSuccess.load(std::memory_order_acquire);
+                            interpretAndExecuteCommands(std::move(bootCommands), packageFilePath, "boot");
+                            resetPercentages();
+                            if (resetCommandSuccess) commandSuccess.store(false, release);
+                        }
+                    }
                 }
-                
-                if (count == 3) {
-                    packageName = tempPackageName.substr(positions[0] + 1);
-                    packageVersion = tempPackageName.substr(positions[1] + 1, positions[0] - positions[1] - 1);
-                    newPackageName = tempPackageName.substr(positions[2] + 1, positions[1] - positions[2] - 1);
+
+                packageRootLayerTitle = newPackageName;
+                packageRootLayerName = packageName;
+                packageRootLayerVersion = packageVersion;
+                packageRootLayerIsStarred = packageStarred;
+                tsl::clearGlyphCacheNow.store(true, release);
+                tsl::swapTo<PackageMenu>(SwapDepth(2), packageFilePath, "");
+                return true;
+            } else if (keys & STAR_KEY && !(keys & ~STAR_KEY & ALL_KEYS_MASK)) {
+                if (!packageName.empty()) setIniFileValue(PACKAGES_INI_FILEPATH, packageName, STAR_STR, newStarred ? TRUE_STR : FALSE_STR);
+                skipJumpReset.store(true, release);
+                std::string jumpName;
+                if (newStarred) {
+                    jumpName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
+                    jumpName = STAR_SYMBOL;
+                    jumpName += "  ";
+                    jumpName += newPackageName;
+                } else {
+                    jumpName = newPackageName;
                 }
-                
-                const std::string packageFilePath = PACKAGE_PATH + packageName + "/";
-                if (!isFileOrDirectory(packageFilePath)) continue;
-    
-                const bool newStarred = !packageStarred;
-    
-                std::string displayName;
-                if (packageStarred) {
-                    displayName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
-                    displayName = STAR_SYMBOL;
-                    displayName += "  ";
-                    displayName += newPackageName;
+                jumpName += "?";
+                jumpName += packageName;
+                jumpItemName = jumpName;
+                jumpItemValue = hidePackageVersions ? "" : packageVersion;
+                jumpItemExactMatch.store(true, release);
+                wasInHiddenMode = inHiddenMode;
+                if (inHiddenMode) {
+                    inMainMenu.store(false, std::memory_order_release);
+                    inHiddenMode = true;
+                    reloadMenu2 = true;
+                }
+                refreshPage.store(true, release);
+                triggerRumbleClick.store(true, std::memory_order_release);
+                triggerMoveSound.store(true, std::memory_order_release);
+                return true;
+            } else if (keys & SETTINGS_KEY && !(keys & ~SETTINGS_KEY & ALL_KEYS_MASK)) {
+                if (!inHiddenMode) {
+                    lastMenu = "";
+                    inMainMenu.store(false, std::memory_order_release);
                 } else {
-                    displayName = newPackageName;
+                    lastMenu = "hiddenMenuMode";
+                    inHiddenMode = false;
                 }
-                displayName += "?";
-                displayName += packageName;
-    
-                tsl::elm::ListItem* listItem = new tsl::elm::ListItem(displayName, "", false, false);
-                if (!hidePackageVersions) {
-                    listItem->setValue(packageVersion, true);
-                    listItem->setValueColor(usePackageVersions ? tsl::ultPackageVersionTextColor : tsl::packageVersionTextColor);
+                std::string returnName;
+                if (!newStarred) {
+                    returnName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
+                    returnName = STAR_SYMBOL;
+                    returnName += "  ";
+                    returnName += newPackageName;
+                } else {
+                    returnName = newPackageName;
+                }
+                returnName += "?";
+                returnName += packageName;
+                returnJumpItemName = returnName;
+                returnJumpItemValue = hidePackageVersions ? "" : packageVersion;
+                jumpItemName = jumpItemValue = "";
+                tsl::changeTo<SettingsMenu>(packageName, PACKAGE_STR, newPackageName, packageVersion);
+                triggerRumbleClick.store(true, std::memory_order_release);
+                triggerSettingsSound.store(true, std::memory_order_release);
+                return true;
+            } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
+                std::string returnName;
+                if (!newStarred) {
+                    returnName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
+                    returnName = STAR_SYMBOL;
+                    returnName += "  ";
+                    returnName += newPackageName;
+                } else {
+                    returnName = newPackageName;
                 }
-                listItem->setTextColor(usePackageTitles ? tsl::ultPackageTextColor : tsl::packageTextColor);
-                listItem->disableClickAnimation();
-                
-                listItem->setClickListener([packageFilePath, newStarred, packageName, newPackageName, packageVersion, packageStarred](s64 keys) {
-                    if (runningInterpreter.load(acquire)) return false;
-                    
-                    if (simulatedMenu.load(std::memory_order_acquire)) {
-                        keys |= SYSTEM_SETTINGS_KEY;
-                    }
-    
-                    if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                        inMainMenu.store(false, std::memory_order_release);
-                        
-                        if (isFile(packageFilePath + BOOT_PACKAGE_FILENAME)) {
-                            bool useBootPackage = true;
-                            {
-                                const auto packagesIniData = getParsedDataFromIniFile(PACKAGES_INI_FILEPATH);
-                                auto sectionIt = packagesIniData.find(packageName);
-                                if (sectionIt != packagesIniData.end()) {
-                                    auto bootIt = sectionIt->second.find(USE_BOOT_PACKAGE_STR);
-                                    useBootPackage = (bootIt == sectionIt->second.end()) || (bootIt->second != FALSE_STR);
-                                    if (!selectedPackage.empty()) {
-                                        auto quickIt = sectionIt->second.find(USE_QUICK_LAUNCH_STR);
-                                        const bool useQuickLaunch = (quickIt != sectionIt->second.end()) && (quickIt->second == TRUE_STR);
-                                        useBootPackage = useBootPackage && !useQuickLaunch;
-                                    }
-                                }
-                            }
-    
-                            if (useBootPackage) {
-                                auto bootCommands = loadSpecificSectionFromIni(packageFilePath + BOOT_PACKAGE_FILENAME, "boot");
-                                if (!bootCommands.empty()) {
-                                    const bool resetCommandSuccess = !commandSuccess.load(std::memory_order_acquire);
-                                    interpretAndExecuteCommands(std::move(bootCommands), packageFilePath, "boot");
-                                    resetPercentages();
-                                    if (resetCommandSuccess) commandSuccess.store(false, release);
-                                }
-                            }
-                        }
-    
-                        packageRootLayerTitle = newPackageName;
-                        packageRootLayerName = packageName;
-                        packageRootLayerVersion = packageVersion;
-                        packageRootLayerIsStarred = packageStarred;
-                        tsl::clearGlyphCacheNow.store(true, release);
-                        tsl::swapTo<PackageMenu>(SwapDepth(2), packageFilePath, "");
-                        return true;
-                    } else if (keys & STAR_KEY && !(keys & ~STAR_KEY & ALL_KEYS_MASK)) {
-                        if (!packageName.empty()) setIniFileValue(PACKAGES_INI_FILEPATH, packageName, STAR_STR, newStarred ? TRUE_STR : FALSE_STR);
-                        skipJumpReset.store(true, release);
-                        std::string jumpName;
-                        if (newStarred) {
-                            jumpName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
-                            jumpName = STAR_SYMBOL;
-                            jumpName += "  ";
-                            jumpName += newPackageName;
-                        } else {
-                            jumpName = newPackageName;
-                        }
-                        jumpName += "?";
-                        jumpName += packageName;
-                        jumpItemName = jumpName;
-                        jumpItemValue = hidePackageVersions ? "" : packageVersion;
-                        jumpItemExactMatch.store(true, release);
-                        wasInHiddenMode = inHiddenMode;
-                        if (inHiddenMode) {
-                            inMainMenu.store(false, std::memory_order_release);
-                            inHiddenMode = true;
-                            reloadMenu2 = true;
-                        }
-                        refreshPage.store(true, release);
-                        triggerRumbleClick.store(true, std::memory_order_release);
-                        triggerMoveSound.store(true, std::memory_order_release);
-                        return true;
-                    } else if (keys & SETTINGS_KEY && !(keys & ~SETTINGS_KEY & ALL_KEYS_MASK)) {
-                        if (!inHiddenMode) {
-                            lastMenu = "";
-                            inMainMenu.store(false, std::memory_order_release);
-                        } else {
-                            lastMenu = "hiddenMenuMode";
-                            inHiddenMode = false;
-                        }
-                        std::string returnName;
-                        if (!newStarred) {
-                            returnName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
-                            returnName = STAR_SYMBOL;
-                            returnName += "  ";
-                            returnName += newPackageName;
-                        } else {
-                            returnName = newPackageName;
-                        }
-                        returnName += "?";
-                        returnName += packageName;
-                        returnJumpItemName = returnName;
-                        returnJumpItemValue = hidePackageVersions ? "" : packageVersion;
-                        jumpItemName = jumpItemValue = "";
-                        tsl::changeTo<SettingsMenu>(packageName, PACKAGE_STR, newPackageName, packageVersion);
-                        triggerRumbleClick.store(true, std::memory_order_release);
-                        triggerSettingsSound.store(true, std::memory_order_release);
-                        return true;
-                    } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
-                        std::string returnName;
-                        if (!newStarred) {
-                            returnName.reserve(STAR_SYMBOL.size() + 2 + newPackageName.size() + 1 + packageName.size());
-                            returnName = STAR_SYMBOL;
-                            returnName += "  ";
-                            returnName += newPackageName;
-                        } else {
-                            returnName = newPackageName;
-                        }
-                        returnName += "?";
-                        returnName += packageName;
-                        returnJumpItemName = returnName;
-                        returnJumpItemValue = hidePackageVersions ? "" : packageVersion;
-                        return true;
-                    }
-                    return false;
-                });
-                
-                list->addItem(listItem);
-            }
-    
-            packageSet.clear();
-            
-            if (drawHiddenTab && !inHiddenMode && !hideHidden) {
-                tsl::elm::ListItem* listItem = new tsl::elm::ListItem(HIDDEN, DROPDOWN_SYMBOL);
-                listItem->setClickListener([](uint64_t keys) {
-                    if (runningInterpreter.load(acquire)) return false;
-                    if (simulatedMenu.load(std::memory_order_acquire)) {
-                        keys |= SYSTEM_SETTINGS_KEY;
-                    }
-    
-                    if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
-                        inMainMenu.store(false, std::memory_order_release);
-                        inHiddenMode = true;
-                        tsl::changeTo<MainMenu>(PACKAGES_STR);
-                        return true;
-                    } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
-                        returnJumpItemName = "";
-                        returnJumpItemValue = DROPDOWN_SYMBOL;
-                        return true;
-                    }
-                    return false;
-                });
-                list->addItem(listItem);
+                returnName += "?";
+                returnName += packageName;
+                returnJumpItemName = returnName;
+                returnJumpItemValue = hidePackageVersions ? "" : packageVersion;
+                return true;
             }
-        }
-        
-        if (!inHiddenMode) {
-            std::string pageLeftName, pageRightName, pathPattern, pathPatternOn, pathPatternOff;
-            bool usingPages = false;
-            
-            const PackageHeader packageHeader = getPackageHeaderFromIni(PACKAGE_PATH);
-            noClickableItems = drawCommandsMenu(list, packageIniPath, packageConfigIniPath, packageHeader, "", pageLeftName, pageRightName,
-                PACKAGE_PATH, "left", "package.ini", this->dropdownSection, 0, pathPattern, pathPatternOn, pathPatternOff, usingPages, false);
-    
-            if (!hideUserGuide && dropdownSection.empty()) addHelpInfo(list);
-        }
+            return false;
+        });
         
-        return noClickableItems;
+        populatingList->addItem(listItem, 0, listInsertIndex++);
+    }
+
+    void addPackagesHiddenTab() {
+        tsl::elm::ListItem* listItem = new tsl::elm::ListItem(HIDDEN, DROPDOWN_SYMBOL);
+        listItem->setClickListener([](uint64_t keys) {
+            if (runningInterpreter.load(acquire)) return false;
+            if (simulatedMenu.load(std::memory_order_acquire)) {
+                keys |= SYSTEM_SETTINGS_KEY;
+            }
+
+            if ((keys & KEY_A && !(keys & ~KEY_A & ALL_KEYS_MASK))) {
+                inMainMenu.store(false, std::memory_order_release);
+                inHiddenMode = true;
+                tsl::changeTo<MainMenu>(PACKAGES_STR);
+                return true;
+            } else if (keys & SYSTEM_SETTINGS_KEY && !(keys & ~SYSTEM_SETTINGS_KEY & ALL_KEYS_MASK)) {
+                returnJumpItemName = "";
+                returnJumpItemValue = DROPDOWN_SYMBOL;
+                return true;
+            }
+            return false;
+        });
+        populatingList->addItem(listItem, 0, listInsertIndex++);
     }
 
     /**
@@ -7030,6 +7132,12 @@ public:
         
         if (isRunningInterp)
             return handleRunningInterpreter(keysDown, keysHeld);
+        
+        // Entries are still being scanned; their INI files and the package index are not ours yet
+        if (populatingList && !menuScanJob.finished())
+            return true;
+        if (populatingList && (keysDown || isTouching))
+            populationInterrupted = true;
     
         if (lastRunningInterpreter.exchange(false, std::memory_order_acq_rel)) {
             //tsl::clearGlyphCacheNow.store(true, release);
@@ -7164,20 +7272,10 @@ public:
                 //
                 //setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, TRUE_STR);
 
-                // Load INI data once and modify in memory
-                {
-                    auto iniData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-                    auto& ultrahandSection = iniData[ULTRAHAND_PROJECT_NAME];
-                    
-                    // Make all changes in memory
-                    if (menuMode == PACKAGES_STR) {
-                        ultrahandSection["to_packages"] = FALSE_STR;
-                    }
-                    ultrahandSection[IN_OVERLAY_STR] = TRUE_STR;
-                    
-                    // Write back once
-                    saveIniFileData(ULTRAHAND_CONFIG_INI_PATH, iniData);
-                }
+                // Written out by exitServices once the overlay closes
+                if (menuMode == PACKAGES_STR)
+                    settingsStore.setBool(Setting::ToPackages, false);
+                settingsStore.setBool(Setting::InOverlay, true);
 
                 tsl::setNextOverlay(OVERLAY_PATH+"ovlmenu.ovl", "--skipCombo --comboReturn");
                 tsl::Overlay::get()->close();
@@ -7316,18 +7414,8 @@ public:
                     hiddenMenuMode = "";
                     //setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_HIDDEN_OVERLAY_STR, "");
                     //setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_HIDDEN_PACKAGE_STR, "");
-                    {
-                        // Load INI data once and modify in memory
-                        auto iniData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-                        auto& ultrahandSection = iniData[ULTRAHAND_PROJECT_NAME];
-                        
-                        // Clear both values in memory
-                        ultrahandSection[IN_HIDDEN_OVERLAY_STR] = "";
-                        ultrahandSection[IN_HIDDEN_PACKAGE_STR] = "";
-                        
-                        // Write back once
-                        saveIniFileData(ULTRAHAND_CONFIG_INI_PATH, iniData);
-                    }
+                    settingsStore.setBool(Setting::InHiddenOverlay, false);
+                    settingsStore.setBool(Setting::InHiddenPackage, false);
 
                     
                     {
@@ -7400,19 +7488,28 @@ public:
 };
 
 
+/**
+ * @brief Creates any missing Ultrahand directory.
+ *
+ * Each directory is checked on every boot, so one the user deleted is recreated; existing
+ * directories cost a single stat instead of a createDirectory call.
+ */
+static void ensureDirectoryLayout() {
+    for (const std::string& path : {PACKAGE_PATH, LANG_PATH, FLAGS_PATH, NOTIFICATIONS_PATH,
+                                    THEMES_PATH, WALLPAPERS_PATH, SOUNDS_PATH}) {
+        if (!isDirectory(path))
+            createDirectory(path);
+    }
+}
+
 // Extract the settings initialization logic into a separate method
 void initializeSettingsAndDirectories() {
     versionLabel = cleanVersionLabel(APP_VERSION) + " " + DIVIDER_SYMBOL + " " + loaderTitle + " " + cleanVersionLabel(loaderInfo);
     std::string defaultLang = "en";
 
     // Create necessary directories
-    createDirectory(PACKAGE_PATH);
-    createDirectory(LANG_PATH);
-    createDirectory(FLAGS_PATH);
-    createDirectory(NOTIFICATIONS_PATH);
-    createDirectory(THEMES_PATH);
-    createDirectory(WALLPAPERS_PATH);
-    createDirectory(SOUNDS_PATH);
+    ensureDirectoryLayout();
+    bootProfiler.mark("directories");
     
     bool settingsLoaded = false;
     bool needsUpdate = false;
@@ -7423,16 +7520,8 @@ void initializeSettingsAndDirectories() {
     if (!isFile(ULTRAHAND_CONFIG_INI_PATH)) {
         updateMenuCombos = true;
     } else {
-        // Always try to load INI data (will be empty if file doesn't exist)
+        // Parsed once; settingsStore adopts this copy for the rest of the session
         iniData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-        for (int i = 0; i < 3; i++) {
-            if (iniData.empty() || iniData[ULTRAHAND_PROJECT_NAME].empty()) {
-                svcSleepThread(100'000);
-                iniData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
-            } else {
-                break;
-            }
-        }
     }
 
 
@@ -7562,6 +7651,8 @@ void initializeSettingsAndDirectories() {
     if (needsUpdate) {
         saveIniFileData(ULTRAHAND_CONFIG_INI_PATH, iniData);
     }
+    settingsStore.adopt(iniData);
+    bootProfiler.mark("config.ini");
 
     if (useNotifications && !isFile(NOTIFICATIONS_FLAG_FILEPATH)) {
         FILE* file = std::fopen((NOTIFICATIONS_FLAG_FILEPATH).c_str(), "w");
@@ -7580,11 +7671,13 @@ void initializeSettingsAndDirectories() {
         if (defaultLang == "en")
             reinitializeLangVars();
     }
+    bootProfiler.mark("language");
     
     // Initialize theme
     initializeTheme();
     tsl::initializeThemeVars();
     copyTeslaKeyComboToUltrahand();
+    bootProfiler.mark("theme");
     
     // Set current menu based on settings
     static bool hasInitialized = false;
@@ -7644,7 +7737,7 @@ public:
             // Check if the package directory exists
             if (isFileOrDirectory(packageFilePath)) {
                 // GET PROPER PACKAGE TITLE AND VERSION (like main menu does)
-                PackageHeader packageHeader = getPackageHeaderFromIni(packageFilePath + PACKAGE_FILENAME);
+                PackageIndex::Info packageInfo = packageIndex.get(selectedPackage);
                 
                 // Load packages.ini to check for custom name/version
                 const std::map<std::string, std::map<std::string, std::string>> packagesIniData = getParsedDataFromIniFile(PACKAGES_INI_FILEPATH);
@@ -7665,14 +7758,14 @@ public:
                 
                 // Apply version cleaning if needed (same logic as main menu)
                 if (cleanVersionLabels) {
-                    packageHeader.version = cleanVersionLabel(packageHeader.version);
-                    removeQuotes(packageHeader.version);
+                    packageInfo.version = cleanVersionLabel(packageInfo.version);
+                    removeQuotes(packageInfo.version);
                 }
                 
                 // Determine final name and version (same logic as main menu)
                 assignedOverlayName = !customName.empty() ? customName : 
-                                     (packageHeader.title.empty() ? selectedPackage : packageHeader.title);
-                assignedOverlayVersion = !customVersion.empty() ? customVersion : packageHeader.version;
+                                     (packageInfo.title.empty() ? selectedPackage : packageInfo.title);
+                assignedOverlayVersion = !customVersion.empty() ? customVersion : packageInfo.version;
                 
                 // Handle boot package logic (similar to your KEY_A handler)
                 if (isFile(packageFilePath + BOOT_PACKAGE_FILENAME)) {
@@ -7704,17 +7797,10 @@ public:
                         // Load only the commands from the specific section (bootCommandName)
                         auto bootCommands = loadSpecificSectionFromIni(packageFilePath + BOOT_PACKAGE_FILENAME, "boot");
                     
+                        // Runs on the boot worker (commands before a barrier run now)
                         if (!bootCommands.empty()) {
-                            //bool resetCommandSuccess = false;
-                            //if (!commandSuccess.load(acquire)) resetCommandSuccess = true;
-                            const bool resetCommandSuccess = !commandSuccess.load(std::memory_order_acquire);
-                            
-                            interpretAndExecuteCommands(std::move(bootCommands), packageFilePath, "boot");
-                            resetPercentages();
-    
-                            if (resetCommandSuccess) {
-                                commandSuccess.store(false, release);
-                            }
+                            deferredBootCommands.add(std::move(bootCommands), packageFilePath, "boot");
+                            deferredBootCommands.start();
                         }
                     }
                 }
@@ -7767,21 +7853,30 @@ public:
                 deleteFileOrDirectoryByPattern(ult::NOTIFICATIONS_PATH + "*.notify");
             }
 
-            // Load and execute "initial_boot" commands if they exist
-            executeIniCommands(PACKAGE_PATH + BOOT_PACKAGE_FILENAME, "boot");
+            // Queue "boot" commands for the boot worker; only those before a barrier run here
+            std::vector<std::vector<std::string>> bootCommands;
+            if (isFileOrDirectory(PACKAGE_PATH + BOOT_PACKAGE_FILENAME))
+                bootCommands = loadSpecificSectionFromIni(PACKAGE_PATH + BOOT_PACKAGE_FILENAME, "boot");
+            const bool hasBootCommands = !bootCommands.empty();
+            if (hasBootCommands)
+                deferredBootCommands.add(std::move(bootCommands), PACKAGE_PATH, "boot", "  "+ULTRAHAND_HAS_STARTED);
             
             const bool disableFuseReload = (parseValueFromIniSection(FUSE_DATA_INI_PATH, FUSE_STR, "disable_reload") == TRUE_STR);
             if (!disableFuseReload)
                 deleteFileOrDirectory(FUSE_DATA_INI_PATH);
 
+            // Hand the rest to the boot worker now; the overlay usually stays hidden after boot
+            deferredBootCommands.start();
+
             // initialize expanded memory on boot
             //setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "memory_expansion", (loaderTitle == "nx-ovlloader+") ? TRUE_STR : FALSE_STR);
 
-            if (tsl::notification)
+            // With boot commands, the started notification follows their completion instead
+            if (!hasBootCommands && tsl::notification)
                 tsl::notification->show("  "+ULTRAHAND_HAS_STARTED);
             
         }
-        
+        bootProfiler.mark("services");
         
         //startInterpreterThread();
     }
@@ -7794,11 +7889,18 @@ public:
      * properly shut down services to avoid memory leaks.
      */
     virtual void exitServices() override {
+        deferredBootCommands.abort();
         closeInterpreterThread(); // just in case ¯\_(ツ)_/¯
+        settingsStore.shutdown();
+        packagePrefetchCache.clear();
+        pollingTableRefresher.stop();
 
         if (exitingUltrahand.load(acquire))
             executeIniCommands(PACKAGE_PATH + EXIT_PACKAGE_FILENAME, "exit");
 
+        // Placeholder lookups outside interpreter runs (tables, script views) are only saved here
+        hexOffsetIndex.flush();
+
         //cleanupCurl();
         //if (!ult::limitedMemory)
         //    socketExit();
@@ -7821,6 +7923,7 @@ public:
  * @return The application's exit code.
  */
 int main(int argc, char* argv[]) {
+    bootProfiler.begin();
     switchTencentVerToGlobalVer();
     for (u8 arg = 0; arg < argc; arg++) {
         if (argv[arg][0] != '-') continue;
@@ -34,6 +34,12 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <sys/stat.h>
+#include <malloc.h>
+#include <zlib.h>
+#include <minizip/unzip.h>
+#include <curl/curl.h>
+#include <byte_search.hpp>
 //#include <regex>
 //#include <sys/statvfs.h>
 
@@ -50,6 +56,8 @@ std::atomic<bool> refreshPage{false};
 std::atomic<bool> refreshPackage{false};
 std::atomic<bool> skipJumpReset{false};
 std::atomic<bool> interpreterLogging{false};
+std::atomic<int> batchPercentage{-1}; // overall progress of interpretAndExecuteBatch, -1 when idle
+std::recursive_mutex interpreterStateMutex; // held for each interpreter run and by off-thread placeholder resolution
 
 
 std::atomic<bool> goBackAfter{false};
@@ -1159,3130 +1167,7435 @@ std::tuple<Result, std::string, std::string, bool, bool> getOverlayInfo(const st
     };
 }
 
-void addHeader(auto& list, const std::string& headerText) {
-    list->addItem(new tsl::elm::CategoryHeader(headerText));
+// Length-prefixed binary record helpers shared by the small on-SD metadata caches
+template <typename T>
+static void appendCacheValue(std::string& buffer, T value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
 }
 
-void addBasicListItem(auto& list, const std::string& itemText, bool isMini = false) {
-    list->addItem(new tsl::elm::ListItem(itemText, "", isMini));
+static void appendCacheString(std::string& buffer, const std::string& value) {
+    appendCacheValue(buffer, static_cast<u16>(std::min<size_t>(value.size(), 0xFFFF)));
+    buffer.append(value, 0, std::min<size_t>(value.size(), 0xFFFF));
 }
 
-void addDummyListItem(auto& list, s32 index = -1) {
-    list->addItem(new tsl::elm::DummyListItem(), 0, index);
+template <typename T>
+static bool readCacheValue(const std::string& buffer, size_t& pos, T& value) {
+    if (buffer.size() - pos < sizeof(T))
+        return false;
+    std::memcpy(&value, buffer.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
 }
 
-void addSelectionIsEmptyDrawer(auto& list) {
-    addDummyListItem(list);
-    auto* warning = new tsl::elm::CustomDrawer([](tsl::gfx::Renderer* renderer, u16, u16, u16, u16){
-        // Icon
-        const size_t iconX = (448 - renderer->getTextDimensions("\uE150", false, 90).first) / 2;
-        renderer->drawString("\uE150", false, iconX, 324, 90, tsl::defaultTextColor);
-
-        // Text
-        const size_t textX = (448 - renderer->getTextDimensions(SELECTION_IS_EMPTY, false, 25).first) / 2;
-        renderer->drawString(SELECTION_IS_EMPTY, false, textX, 410, 25, tsl::defaultTextColor);
-    });
-    list->addItem(warning);
+static bool readCacheString(const std::string& buffer, size_t& pos, std::string& value) {
+    u16 length = 0;
+    if (!readCacheValue(buffer, pos, length) || buffer.size() - pos < length)
+        return false;
+    value.assign(buffer, pos, length);
+    pos += length;
+    return true;
 }
 
-// Helper function to wrap text into multiple lines based on a maximum width (character count)
-// Subsequent lines are indented by 4 spaces
-//std::vector<std::string> wrapText(const std::string& text, size_t maxWidth) {
-//    std::vector<std::string> wrappedLines;
-//    //std::string indent = "    ";  // 4 spaces for indentation
-//    std::string indent = "└ ";
-//    size_t currentPos = 0;
-//
-//    // First line (no indentation)
-//    wrappedLines.push_back(text.substr(currentPos, maxWidth));
-//    currentPos += maxWidth;
-//
-//    // Subsequent lines (indented by 4 spaces)
-//    while (currentPos < text.size()) {
-//        wrappedLines.push_back(indent + text.substr(currentPos, maxWidth));
-//        currentPos += maxWidth;
-//    }
-//
-//    return wrappedLines;
-//}
+static bool readCacheFile(const std::string& filePath, std::string& buffer) {
+    buffer.clear();
+    FILE* file = fopen(filePath.c_str(), "rb");
+    if (!file)
+        return false;
+    fseek(file, 0, SEEK_END);
+    const long fileSize = ftell(file);
+    if (fileSize > 0) {
+        buffer.resize(static_cast<size_t>(fileSize));
+        fseek(file, 0, SEEK_SET);
+        buffer.resize(fread(buffer.data(), 1, buffer.size(), file));
+    }
+    fclose(file);
+    return true;
+}
 
+// Writes the buffer to a temporary file and renames it over the cache, so a torn write
+// never replaces a good cache with a half one
+static bool writeCacheFile(const std::string& filePath, const std::string& buffer) {
+    const std::string tempPath = filePath + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file)
+        return false;
+    const bool written = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    if (fclose(file) == 0 && written) {
+        // FAT rename does not replace an existing file
+        remove(filePath.c_str());
+        if (rename(tempPath.c_str(), filePath.c_str()) == 0)
+            return true;
+    }
+    remove(tempPath.c_str());
+    return false;
+}
 
-bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::string& hexPath, const std::string& iniPath, const std::string& listString, const std::string& listPath, const std::string& jsonString, const std::string& jsonPath);
+/**
+ * @brief Persistent cache of getOverlayInfo results keyed by file size and mtime.
+ *
+ * Stored as a small binary file next to overlays.ini so a menu build only stats each
+ * overlay instead of parsing its NRO header, MOD0, NACP and ULTR trailer. Entries for
+ * overlays that were not looked up since load() are dropped on save().
+ */
+class OverlayInfoCache {
+public:
+    using OverlayInfo = std::tuple<Result, std::string, std::string, bool, bool>;
 
-std::string getFirstSectionText(const std::vector<std::vector<std::string>>& tableData, const std::string& packagePath) {
-    std::string message;
-    std::string listFileSourcePath;
-    std::string hexPath, iniPath, listString, listPath, jsonString, jsonPath;
-    
-    bool inEristaSection = false;
-    bool inMarikoSection = false;
-    std::vector<std::string> lines;
-    
-    std::vector<std::string> cmd;
-    for (const auto& commands : tableData) {
-        cmd = commands;  // Make a copy if you need to modify it
+    void load() {
+        entries.clear();
+        dirty = false;
 
-        if (cmd.empty()) {
-            continue;
-        }
+        std::string buffer;
+        if (!readCacheFile(cachePath(), buffer))
+            return;
 
-        const std::string& commandName = cmd[0];
+        size_t pos = 0;
+        u32 magic = 0, count = 0;
+        if (!readCacheValue(buffer, pos, magic) || magic != CACHE_MAGIC || !readCacheValue(buffer, pos, count))
+            return;
 
-        if (commandName == "erista:") {
-            inEristaSection = true;
-            inMarikoSection = false;
-            continue;
-        } else if (commandName == "mariko:") {
-            inEristaSection = false;
-            inMarikoSection = true;
-            continue;
+        for (u32 i = 0; i < count; ++i) {
+            std::string fileName;
+            Entry entry;
+            u8 flags = 0;
+            if (!readCacheString(buffer, pos, fileName) || !readCacheValue(buffer, pos, entry.size) ||
+                !readCacheValue(buffer, pos, entry.mtime) || !readCacheValue(buffer, pos, entry.result) ||
+                !readCacheValue(buffer, pos, flags) || !readCacheString(buffer, pos, entry.name) ||
+                !readCacheString(buffer, pos, entry.version)) {
+                entries.clear();
+                return;
+            }
+            entry.usingLibUltrahand = flags & FLAG_ULTR;
+            entry.usingLNY2 = flags & FLAG_LNY2;
+            entries.emplace(std::move(fileName), std::move(entry));
+        }
+    }
+
+    // Same result as getOverlayInfo(overlayDirectory + fileName); parses only on a miss
+    OverlayInfo get(const std::string& overlayDirectory, const std::string& fileName) {
+        const std::string filePath = overlayDirectory + fileName;
+        struct stat fileInfo;
+        if (stat(filePath.c_str(), &fileInfo) != 0)
+            return {ResultParseError, "", "", false, false};
+
+        auto it = entries.find(fileName);
+        if (it != entries.end() && it->second.size == static_cast<u64>(fileInfo.st_size) &&
+            it->second.mtime == static_cast<s64>(fileInfo.st_mtime)) {
+            it->second.seen = true;
+            const Entry& entry = it->second;
+            return {entry.result, entry.name, entry.version, entry.usingLibUltrahand, entry.usingLNY2};
+        }
+
+        OverlayInfo info = getOverlayInfo(filePath);
+        Entry& entry = entries[fileName];
+        entry.size = static_cast<u64>(fileInfo.st_size);
+        entry.mtime = static_cast<s64>(fileInfo.st_mtime);
+        std::tie(entry.result, entry.name, entry.version, entry.usingLibUltrahand, entry.usingLNY2) = info;
+        entry.seen = true;
+        dirty = true;
+        return info;
+    }
+
+    void save() {
+        for (auto it = entries.begin(); it != entries.end(); ) {
+            if (!it->second.seen) {
+                it = entries.erase(it);
+                dirty = true;
+            } else {
+                ++it;
+            }
         }
+        if (!dirty)
+            return;
 
-        if ((inEristaSection && !inMarikoSection && usingErista) ||
-            (!inEristaSection && inMarikoSection && usingMariko) ||
-            (!inEristaSection && !inMarikoSection)) {
-
-            // Apply placeholder replacements if necessary
-            applyPlaceholderReplacements(cmd, hexPath, iniPath, listString, listPath, jsonString, jsonPath);
+        std::string buffer;
+        appendCacheValue(buffer, CACHE_MAGIC);
+        appendCacheValue(buffer, static_cast<u32>(entries.size()));
+        for (const auto& [fileName, entry] : entries) {
+            appendCacheString(buffer, fileName);
+            appendCacheValue(buffer, entry.size);
+            appendCacheValue(buffer, entry.mtime);
+            appendCacheValue(buffer, entry.result);
+            appendCacheValue(buffer, static_cast<u8>((entry.usingLibUltrahand ? FLAG_ULTR : 0) | (entry.usingLNY2 ? FLAG_LNY2 : 0)));
+            appendCacheString(buffer, entry.name);
+            appendCacheString(buffer, entry.version);
+        }
+
+        if (writeCacheFile(cachePath(), buffer))
+            dirty = false;
+    }
+
+private:
+    static constexpr u32 CACHE_MAGIC = 0x3143564F; // "OVC1"
+    static constexpr u8 FLAG_ULTR = 0x01;
+    static constexpr u8 FLAG_LNY2 = 0x02;
+
+    struct Entry {
+        u64 size = 0;
+        s64 mtime = 0;
+        Result result = 0;
+        std::string name;
+        std::string version;
+        bool usingLibUltrahand = false;
+        bool usingLNY2 = false;
+        bool seen = false;
+    };
 
-            const size_t cmdSize = cmd.size();
+    std::unordered_map<std::string, Entry> entries;
+    bool dirty = false;
 
-            if (commandName == "list_file_source" && listFileSourcePath.empty()) {
-                listFileSourcePath = cmd[1];
-                preprocessPath(listFileSourcePath, packagePath);
+    static std::string cachePath() {
+        return OVERLAYS_INI_FILEPATH.substr(0, OVERLAYS_INI_FILEPATH.rfind('/') + 1) + "overlays_cache.bin";
+    }
+};
 
-                // Read lines from the file
-                lines = readListFromFile(listFileSourcePath);
+/**
+ * @brief Persistent index of package headers.
+ *
+ * Stored next to packages.ini and keyed by package directory name. An entry is reused while
+ * the package.ini size/mtime are unchanged, so building the packages menu stats each package
+ * instead of parsing every package.ini. Boot and exit packages are not indexed; callers check
+ * those files directly.
+ */
+class PackageIndex {
+public:
+    struct Info {
+        std::string title;
+        std::string version;
+        std::string creator;
+    };
 
-                // Return the first line if available
-                if (!lines.empty()) {
-                    return lines[0];
-                }
-            } else if (commandName == LIST_STR) {
-                if (cmdSize >= 2) {
-                    listString = cmd[1];
-                    removeQuotes(listString);
-                    // Process listString if needed
-                }
-            } else if (commandName == LIST_FILE_STR) {
-                if (cmdSize >= 2) {
-                    listPath = cmd[1];
-                    preprocessPath(listPath, packagePath);
-                    // Read from listPath if needed
-                }
-            } else if (commandName == JSON_STR) {
-                if (cmdSize >= 2) {
-                    jsonString = cmd[1];
-                    // Process jsonString if needed
-                }
-            } else if (commandName == JSON_FILE_STR) {
-                if (cmdSize >= 2) {
-                    jsonPath = cmd[1];
-                    preprocessPath(jsonPath, packagePath);
-                    // Read from jsonPath if needed
-                }
-            } else if (commandName == INI_FILE_STR) {
-                if (cmdSize >= 2) {
-                    iniPath = cmd[1];
-                    preprocessPath(iniPath, packagePath);
-                    // Read from iniPath if needed
-                }
-            } else if (commandName == HEX_FILE_STR) {
-                if (cmdSize >= 2) {
-                    hexPath = cmd[1];
-                    preprocessPath(hexPath, packagePath);
-                    // Read from hexPath if needed
-                }
+    // Revalidates every listed package and drops entries for packages that are gone
+    void refresh(const std::vector<std::string>& packageNames) {
+        ensureLoaded();
+        for (auto& [packageName, entry] : entries)
+            entry.seen = false;
+        for (const auto& packageName : packageNames)
+            validate(packageName);
+        for (auto it = entries.begin(); it != entries.end(); ) {
+            if (!it->second.seen) {
+                it = entries.erase(it);
+                dirty = true;
             } else {
-                // Default case: This is where sectionLines are populated in addTable
-                // Return cmd[0] as the first section text
-                return cmd[0];
+                ++it;
             }
         }
+        save();
     }
 
-    // If no section text is found, return an empty string or a default value
-    return "";  // Or return a default message if appropriate
-}
+    // Revalidated info for a single package; empty when the package directory is missing
+    Info get(const std::string& packageName) {
+        ensureLoaded();
+        const Entry* entry = validate(packageName);
+        save();
+        return entry ? entry->info : Info{};
+    }
 
+    // Info as of the last refresh()/get(), without touching the filesystem
+    const Info* find(const std::string& packageName) const {
+        auto it = entries.find(packageName);
+        return it != entries.end() ? &it->second.info : nullptr;
+    }
 
-void addGap(tsl::elm::List* list, s32 gapHeight) {
-    list->addItem(new tsl::elm::CustomDrawer(
-        [](tsl::gfx::Renderer* renderer, s32 x, s32 y, s32 w, s32 h) {
-            // Empty drawer - just creates space
-        }
-    ), gapHeight);
-}
+private:
+    static constexpr u32 INDEX_MAGIC = 0x32494B50; // "PKI2"
 
-std::vector<std::string> wrapText(
-    const std::string& text,
-    float maxWidth,
-    const std::string& wrappingMode,
-    bool useIndent,
-    const std::string& indent,
-    float indentWidth,
-    size_t fontSize
-) {
-    if (wrappingMode == "none" || (wrappingMode != "char" && wrappingMode != "word")) {
-        return { text };
+    struct Entry {
+        u64 iniSize = 0;
+        s64 iniMtime = 0;
+        Info info;
+        bool seen = false;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    bool loaded = false;
+    bool dirty = false;
+
+    static std::string indexPath() {
+        return PACKAGES_INI_FILEPATH.substr(0, PACKAGES_INI_FILEPATH.rfind('/') + 1) + "packages_index.bin";
     }
 
-    std::vector<std::string> wrappedLines;
+    void ensureLoaded() {
+        if (loaded)
+            return;
+        loaded = true;
 
-    bool firstLine = true;
-    std::string currentLine;
+        std::string buffer;
+        if (!readCacheFile(indexPath(), buffer))
+            return;
 
-    if (wrappingMode == "char") {
-        for (char c : text) {
-            const float currentMaxWidth = firstLine ? maxWidth : maxWidth - indentWidth;
+        size_t pos = 0;
+        u32 magic = 0, count = 0;
+        if (!readCacheValue(buffer, pos, magic) || magic != INDEX_MAGIC || !readCacheValue(buffer, pos, count))
+            return;
 
-            currentLine.push_back(c);
-            if (tsl::gfx::calculateStringWidth(currentLine, fontSize, false) > currentMaxWidth) {
-                // Remove last character and push line
-                const char lastChar = currentLine.back();
-                currentLine.pop_back();
-                if (!currentLine.empty()) {
-                    if (useIndent && !firstLine)
-                        wrappedLines.push_back(indent + currentLine);
-                    else
-                        wrappedLines.push_back(currentLine);
-                }
-                currentLine = lastChar;
-                firstLine = false;
+        for (u32 i = 0; i < count; ++i) {
+            std::string packageName;
+            Entry entry;
+            if (!readCacheString(buffer, pos, packageName) ||
+                !readCacheValue(buffer, pos, entry.iniSize) || !readCacheValue(buffer, pos, entry.iniMtime) ||
+                !readCacheString(buffer, pos, entry.info.title) ||
+                !readCacheString(buffer, pos, entry.info.version) || !readCacheString(buffer, pos, entry.info.creator)) {
+                entries.clear();
+                return;
             }
+            entries.emplace(std::move(packageName), std::move(entry));
         }
+    }
 
-        if (!currentLine.empty()) {
-            if (useIndent && !firstLine)
-                wrappedLines.push_back(indent + currentLine);
-            else
-                wrappedLines.push_back(currentLine);
+    const Entry* validate(const std::string& packageName) {
+        const std::string packageDirectory = PACKAGE_PATH + packageName + "/";
+        struct stat directoryInfo;
+        if (stat(packageDirectory.c_str(), &directoryInfo) != 0) {
+            if (entries.erase(packageName))
+                dirty = true;
+            return nullptr;
         }
-    } 
-    else {
-        // Word wrapping
-        StringStream stream(text);
-        std::string currentWord;
 
-        std::string testLine;
+        struct stat iniInfo;
+        const bool hasIni = stat((packageDirectory + PACKAGE_FILENAME).c_str(), &iniInfo) == 0;
+        const u64 iniSize = hasIni ? static_cast<u64>(iniInfo.st_size) : 0;
+        const s64 iniMtime = hasIni ? static_cast<s64>(iniInfo.st_mtime) : 0;
 
-        while (stream >> currentWord) {
-            const float currentMaxWidth = firstLine ? maxWidth : maxWidth - indentWidth;
+        auto [it, inserted] = entries.try_emplace(packageName);
+        Entry& entry = it->second;
+        entry.seen = true;
 
-            testLine = currentLine;
-            if (!testLine.empty()) testLine.push_back(' ');
-            testLine += currentWord;
+        if (!inserted && entry.iniSize == iniSize && entry.iniMtime == iniMtime)
+            return &entry;
 
-            if (tsl::gfx::calculateStringWidth(testLine, fontSize, false) > currentMaxWidth) {
-                if (!currentLine.empty()) {
-                    if (useIndent && !firstLine)
-                        wrappedLines.push_back(indent + currentLine);
-                    else
-                        wrappedLines.push_back(currentLine);
-                }
-                currentLine = std::move(currentWord);
-                firstLine = false;
-            } else {
-                currentLine.swap(testLine);
-            }
-        }
+        const PackageHeader packageHeader = getPackageHeaderFromIni(packageDirectory + PACKAGE_FILENAME);
+        entry.info.title = packageHeader.title;
+        entry.info.version = packageHeader.version;
+        entry.info.creator = packageHeader.creator;
+        entry.iniSize = iniSize;
+        entry.iniMtime = iniMtime;
+        dirty = true;
+        return &entry;
+    }
 
-        if (!currentLine.empty()) {
-            if (useIndent && !firstLine)
-                wrappedLines.push_back(indent + currentLine);
-            else
-                wrappedLines.push_back(currentLine);
+    void save() {
+        if (!dirty)
+            return;
+
+        std::string buffer;
+        appendCacheValue(buffer, INDEX_MAGIC);
+        appendCacheValue(buffer, static_cast<u32>(entries.size()));
+        for (const auto& [packageName, entry] : entries) {
+            appendCacheString(buffer, packageName);
+            appendCacheValue(buffer, entry.iniSize);
+            appendCacheValue(buffer, entry.iniMtime);
+            appendCacheString(buffer, entry.info.title);
+            appendCacheString(buffer, entry.info.version);
+            appendCacheString(buffer, entry.info.creator);
         }
+
+        if (writeCacheFile(indexPath(), buffer))
+            dirty = false;
     }
+};
 
-    return wrappedLines;
+static PackageIndex packageIndex;
+
+/**
+ * @brief Backing storage for the text of MenuEntry records.
+ *
+ * Every name/version/file name of a menu build is appended to one buffer and referenced
+ * by offset, so entries stay valid while the buffer grows.
+ */
+struct MenuEntryArena {
+    struct Span {
+        u32 offset = 0;
+        u32 length = 0;
+    };
+
+    std::string buffer;
+
+    Span append(std::string_view text) {
+        const Span span{static_cast<u32>(buffer.size()), static_cast<u32>(text.size())};
+        buffer.append(text);
+        return span;
+    }
+
+    std::string_view view(Span span) const {
+        return std::string_view(buffer).substr(span.offset, span.length);
+    }
+};
+
+static constexpr u8 MENU_ENTRY_LIBULTRAHAND = 0x01;
+static constexpr u8 MENU_ENTRY_SUPPORTS_AMS110 = 0x02;
+static constexpr u8 MENU_ENTRY_FORCE_AMS110 = 0x04;
+
+/**
+ * @brief Overlay or package row of the main menu, sorted starred first, then by priority,
+ * name, version and file name.
+ */
+struct MenuEntry {
+    int priority = 20;
+    bool starred = false;
+    u8 flags = 0;
+    MenuEntryArena::Span name;
+    MenuEntryArena::Span version;
+    MenuEntryArena::Span fileName;
+};
+
+// Compares two fields as if each were followed by ':', matching the old "name:version:file"
+// sort keys (so "Tool:" still sorts after "Tool2:" and before "ToolA:")
+inline int compareMenuKeyField(std::string_view a, std::string_view b) {
+    const size_t common = std::min(a.size(), b.size());
+    if (const int order = a.substr(0, common).compare(b.substr(0, common)))
+        return order;
+    const unsigned char nextA = a.size() > common ? static_cast<unsigned char>(a[common]) : ':';
+    const unsigned char nextB = b.size() > common ? static_cast<unsigned char>(b[common]) : ':';
+    if (nextA != nextB)
+        return nextA < nextB ? -1 : 1;
+    return a.compare(b);
 }
 
-// ─── Helper: flatten + placeholder + wrap & expand ─────────────────────────────
-static bool buildTableDrawerLines(
-    const std::vector<std::vector<std::string>>& tableData,
-    std::vector<std::string>&                    sectionLines,
-    std::vector<std::string>&                    infoLines,
-    const std::string&                           packagePath,
-    size_t                                       columnOffset,
-    size_t                                       startGap,
-    size_t                                       newlineGap,
-    const std::string&                           wrappingMode,
-    const std::string&                           alignment,
-    bool                                         useWrappedTextIndent,
-    std::vector<std::string>&                    outSection,
-    std::vector<std::string>&                    outInfo,
-    std::vector<s32>&                            outY,
-    std::vector<int>&                            outX
-) {
-    static constexpr size_t lineHeight = 16;
-    static constexpr size_t fontSize = 16;
-    const size_t xMax = tsl::cfg::FramebufferWidth - 95;
-    const std::string indent = "└ ";
-    const float indentWidth = tsl::gfx::calculateStringWidth(indent, fontSize, false);
+inline void sortMenuEntries(std::vector<MenuEntry>& entries, const MenuEntryArena& arena) {
+    std::sort(entries.begin(), entries.end(), [&arena](const MenuEntry& a, const MenuEntry& b) {
+        if (a.starred != b.starred)
+            return a.starred;
+        if (a.priority != b.priority)
+            return a.priority < b.priority;
+        if (const int order = compareMenuKeyField(arena.view(a.name), arena.view(b.name)))
+            return order < 0;
+        if (const int order = compareMenuKeyField(arena.view(a.version), arena.view(b.version)))
+            return order < 0;
+        return arena.view(a.fileName) < arena.view(b.fileName);
+    });
+}
 
-    outSection.clear();
-    //outSection.shrink_to_fit();
-    outInfo.clear();
-    //outInfo.shrink_to_fit();
-    outY.clear();
-    //outY.shrink_to_fit();
-    outX.clear();
-    //outX.shrink_to_fit();
+/**
+ * @brief Result of a background overlay or package scan handed to the main menu.
+ */
+struct MenuScan {
+    std::vector<MenuEntry> entries;
+    MenuEntryArena arena;
+    bool hasSources = false;
+    bool drawHiddenTab = false;
+
+    void clear() {
+        entries.clear();
+        entries.shrink_to_fit();
+        arena.buffer.clear();
+        arena.buffer.shrink_to_fit();
+        hasSources = false;
+        drawHiddenTab = false;
+    }
+};
 
-    size_t curY = startGap;
-    bool anyReplacementsMade = false;
+/**
+ * @brief Runs a single job on its own thread and publishes completion.
+ *
+ * Everything the job wrote is visible to the caller once finished() returns true.
+ * If the thread cannot be created the job runs inline inside start().
+ */
+class BackgroundJob {
+public:
+    BackgroundJob() = default;
+    BackgroundJob(const BackgroundJob&) = delete;
+    BackgroundJob& operator=(const BackgroundJob&) = delete;
 
-    // A small lambda to wrap and push lines with proper x,y and info alignment
-    auto processLines = [&](const std::vector<std::string>& lines, const std::vector<std::string>& infos) {
-        std::string infoText;
-        int xPos;
-        float infoWidth;
-        std::vector<std::string> wrappedLines;
-        for (size_t i = 0; i < lines.size(); ++i) {
-            const std::string& baseText = lines[i];
-            const std::string& infoTextRaw = (i < infos.size()) ? infos[i] : "";
-            infoText = (infoTextRaw.find(NULL_STR) != std::string::npos) ? UNAVAILABLE_SELECTION : infoTextRaw;
+    ~BackgroundJob() {
+        join();
+    }
 
-            // Wrap the base text according to wrappingMode and indent params
-            wrappedLines = wrapText(
-                baseText,
-                xMax - 8,
-                wrappingMode,
-                useWrappedTextIndent,
-                indent, indentWidth,
-                fontSize
-            );
+    void start(std::function<void()> newJob, size_t stackSize = JOB_STACK_SIZE, int priority = 0x2C) {
+        if (!tryStart(newJob, stackSize, priority))
+            newJob();
+    }
 
-            // Cache width of info text only once per base line, not per wrapped line
-            infoWidth = tsl::gfx::calculateStringWidth(infoText, fontSize, false);
+    // Like start(), but leaves the job unrun when no thread could be created
+    bool tryStart(std::function<void()> newJob, size_t stackSize = JOB_STACK_SIZE, int priority = 0x2C) {
+        join();
+        done.store(false, std::memory_order_release);
 
-            for (auto& line : wrappedLines) {
-                outSection.push_back(std::move(line));
-                line.shrink_to_fit();
-                outInfo.push_back(infoText);
+        threaded = threadCreate(&thread, entry, this, nullptr, stackSize, priority, -2) == 0;
+        if (!threaded) {
+            done.store(true, std::memory_order_release);
+            return false;
+        }
+        job = std::move(newJob);
+        threadStart(&thread);
+        return true;
+    }
 
-                xPos = 0;
-                if (alignment == LEFT_STR) {
-                    xPos = static_cast<int>(columnOffset);
-                } else if (alignment == RIGHT_STR) {
-                    xPos = static_cast<int>(xMax - infoWidth + (columnOffset - 160 + 1));
-                } else { // CENTER_STR
-                    xPos = static_cast<int>(columnOffset + (xMax - infoWidth) / 2);
-                }
+    bool finished() const {
+        return done.load(std::memory_order_acquire);
+    }
 
-                outX.push_back(xPos);
-                outY.push_back(static_cast<s32>(curY));
-                curY += lineHeight + newlineGap;
+    void join() {
+        if (!threaded)
+            return;
+        threadWaitForExit(&thread);
+        threadClose(&thread);
+        threaded = false;
+        job = nullptr;
+    }
+
+private:
+    static constexpr size_t JOB_STACK_SIZE = 0x10000;
+
+    Thread thread;
+    std::function<void()> job;
+    std::atomic<bool> done{true};
+    bool threaded = false;
+
+    static void entry(void* arg) {
+        auto* self = static_cast<BackgroundJob*>(arg);
+        self->job();
+        self->done.store(true, std::memory_order_release);
+    }
+};
+
+extern char* fake_heap_start;
+extern char* fake_heap_end;
+
+// Bytes the overlay heap can still hand out (newlib arena inside the fixed-size fake heap)
+inline size_t getFreeHeapBytes() {
+    const size_t heapSize = static_cast<size_t>(fake_heap_end - fake_heap_start);
+    const size_t usedBytes = static_cast<size_t>(mallinfo().uordblks);
+    return heapSize > usedBytes ? heapSize - usedBytes : 0;
+}
+
+/**
+ * @brief Speculatively parsed package.ini options and header.
+ *
+ * The main menu requests a package once focus has rested on it; the parse runs on a
+ * lowest-priority thread and PackageMenu/drawCommandsMenu take the result instead of
+ * reparsing. Entries are validated against the package.ini size and mtime, bounded per
+ * heap tier, and everything is dropped when the heap runs low. Limited memory disables it.
+ */
+class PackagePrefetchCache {
+public:
+    using Options = std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>>;
+
+    // Starts parsing packageIniPath in the background unless it is cached or already in flight
+    void request(const std::string& packageIniPath) {
+        if (ult::limitedMemory)
+            return;
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (getFreeHeapBytes() < 2 * byteBudget()) {
+            entries.clear();
+            return;
+        }
+        if (pendingPath == packageIniPath || findEntry(packageIniPath) != entries.end())
+            return;
+        if (!pendingPath.empty() && !job.finished())
+            return; // one speculative parse at a time
+
+        // Never parse inline here: prefetch() takes cacheMutex, which is held
+        pendingPath = packageIniPath;
+        if (!job.tryStart([this, packageIniPath]() { prefetch(packageIniPath); }, 0x10000, 0x3F))
+            pendingPath.clear();
+    }
+
+    // Cached header, or a fresh getPackageHeaderFromIni on a miss
+    PackageHeader loadHeader(const std::string& packageIniPath) {
+        waitIfPending(packageIniPath);
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto it = findValidEntry(packageIniPath);
+            if (it != entries.end())
+                return it->header;
+        }
+        return getPackageHeaderFromIni(packageIniPath);
+    }
+
+    // Cached options (consumed), or a fresh loadOptionsFromIni on a miss
+    Options loadOptions(const std::string& packageIniPath) {
+        waitIfPending(packageIniPath);
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto it = findValidEntry(packageIniPath);
+            if (it != entries.end()) {
+                Options options = std::move(it->options);
+                entries.erase(it);
+                return options;
             }
         }
+        return loadOptionsFromIni(packageIniPath);
+    }
+
+    void clear() {
+        job.join();
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        entries.clear();
+        pendingPath.clear();
+    }
+
+private:
+    struct Entry {
+        std::string packageIniPath;
+        u64 size = 0;
+        s64 mtime = 0;
+        size_t bytes = 0;
+        PackageHeader header;
+        Options options;
     };
 
-    if (!tableData.empty()) {
-        std::vector<std::string> baseSection;
-        std::vector<std::string> baseInfo;
-        std::vector<std::string> lines;
+    std::deque<Entry> entries; // oldest first
+    std::string pendingPath;
+    std::mutex cacheMutex;
+    BackgroundJob job;
 
-        std::string listFileSourcePath;
-        std::string hexPath, iniPath, listString, listPath, jsonString, jsonPath;
-        bool inErista = false, inMariko = false;
+    static size_t maxEntries() {
+        return ult::expandedMemory ? 4 : 2;
+    }
 
-        for (const auto& cmds : tableData) {
-            if (cmds.empty()) continue;
-            const auto& name = cmds[0];
+    static size_t byteBudget() {
+        return ult::expandedMemory ? 1024 * 1024 : 256 * 1024;
+    }
 
-            if (name == "erista:") {
-                inErista = true;
-                inMariko = false;
-                continue;
-            }
-            if (name == "mariko:") {
-                inErista = false;
-                inMariko = true;
-                continue;
+    static bool statIni(const std::string& packageIniPath, u64& size, s64& mtime) {
+        struct stat fileInfo;
+        if (stat(packageIniPath.c_str(), &fileInfo) != 0)
+            return false;
+        size = static_cast<u64>(fileInfo.st_size);
+        mtime = static_cast<s64>(fileInfo.st_mtime);
+        return true;
+    }
+
+    static size_t estimateBytes(const Options& options) {
+        size_t bytes = 0;
+        for (const auto& [optionName, commands] : options) {
+            bytes += optionName.capacity() + sizeof(options[0]);
+            for (const auto& command : commands) {
+                bytes += sizeof(command);
+                for (const auto& argument : command)
+                    bytes += argument.capacity() + sizeof(argument);
             }
+        }
+        return bytes;
+    }
 
-            if ((inErista && usingErista) || (inMariko && usingMariko) || (!inErista && !inMariko)) {
-                auto cmd = cmds;  // Copy for placeholder replacements
+    std::deque<Entry>::iterator findEntry(const std::string& packageIniPath) {
+        return std::find_if(entries.begin(), entries.end(),
+            [&packageIniPath](const Entry& entry) { return entry.packageIniPath == packageIniPath; });
+    }
 
-                // Track if any placeholder replacements were made
-                if (applyPlaceholderReplacements(
-                    cmd, hexPath, iniPath,
-                    listString, listPath,
-                    jsonString, jsonPath
-                )) {
-                    anyReplacementsMade = true;
-                }
+    // Drops the entry if package.ini changed since it was parsed
+    std::deque<Entry>::iterator findValidEntry(const std::string& packageIniPath) {
+        auto it = findEntry(packageIniPath);
+        if (it == entries.end())
+            return it;
+        u64 size = 0;
+        s64 mtime = 0;
+        if (!statIni(packageIniPath, size, mtime) || size != it->size || mtime != it->mtime) {
+            entries.erase(it);
+            return entries.end();
+        }
+        return it;
+    }
 
-                if (cmd[0] == "list_file_source" && cmd.size() >= 2 && listFileSourcePath.empty()) {
-                    listFileSourcePath = cmd[1];
-                    preprocessPath(listFileSourcePath, packagePath);
-                    lines = readListFromFile(listFileSourcePath);
-                    for (const auto& line : lines) {
-                        baseSection.push_back(line);
-                        baseInfo.push_back("");
-                    }
-                }
-                else if (cmd[0] == LIST_STR && cmd.size() >= 2) {
-                    listString = cmd[1];
-                    removeQuotes(listString);
-                }
-                else if (cmd[0] == LIST_FILE_STR && cmd.size() >= 2) {
-                    listPath = cmd[1];
-                    preprocessPath(listPath, packagePath);
-                }
-                else if (cmd[0] == JSON_STR && cmd.size() >= 2) {
-                    jsonString = cmd[1];
-                }
-                else if (cmd[0] == JSON_FILE_STR && cmd.size() >= 2) {
-                    jsonPath = cmd[1];
-                    preprocessPath(jsonPath, packagePath);
-                }
-                else if (cmd[0] == INI_FILE_STR && cmd.size() >= 2) {
-                    iniPath = cmd[1];
-                    preprocessPath(iniPath, packagePath);
-                }
-                else if (cmd[0] == HEX_FILE_STR && cmd.size() >= 2) {
-                    hexPath = cmd[1];
-                    preprocessPath(hexPath, packagePath);
-                }
-                else {
-                    baseSection.push_back(cmd[0]);
-                    baseInfo.push_back(cmd.size() > 2 ? cmd[2] : "");
-                }
-            }
+    void waitIfPending(const std::string& packageIniPath) {
+        bool pending;
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            pending = (pendingPath == packageIniPath);
         }
-        processLines(baseSection, baseInfo);
-    } else {
-        processLines(sectionLines, infoLines);
+        if (pending)
+            job.join(); // the same parse would run synchronously otherwise
     }
-    
-    // Return true if any placeholder replacements were made
-    return anyReplacementsMade;
-}
 
+    void prefetch(const std::string& packageIniPath) {
+        Entry entry;
+        entry.packageIniPath = packageIniPath;
+        if (statIni(packageIniPath, entry.size, entry.mtime)) {
+            entry.header = getPackageHeaderFromIni(packageIniPath);
+            entry.options = loadOptionsFromIni(packageIniPath);
+            entry.bytes = estimateBytes(entry.options);
+        }
 
-// Helper function moved outside - no lambda creation overhead
-static tsl::Color getRawColor(const std::string& c, tsl::Color defaultColor) {
-    // Check most common/special case first
-    if (c == DEFAULT_STR) return defaultColor;
-    
-    // Quick length check to eliminate impossible matches
-    const size_t len = c.length();
-    
-    // Group by length to reduce comparisons
-    switch (len) {
-        case 4:
-            if (c == "text") return tsl::defaultTextColor;
-            if (c == "info") return tsl::infoTextColor;
-            break;
-            
-        case 6:
-            if (c == "header") return tsl::headerTextColor;
-            break;
-            
-        case 7:
-            if (c[0] == 'w' && c == "warning") return tsl::warningTextColor;
-            if (c[0] == 's' && c == "section") return tsl::sectionTextColor;
-            if (c[0] == 'b' && c == "bad_ram") return tsl::badRamTextColor;
-            break;
-            
-        case 8:
-            if (c == "on_value") return tsl::onTextColor;
-            break;
-            
-        case 9:
-            if (c == "off_value") return tsl::offTextColor;
-            break;
-            
-        case 11:
-            if (c[0] == 'h' && c == "healthy_ram") return tsl::healthyRamTextColor;
-            if (c[0] == 'n' && c == "neutral_ram") return tsl::neutralRamTextColor;
-            break;
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        pendingPath.clear();
+        if (entry.options.empty() || entry.bytes > byteBudget() || getFreeHeapBytes() < byteBudget()) {
+            if (getFreeHeapBytes() < byteBudget())
+                entries.clear();
+            return;
+        }
+
+        size_t totalBytes = entry.bytes;
+        for (const auto& cached : entries)
+            totalBytes += cached.bytes;
+        while (!entries.empty() && (entries.size() >= maxEntries() || totalBytes > byteBudget())) {
+            totalBytes -= entries.front().bytes;
+            entries.pop_front();
+        }
+        entries.push_back(std::move(entry));
     }
-    
-    return tsl::RGB888(c);
-}
+};
 
-void drawTable(
-    tsl::elm::List*      list,
-    const std::vector<std::vector<std::string>>& tableData,
-    std::vector<std::string>&             sectionLines,
-    std::vector<std::string>&             infoLines,
-    size_t columnOffset             = 164,
-    size_t startGap                 = 20,
-    size_t endGap                   = 9,
-    size_t newlineGap               = 4,
-    const std::string& tableSectionTextColor       = DEFAULT_STR,
-    const std::string& tableInfoTextColor          = DEFAULT_STR,
-    const std::string& tableInfoTextHighlightColor = DEFAULT_STR,
-    const std::string& alignment                   = LEFT_STR,
-    bool hideTableBackground        = false,
-    bool useHeaderIndent            = false,
-    bool isPolling                  = false,
-    bool isScrollable               = true,
-    const std::string& wrappingMode               = "none",
-    bool useWrappedTextIndent        = false,
-    const std::string& packagePath          = ""
-) {
-    // Prebuild initial buffers
-    std::vector<std::string> cacheExpSec, cacheExpInfo;
-    std::vector<s32>         cacheYOff;
-    std::vector<s32>         cacheXOff;
+static PackagePrefetchCache packagePrefetchCache;
 
-    const bool usingPlaceholders = buildTableDrawerLines(
-        tableData, sectionLines, infoLines, packagePath,
-        columnOffset, startGap, newlineGap,
-        wrappingMode, alignment, useWrappedTextIndent,
-        cacheExpSec, cacheExpInfo, cacheYOff, cacheXOff
-    ) && isPolling;
+/**
+ * @brief Per-phase startup timings, from main() until the first frame.
+ *
+ * Phases are recorded as tick deltas into a fixed array, so marking is cheap enough to leave
+ * in release builds. The breakdown is written to the log once the first frame is handled,
+ * when logging is compiled in and BOOT_PROFILE.flag exists in the flags directory.
+ */
+class BootProfiler {
+public:
+    void begin() {
+        startTick = lastTick = armGetSystemTick();
+        phaseCount = 0;
+        active = true;
+    }
 
-    // Resolve colors once outside the render loop
-    const auto secRaw = getRawColor(tableSectionTextColor, tsl::sectionTextColor);
-    const auto infoRaw = getRawColor(tableInfoTextColor, tsl::infoTextColor);
-    const auto hiliteRaw = getRawColor(tableInfoTextHighlightColor, tsl::infoTextColor);
-    
-    // Pre-calculate color comparison
-    const bool sameCol = (tableInfoTextColor == tableInfoTextHighlightColor);
+    void mark(const char* phase) {
+        if (!active || phaseCount >= MAX_PHASES)
+            return;
+        const u64 tick = armGetSystemTick();
+        phases[phaseCount++] = Phase{phase, tick - lastTick};
+        lastTick = tick;
+    }
 
-    // Use nanoseconds for high-performance timing
-    auto lastUpdateNS = std::make_shared<u64>(armTicksToNs(armGetSystemTick()));
-    static constexpr u64 ONE_SECOND_NS = 1000000000ULL;
+    void finish() {
+        if (!active)
+            return;
+        mark("first frame");
+        active = false;
 
-    static const std::vector<std::string> specialCharacters =  {""};
-    
-    list->addItem(new tsl::elm::TableDrawer(
-        [=](tsl::gfx::Renderer* renderer, s32 x, s32 y, s32 w, s32 h) mutable {
+        #if USING_LOGGING_DIRECTIVE
+        if (!isFile(FLAGS_PATH + "BOOT_PROFILE.flag"))
+            return;
+        for (size_t i = 0; i < phaseCount; ++i)
+            logMessage("Boot phase " + std::string(phases[i].name) + ": " + ult::to_string(static_cast<int>(armTicksToNs(phases[i].ticks) / 1000)) + " us");
+        logMessage("Boot total: " + ult::to_string(static_cast<int>(armTicksToNs(lastTick - startTick) / 1000)) + " us");
+        #endif
+    }
 
-            if (usingPlaceholders) {
-                const u64 currentNS = armTicksToNs(armGetSystemTick());
-                
-                if ((currentNS - *lastUpdateNS) >= ONE_SECOND_NS) {
-                    buildTableDrawerLines(
-                        tableData, sectionLines, infoLines, packagePath,
-                        columnOffset, startGap, newlineGap,
-                        wrappingMode, alignment, useWrappedTextIndent,
-                        cacheExpSec, cacheExpInfo, cacheYOff, cacheXOff
-                    );
-                    *lastUpdateNS = currentNS;
-                }
-            }
+private:
+    static constexpr size_t MAX_PHASES = 16;
 
-            // Minimal branching, maximum cache efficiency
-            if (useHeaderIndent) {
-                renderer->drawRect(x-2, y, 4, 22, (tsl::headerSeparatorColor));
-            }
+    struct Phase {
+        const char* name;
+        u64 ticks;
+    };
 
-            // Convert to renderer colors once per frame
-            const auto secColor = (secRaw);
-            const auto infoColor = (infoRaw);
-            const auto dividerColor = (tsl::textSeparatorColor);
-            
-            const size_t count = cacheExpSec.size();
-            const s32 baseX = x + 12;
-            
-            if (sameCol) {
-                // Fastest path: same colors, minimal function calls
-                for (size_t i = 0; i < count; ++i) {
-                    const s32 yPos = y + cacheYOff[i];
-                    renderer->drawStringWithColoredSections(cacheExpSec[i], false, specialCharacters, baseX, yPos, 16, secColor, dividerColor);
-                    renderer->drawStringWithColoredSections(cacheExpInfo[i], false, specialCharacters, x + cacheXOff[i], yPos, 16, infoColor, dividerColor);
-                }
-            } else {
-                // Different colors path
-                const auto hiliteColor = hiliteRaw;
-                
-                for (size_t i = 0; i < count; ++i) {
-                    const s32 yPos = y + cacheYOff[i];
-                    renderer->drawStringWithColoredSections(cacheExpSec[i], false, specialCharacters, baseX, yPos, 16, secColor, dividerColor);
-                    renderer->drawStringWithHighlight(
-                        cacheExpInfo[i], false, x + cacheXOff[i], yPos, 16,
-                        infoColor, hiliteColor
-                    );
-                }
-            }
-        },
-        hideTableBackground,
-        endGap,
-        isScrollable
-    ),
-    static_cast<u32>(
-        16 * cacheExpSec.size()
-        + newlineGap * (cacheExpSec.empty() ? 0 : cacheExpSec.size() - 1)
-        + endGap
-    ));
-}
+    Phase phases[MAX_PHASES];
+    size_t phaseCount = 0;
+    u64 startTick = 0;
+    u64 lastTick = 0;
+    bool active = false;
+};
 
-// ─── addTable simply forwards through ───────────────────────────────────────────
-void addTable(
-    tsl::elm::List*       list,
-    const std::vector<std::vector<std::string>>& tableData,
-    const std::string&                     packagePath,
-    const size_t&                          columnOffset                = 164,
-    const size_t&                          tableStartGap               = 20,
-    const size_t&                          tableEndGap                 = 9,
-    const size_t&                          tableSpacing                = 0,
-    const std::string&                     tableSectionTextColor       = DEFAULT_STR,
-    const std::string&                     tableInfoTextColor          = DEFAULT_STR,
-    const std::string&                     tableInfoTextHighlightColor = DEFAULT_STR,
-    const std::string&                     tableAlignment              = RIGHT_STR,
-    const bool&                            hideTableBackground         = false,
-    const bool&                            useHeaderIndent             = false,
-    const bool&                            isPolling                   = false,
-    const bool&                            isScrollable                = true,
-    const std::string&                     wrappingMode                = "none",
-    const bool&                            useWrappedTextIndent        = false
-) {
-    std::vector<std::string> sectionLines, infoLines;
-    drawTable(
-        list, tableData,
-        sectionLines, infoLines,
-        columnOffset, tableStartGap, tableEndGap, tableSpacing,
-        tableSectionTextColor, tableInfoTextColor, tableInfoTextHighlightColor,
-        tableAlignment, hideTableBackground, useHeaderIndent,
-        isPolling, isScrollable, wrappingMode, useWrappedTextIndent,
-        packagePath
-    );
-}
+static BootProfiler bootProfiler;
 
+/**
+ * @brief Keys of the [ultrahand] section of config.ini managed by SettingsStore.
+ */
+enum class Setting : u8 {
+    HideUserGuide, HideHidden, HideDelete, HideUnsupported,
+    CleanVersionLabels, HideOverlayVersions, HidePackageVersions,
+    DynamicLogo, SelectionBG, SelectionText, SelectionValue,
+    LibultrahandTitles, LibultrahandVersions, PackageTitles, PackageVersions,
+    MemoryExpansion, LaunchCombos, Notifications, SoundEffects, HapticFeedback,
+    PageSwap, SwipeToOpen, RightAlignment, OpaqueScreenshots,
+    HideClock, HideBattery, HidePCBTemp, HideSOCTemp,
+    DynamicWidgetColors, HideWidgetBackdrop, CenterWidgetAlignment, ExtendedWidgetBackdrop,
+    InOverlay, ToPackages, InHiddenOverlay, InHiddenPackage,
+    DefaultLang, KeyCombo, DatetimeFormat, CurrentTheme, CurrentWallpaper,
+    Count
+};
 
-void addHelpInfo(tsl::elm::List* list) {
-    // Add a section break with small text to indicate the "Commands" section
-    addHeader(list, USER_GUIDE);
+enum class SettingType : u8 { Bool, Enum, String };
 
-    // Adjust the horizontal offset as needed
-    const int xOffset = ult::stoi(USERGUIDE_OFFSET);
+struct SettingDescriptor {
+    Setting setting;
+    const char* key;
+    SettingType type;
+    const char* choices; // '|' separated values accepted by Enum settings
+};
 
-    // Define the section lines and info lines directly
-    std::vector<std::string> sectionLines = {
-        SETTINGS_MENU,
-        SCRIPT_OVERLAY,
-        STAR_FAVORITE,
-        APP_SETTINGS
-    };
+inline constexpr SettingDescriptor SETTING_DESCRIPTORS[] = {
+    {Setting::HideUserGuide,          "hide_user_guide",          SettingType::Bool,   nullptr},
+    {Setting::HideHidden,             "hide_hidden",              SettingType::Bool,   nullptr},
+    {Setting::HideDelete,             "hide_delete",              SettingType::Bool,   nullptr},
+    {Setting::HideUnsupported,        "hide_unsupported",         SettingType::Bool,   nullptr},
+    {Setting::CleanVersionLabels,     "clean_version_labels",     SettingType::Bool,   nullptr},
+    {Setting::HideOverlayVersions,    "hide_overlay_versions",    SettingType::Bool,   nullptr},
+    {Setting::HidePackageVersions,    "hide_package_versions",    SettingType::Bool,   nullptr},
+    {Setting::DynamicLogo,            "dynamic_logo",             SettingType::Bool,   nullptr},
+    {Setting::SelectionBG,            "selection_bg",             SettingType::Bool,   nullptr},
+    {Setting::SelectionText,          "selection_text",           SettingType::Bool,   nullptr},
+    {Setting::SelectionValue,         "selection_value",          SettingType::Bool,   nullptr},
+    {Setting::LibultrahandTitles,     "libultrahand_titles",      SettingType::Bool,   nullptr},
+    {Setting::LibultrahandVersions,   "libultrahand_versions",    SettingType::Bool,   nullptr},
+    {Setting::PackageTitles,          "package_titles",           SettingType::Bool,   nullptr},
+    {Setting::PackageVersions,        "package_versions",         SettingType::Bool,   nullptr},
+    {Setting::MemoryExpansion,        "memory_expansion",         SettingType::Bool,   nullptr},
+    {Setting::LaunchCombos,           "launch_combos",            SettingType::Bool,   nullptr},
+    {Setting::Notifications,          "notifications",            SettingType::Bool,   nullptr},
+    {Setting::SoundEffects,           "sound_effects",            SettingType::Bool,   nullptr},
+    {Setting::HapticFeedback,         "haptic_feedback",          SettingType::Bool,   nullptr},
+    {Setting::PageSwap,               "page_swap",                SettingType::Bool,   nullptr},
+    {Setting::SwipeToOpen,            "swipe_to_open",            SettingType::Bool,   nullptr},
+    {Setting::RightAlignment,         "right_alignment",          SettingType::Bool,   nullptr},
+    {Setting::OpaqueScreenshots,      "opaque_screenshots",       SettingType::Bool,   nullptr},
+    {Setting::HideClock,              "hide_clock",               SettingType::Bool,   nullptr},
+    {Setting::HideBattery,            "hide_battery",             SettingType::Bool,   nullptr},
+    {Setting::HidePCBTemp,            "hide_pcb_temp",            SettingType::Bool,   nullptr},
+    {Setting::HideSOCTemp,            "hide_soc_temp",            SettingType::Bool,   nullptr},
+    {Setting::DynamicWidgetColors,    "dynamic_widget_colors",    SettingType::Bool,   nullptr},
+    {Setting::HideWidgetBackdrop,     "hide_widget_backdrop",     SettingType::Bool,   nullptr},
+    {Setting::CenterWidgetAlignment,  "center_widget_alignment",  SettingType::Bool,   nullptr},
+    {Setting::ExtendedWidgetBackdrop, "extended_widget_backdrop", SettingType::Bool,   nullptr},
+    {Setting::InOverlay,              "in_overlay",               SettingType::Bool,   nullptr},
+    {Setting::ToPackages,             "to_packages",              SettingType::Bool,   nullptr},
+    {Setting::InHiddenOverlay,        "in_hidden_overlay",        SettingType::Bool,   nullptr},
+    {Setting::InHiddenPackage,        "in_hidden_package",        SettingType::Bool,   nullptr},
+    {Setting::DefaultLang,            "default_lang",             SettingType::Enum,   "en|es|fr|de|ja|ko|it|nl|pt|ru|uk|pl|zh-cn|zh-tw"},
+    {Setting::KeyCombo,               "key_combo",                SettingType::String, nullptr},
+    {Setting::DatetimeFormat,         "datetime_format",          SettingType::String, nullptr},
+    {Setting::CurrentTheme,           "current_theme",            SettingType::String, nullptr},
+    {Setting::CurrentWallpaper,       "current_wallpaper",        SettingType::String, nullptr},
+};
 
-    std::vector<std::string> infoLines = {
-        "\uE0B5 (" + ON_MAIN_MENU + ")",
-        "\uE0B6 (" + ON_A_COMMAND + ")",
-        "\uE0E2 (" + ON_OVERLAY_PACKAGE + ")",
-        "\uE0E3 (" + ON_OVERLAY_PACKAGE + ")"
-    };
+constexpr bool settingDescriptorsMatchKeys() {
+    if (std::size(SETTING_DESCRIPTORS) != static_cast<size_t>(Setting::Count))
+        return false;
+    for (size_t i = 0; i < std::size(SETTING_DESCRIPTORS); ++i)
+        if (static_cast<size_t>(SETTING_DESCRIPTORS[i].setting) != i)
+            return false;
+    return true;
+}
+static_assert(settingDescriptorsMatchKeys(), "SETTING_DESCRIPTORS must list every Setting in order");
 
-    std::vector<std::vector<std::string>> dummyTableData;
+constexpr const SettingDescriptor& settingDescriptor(Setting setting) {
+    return SETTING_DESCRIPTORS[static_cast<size_t>(setting)];
+}
 
-    // Draw the table with the defined lines
-    drawTable(list, dummyTableData, sectionLines, infoLines, xOffset, 20, 9, 4);
-    //drawTable(list, sectionLines, infoLines, xOffset, 19, 12, 4, DEFAULT_STR, DEFAULT_STR, LEFT_STR, false, false, true, "none", false);
+// Looks a config.ini key up in the registry; Setting::Count when it is not registered
+constexpr Setting findSetting(std::string_view key) {
+    for (const auto& descriptor : SETTING_DESCRIPTORS)
+        if (key == descriptor.key)
+            return descriptor.setting;
+    return Setting::Count;
 }
 
+/**
+ * @brief Typed access to the [ultrahand] section of config.ini with deferred writes.
+ *
+ * Reads come from one in-memory document that is re-parsed only when config.ini changes on
+ * disk. Writes update the document right away and are queued; a worker writes them out
+ * FLUSH_DELAY_NS after the last change, so toggling several settings costs one file rewrite.
+ * Queued values are merged into a fresh parse of the file, which keeps keys written by other
+ * code intact. flush() writes immediately and shutdown() is called from exitServices.
+ */
+class SettingsStore {
+public:
+    using IniData = std::map<std::string, std::map<std::string, std::string>>;
 
+    // Takes config.ini as just parsed or written at startup
+    void adopt(const IniData& data) {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        document = data;
+        for (const auto& [key, value] : pending)
+            document[ULTRAHAND_PROJECT_NAME][key] = value;
+        recordFileState();
+    }
 
-void addPackageInfo(tsl::elm::List* list, auto& packageHeader, std::string type = PACKAGE_STR) {
-    // Add a section break with small text to indicate the "Commands" section
-    addHeader(list, (type == PACKAGE_STR ? PACKAGE_INFO : OVERLAY_INFO));
+    // Copy of the whole [ultrahand] section, for menus that read many keys at once
+    std::map<std::string, std::string> section() {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        syncDocument();
+        const auto sectionIt = document.find(ULTRAHAND_PROJECT_NAME);
+        return sectionIt != document.end() ? sectionIt->second : std::map<std::string, std::string>();
+    }
 
-    const int maxLineLength = 28;  // Adjust the maximum line length as needed
-    const int xOffset = 120;    // Adjust the horizontal offset as needed
-    //int numEntries = 0;   // Count of the number of entries
+    std::string getString(Setting setting) {
+        if (setting >= Setting::Count)
+            return "";
+        std::lock_guard<std::mutex> lock(storeMutex);
+        syncDocument();
+        const auto sectionIt = document.find(ULTRAHAND_PROJECT_NAME);
+        if (sectionIt == document.end())
+            return "";
+        const auto valueIt = sectionIt->second.find(settingDescriptor(setting).key);
+        return valueIt != sectionIt->second.end() ? valueIt->second : "";
+    }
 
-    std::vector<std::string> sectionLines;
-    std::vector<std::string> infoLines;
+    bool getBool(Setting setting, bool defaultValue = false) {
+        const std::string value = getString(setting);
+        return value.empty() ? defaultValue : (value == TRUE_STR);
+    }
 
-    // Helper function to add text with wrapping
-    auto addWrappedText = [&](const std::string& header, const std::string& text) {
-        sectionLines.push_back(header);
-        const std::string::size_type aboutHeaderLength = header.length();
-        
-        size_t startPos = 0;
-        size_t spacePos = 0;
+    void setBool(Setting setting, bool value) {
+        setString(setting, value ? TRUE_STR : FALSE_STR);
+    }
 
-        size_t endPos;
-        std::string line;
+    bool setString(Setting setting, const std::string& value) {
+        if (setting >= Setting::Count)
+            return false;
+        const SettingDescriptor& descriptor = settingDescriptor(setting);
+        if (descriptor.type == SettingType::Bool && value != TRUE_STR && value != FALSE_STR)
+            return false;
+        if (descriptor.type == SettingType::Enum && !isChoice(descriptor.choices, value))
+            return false;
 
-        while (startPos < text.length()) {
-            endPos = std::min(startPos + maxLineLength, text.length());
-            line = text.substr(startPos, endPos - startPos);
-            
-            // Check if the current line ends with a space; if not, find the last space in the line
-            if (endPos < text.length() && text[endPos] != ' ') {
-                spacePos = line.find_last_of(' ');
-                if (spacePos != std::string::npos) {
-                    endPos = startPos + spacePos;
-                    line = text.substr(startPos, endPos - startPos);
-                }
+        std::lock_guard<std::mutex> lock(storeMutex);
+        syncDocument();
+        std::string& current = document[ULTRAHAND_PROJECT_NAME][descriptor.key];
+        if (current == value)
+            return true;
+        current = value;
+        pending[descriptor.key] = value;
+        lastChangeNs = armTicksToNs(armGetSystemTick());
+
+        if (!flushScheduled) {
+            flushScheduled = true;
+            // The previous worker has already given up the lock, so joining it here cannot block on us
+            if (!worker.tryStart([this]() { run(); }, 0x10000, 0x3F)) {
+                flushScheduled = false;
+                writePending();
             }
-
-            infoLines.push_back(line);
-            startPos = endPos + 1;
-            //numEntries++;
-
-            // Add corresponding newline to the packageSectionString
-            if (startPos < text.length())
-                sectionLines.push_back(std::string(aboutHeaderLength, ' '));
         }
-    };
+        return true;
+    }
 
-    // Adding package header info
-    if (!packageHeader.title.empty()) {
-        sectionLines.push_back(_TITLE);
-        infoLines.push_back(packageHeader.title);
-        //numEntries++;
+    void flush() {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        writePending();
     }
 
-    if (!packageHeader.version.empty()) {
-        sectionLines.push_back(_VERSION);
-        infoLines.push_back(packageHeader.version);
-        //numEntries++;
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(storeMutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        worker.join();
+
+        std::lock_guard<std::mutex> lock(storeMutex);
+        writePending();
+        stopping = false;
+    }
+
+private:
+    static constexpr u64 FLUSH_DELAY_NS = 1000000000ULL;
+
+    IniData document;
+    std::map<std::string, std::string> pending;
+    std::mutex storeMutex;
+    std::condition_variable wakeCondition;
+    BackgroundJob worker;
+    u64 lastChangeNs = 0;
+    u64 fileSize = 0;
+    s64 fileMtime = 0;
+    bool loaded = false;
+    bool flushScheduled = false;
+    bool stopping = false;
+
+    static bool isChoice(const char* choices, const std::string& value) {
+        std::string_view remaining(choices);
+        while (!remaining.empty()) {
+            const size_t separator = remaining.find('|');
+            if (remaining.substr(0, separator) == value)
+                return true;
+            if (separator == std::string_view::npos)
+                break;
+            remaining.remove_prefix(separator + 1);
+        }
+        return false;
     }
 
-    if (!packageHeader.creator.empty()) {
-        //sectionLines.push_back(CREATOR);
-        //infoLines.push_back(packageHeader.creator);
-        //numEntries++;
-        addWrappedText(_CREATOR, packageHeader.creator);
+    // Caller holds storeMutex
+    void recordFileState() {
+        struct stat fileInfo;
+        const bool exists = stat(ULTRAHAND_CONFIG_INI_PATH.c_str(), &fileInfo) == 0;
+        fileSize = exists ? static_cast<u64>(fileInfo.st_size) : 0;
+        fileMtime = exists ? static_cast<s64>(fileInfo.st_mtime) : 0;
+        loaded = true;
     }
 
-    if (!packageHeader.about.empty()) {
-        addWrappedText(_ABOUT, packageHeader.about);
+    // Caller holds storeMutex; re-parses config.ini if it changed since it was last read or written
+    void syncDocument() {
+        if (loaded) {
+            struct stat fileInfo;
+            const bool exists = stat(ULTRAHAND_CONFIG_INI_PATH.c_str(), &fileInfo) == 0;
+            if ((exists ? static_cast<u64>(fileInfo.st_size) : 0) == fileSize &&
+                (exists ? static_cast<s64>(fileInfo.st_mtime) : 0) == fileMtime)
+                return;
+        }
+        document = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
+        for (const auto& [key, value] : pending)
+            document[ULTRAHAND_PROJECT_NAME][key] = value;
+        recordFileState();
     }
 
-    if (!packageHeader.credits.empty()) {
-        addWrappedText(_CREDITS, packageHeader.credits);
+    // Caller holds storeMutex
+    void writePending() {
+        if (pending.empty())
+            return;
+        IniData fileData = getParsedDataFromIniFile(ULTRAHAND_CONFIG_INI_PATH);
+        auto& section = fileData[ULTRAHAND_PROJECT_NAME];
+        for (auto& [key, value] : pending)
+            section[key] = std::move(value);
+        pending.clear();
+        saveIniFileData(ULTRAHAND_CONFIG_INI_PATH, fileData);
+        document = std::move(fileData);
+        recordFileState();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(storeMutex);
+        while (!stopping && !pending.empty()) {
+            const u64 currentNs = armTicksToNs(armGetSystemTick());
+            const u64 dueNs = lastChangeNs + FLUSH_DELAY_NS;
+            if (currentNs < dueNs) {
+                wakeCondition.wait_for(lock, std::chrono::nanoseconds(dueNs - currentNs));
+                continue;
+            }
+            writePending();
+        }
+        flushScheduled = false;
     }
+};
 
-    std::vector<std::vector<std::string>> dummyTableData;
+static SettingsStore settingsStore;
 
-    // Drawing the table with section lines and info lines
-    //drawTable(list, sectionLines, infoLines, xOffset, 20, 12, 3);
-    drawTable(list, dummyTableData, sectionLines, infoLines, xOffset, 20, 9, 3, DEFAULT_STR, DEFAULT_STR, DEFAULT_STR, LEFT_STR, false, false, true);
+void addHeader(auto& list, const std::string& headerText) {
+    list->addItem(new tsl::elm::CategoryHeader(headerText));
 }
 
+void addBasicListItem(auto& list, const std::string& itemText, bool isMini = false) {
+    list->addItem(new tsl::elm::ListItem(itemText, "", isMini));
+}
 
+void addDummyListItem(auto& list, s32 index = -1) {
+    list->addItem(new tsl::elm::DummyListItem(), 0, index);
+}
 
+void addSelectionIsEmptyDrawer(auto& list) {
+    addDummyListItem(list);
+    auto* warning = new tsl::elm::CustomDrawer([](tsl::gfx::Renderer* renderer, u16, u16, u16, u16){
+        // Icon
+        const size_t iconX = (448 - renderer->getTextDimensions("\uE150", false, 90).first) / 2;
+        renderer->drawString("\uE150", false, iconX, 324, 90, tsl::defaultTextColor);
 
+        // Text
+        const size_t textX = (448 - renderer->getTextDimensions(SELECTION_IS_EMPTY, false, 25).first) / 2;
+        renderer->drawString(SELECTION_IS_EMPTY, false, textX, 410, 25, tsl::defaultTextColor);
+    });
+    list->addItem(warning);
+}
 
-/**
- * @brief Ultrahand-Overlay Protected Folders
- *
- * This block of code defines two vectors containing paths to protected folders used in the
- * Ultrahand-Overlay project. These folders are designated as protected to prevent certain
- * operations that may pose security risks.
- *
- * The two vectors include:
- *
- * - `protectedFolders`: Paths to standard protected folders.
- * - `ultraProtectedFolders`: Paths to ultra protected folders with stricter security.
- *
- * These protected folder paths are used within the Ultrahand-Overlay project to enforce
- * safety conditions and ensure that certain operations are not performed on sensitive
- * directories.
- */
+// Helper function to wrap text into multiple lines based on a maximum width (character count)
+// Subsequent lines are indented by 4 spaces
+//std::vector<std::string> wrapText(const std::string& text, size_t maxWidth) {
+//    std::vector<std::string> wrappedLines;
+//    //std::string indent = "    ";  // 4 spaces for indentation
+//    std::string indent = "└ ";
+//    size_t currentPos = 0;
+//
+//    // First line (no indentation)
+//    wrappedLines.push_back(text.substr(currentPos, maxWidth));
+//    currentPos += maxWidth;
+//
+//    // Subsequent lines (indented by 4 spaces)
+//    while (currentPos < text.size()) {
+//        wrappedLines.push_back(indent + text.substr(currentPos, maxWidth));
+//        currentPos += maxWidth;
+//    }
+//
+//    return wrappedLines;
+//}
 
-/**
- * @brief Ultrahand-Overlay Protected Folders
- *
- * This block of code defines two vectors containing paths to protected folders used in the
- * Ultrahand-Overlay project. These folders are designated as protected to prevent certain
- * operations that may pose security risks.
- *
- * The two vectors include:
- *
- * - `protectedFolders`: Paths to standard protected folders.
- * - `ultraProtectedFolders`: Paths to ultra protected folders with stricter security.
- *
- * These protected folder paths are used within the Ultrahand-Overlay project to enforce
- * safety conditions and ensure that certain operations are not performed on sensitive
- * directories.
- */
 
-bool isDangerousCombination(const std::string& originalPath) {
-    // Early exit: Check for double wildcards first (cheapest check)
-    if (originalPath.find("**") != std::string::npos) {
-        return true;
-    }
-    
-    // Early exit: Check if path contains wildcards at all
-    const bool hasWildcards = originalPath.find('*') != std::string::npos;
-    
-    // 1) Normalize repeated wildcards only if wildcards exist
-    std::string patternPath;
-    if (hasWildcards) {
-        //patternPath.reserve(originalPath.length()); // Avoid reallocations
-        bool lastWasStar = false;
-        for (char c : originalPath) {
-            if (c == '*') {
-                if (!lastWasStar) {
-                    patternPath += c;
-                    lastWasStar = true;
-                }
-                // skip extra '*'
-            } else {
-                patternPath += c;
-                lastWasStar = false;
-            }
-        }
-    } else {
-        patternPath = originalPath; // No wildcards, use as-is
-    }
-    
-    // 2) Define folder sets with precomputed lengths for faster comparisons
-    struct FolderInfo {
-        const char* path;
-        size_t length;
-    };
-    
-    static constexpr FolderInfo albumFolders[] = {
-        {"sdmc:/Nintendo/Album/", 20},
-        {"sdmc:/emuMMC/RAW1/Nintendo/Album/", 33}
-    };
-    
-    static constexpr FolderInfo ultraProtectedFolders[] = {
-        {"sdmc:/Nintendo/Contents/", 23},
-        {"sdmc:/Nintendo/save/", 18},
-        {"sdmc:/emuMMC/RAW1/Nintendo/Contents/", 36},
-        {"sdmc:/emuMMC/RAW1/Nintendo/save/", 31}
-    };
-    
-    static constexpr FolderInfo restrictedWildcardFolders[] = {
-        {"sdmc:/config/", 13},
-        {"sdmc:/bootloader/", 18},
-        {"sdmc:/atmosphere/", 18},
-        {"sdmc:/switch/", 14}
-    };
-    
-    static constexpr FolderInfo protectedFolders[] = {
-        {"sdmc:/Nintendo/", 16},
-        {"sdmc:/emuMMC/", 13},
-        {"sdmc:/emuMMC/RAW1/", 18}
-    };
-    
-    // 3) Check for directory traversal patterns (before other dangerous patterns)
-    //if (patternPath.find("/../") != std::string::npos || 
-    //    patternPath.find("../") == 0 ||
-    //    patternPath.find("/..") == patternPath.length() - 3) {
-    //    return true;
-    //}
-    
-    // 4) Check other always dangerous patterns (cheap string searches)
-    static const std::vector<const char*> alwaysDangerousPatterns = {
-        "~",
-        "null*",
-        "*null"
-    };
+bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::string& hexPath, const std::string& iniPath, const std::string& listString, const std::string& listPath, const std::string& jsonString, const std::string& jsonPath);
+
+std::string getFirstSectionText(const std::vector<std::vector<std::string>>& tableData, const std::string& packagePath) {
+    std::string message;
+    std::string listFileSourcePath;
+    std::string hexPath, iniPath, listString, listPath, jsonString, jsonPath;
     
-    for (const auto& pat : alwaysDangerousPatterns) {
-        if (patternPath.find(pat) != std::string::npos) {
-            return true;
-        }
-    }
+    bool inEristaSection = false;
+    bool inMarikoSection = false;
+    std::vector<std::string> lines;
     
-    // 5) Root folder wildcard check (only if wildcards exist)
-    if (hasWildcards) {
-        static constexpr const char rootPrefix[] = "sdmc:/";
-        static constexpr size_t rootLen = 6; // Length of "sdmc:/"
-        
-        if (patternPath.length() >= rootLen && 
-            patternPath.compare(0, rootLen, rootPrefix) == 0) {
-            size_t nextSlash = patternPath.find('/', rootLen);
-            if (nextSlash == std::string::npos) nextSlash = patternPath.size();
-            const size_t wildcardPos = patternPath.find('*', rootLen);
-            if (wildcardPos != std::string::npos && wildcardPos < nextSlash) {
-                return true; // wildcard in top-level directory disallowed
-            }
-        } else {
-            // Disallow wildcards outside sdmc:/
-            return true;
+    std::vector<std::string> cmd;
+    for (const auto& commands : tableData) {
+        cmd = commands;  // Make a copy if you need to modify it
+
+        if (cmd.empty()) {
+            continue;
         }
-    }
-    
-    // 6) Check ultra-protected folders (highest priority)
-    for (const auto& folder : ultraProtectedFolders) {
-        if (patternPath.length() >= folder.length &&
-            patternPath.compare(0, folder.length, folder.path) == 0) {
-            return true;
+
+        const std::string& commandName = cmd[0];
+
+        if (commandName == "erista:") {
+            inEristaSection = true;
+            inMarikoSection = false;
+            continue;
+        } else if (commandName == "mariko:") {
+            inEristaSection = false;
+            inMarikoSection = true;
+            continue;
         }
-    }
-    
-    // 7) Check restricted wildcard folders (only if wildcards exist)
-    std::string relative;
-    if (hasWildcards) {
-        for (const auto& folder : restrictedWildcardFolders) {
-            if (patternPath.length() >= folder.length &&
-                patternPath.compare(0, folder.length, folder.path) == 0) {
-                
-                // OPTIMIZED: Create relative string only when processing restricted folders
-                relative = patternPath.substr(folder.length);
-                
-                // If relative is empty or just '*', it means "the whole folder" or "all files"
-                if (relative.empty() || relative == "*" || relative == "*/") {
-                    return true; // block broad delete or targeting folder itself
+
+        if ((inEristaSection && !inMarikoSection && usingErista) ||
+            (!inEristaSection && inMarikoSection && usingMariko) ||
+            (!inEristaSection && !inMarikoSection)) {
+
+            // Apply placeholder replacements if necessary
+            applyPlaceholderReplacements(cmd, hexPath, iniPath, listString, listPath, jsonString, jsonPath);
+
+            const size_t cmdSize = cmd.size();
+
+            if (commandName == "list_file_source" && listFileSourcePath.empty()) {
+                listFileSourcePath = cmd[1];
+                preprocessPath(listFileSourcePath, packagePath);
+
+                // Read lines from the file
+                lines = readListFromFile(listFileSourcePath);
+
+                // Return the first line if available
+                if (!lines.empty()) {
+                    return lines[0];
                 }
-                
-                // Otherwise allow wildcards deeper inside folder
-                return false;
-            }
-        }
-    }
-    
-    // 8) Check protected folders
-    bool isAlbum;
-    
-    for (const auto& folder : protectedFolders) {
-        if (patternPath.length() >= folder.length &&
-            patternPath.compare(0, folder.length, folder.path) == 0) {
-            
-            // Check if this is an album folder (exception to protection)
-            isAlbum = false;
-            for (const auto& albumFolder : albumFolders) {
-                if (patternPath.length() >= albumFolder.length &&
-                    patternPath.compare(0, albumFolder.length, albumFolder.path) == 0) {
-                    isAlbum = true;
-                    break;
+            } else if (commandName == LIST_STR) {
+                if (cmdSize >= 2) {
+                    listString = cmd[1];
+                    removeQuotes(listString);
+                    // Process listString if needed
                 }
-            }
-            
-            if (isAlbum) {
-                return false; // wildcards allowed in album folders
-            }
-            
-            // Check for wildcards in protected folder (only if wildcards exist)
-            if (hasWildcards) {
-                // OPTIMIZED: Create relative string only when processing protected folders
-                relative = patternPath.substr(folder.length);
-                if (relative.find('*') != std::string::npos) {
-                    return true; // wildcard in protected folder disallowed
+            } else if (commandName == LIST_FILE_STR) {
+                if (cmdSize >= 2) {
+                    listPath = cmd[1];
+                    preprocessPath(listPath, packagePath);
+                    // Read from listPath if needed
+                }
+            } else if (commandName == JSON_STR) {
+                if (cmdSize >= 2) {
+                    jsonString = cmd[1];
+                    // Process jsonString if needed
+                }
+            } else if (commandName == JSON_FILE_STR) {
+                if (cmdSize >= 2) {
+                    jsonPath = cmd[1];
+                    preprocessPath(jsonPath, packagePath);
+                    // Read from jsonPath if needed
+                }
+            } else if (commandName == INI_FILE_STR) {
+                if (cmdSize >= 2) {
+                    iniPath = cmd[1];
+                    preprocessPath(iniPath, packagePath);
+                    // Read from iniPath if needed
+                }
+            } else if (commandName == HEX_FILE_STR) {
+                if (cmdSize >= 2) {
+                    hexPath = cmd[1];
+                    preprocessPath(hexPath, packagePath);
+                    // Read from hexPath if needed
                 }
+            } else {
+                // Default case: This is where sectionLines are populated in addTable
+                // Return cmd[0] as the first section text
+                return cmd[0];
             }
-            return false;
         }
     }
-    
-    // 9) Otherwise, no dangerous combination detected
-    return false;
+
+    // If no section text is found, return an empty string or a default value
+    return "";  // Or return a default message if appropriate
 }
 
 
-// Function to populate selectedItemsListOff from a JSON array based on a key
-void populateSelectedItemsListFromJson(const std::string& sourceType, const std::string& jsonStringOrPath, const std::string& jsonKey, std::vector<std::string>& selectedItemsList) {
-    selectedItemsList.clear();
+void addGap(tsl::elm::List* list, s32 gapHeight) {
+    list->addItem(new tsl::elm::CustomDrawer(
+        [](tsl::gfx::Renderer* renderer, s32 x, s32 y, s32 w, s32 h) {
+            // Empty drawer - just creates space
+        }
+    ), gapHeight);
+}
 
-    // Check for empty JSON source strings
-    if (jsonStringOrPath.empty()) {
-        return;
-    }
-    // Use a unique_ptr to manage JSON object with appropriate deleter
-    std::unique_ptr<json_t, JsonDeleter> jsonData(nullptr, JsonDeleter());
-    // Convert JSON string or read from file based on the source type
-    if (sourceType == JSON_STR) {
-        jsonData.reset(stringToJson(jsonStringOrPath));
-    } else if (sourceType == JSON_FILE_STR) {
-        jsonData.reset(readJsonFromFile(jsonStringOrPath));
-    }
-    // Early return if jsonData is null or not an array
-    if (!jsonData) {
-        return;
-    }
-    
-    cJSON* jsonArray = reinterpret_cast<cJSON*>(jsonData.get());
-    if (!cJSON_IsArray(jsonArray)) {
-        return;
+std::vector<std::string> wrapText(
+    const std::string& text,
+    float maxWidth,
+    const std::string& wrappingMode,
+    bool useIndent,
+    const std::string& indent,
+    float indentWidth,
+    size_t fontSize
+) {
+    if (wrappingMode == "none" || (wrappingMode != "char" && wrappingMode != "word")) {
+        return { text };
     }
-    
-    // Prepare for efficient insertion
-    const int arraySize = cJSON_GetArraySize(jsonArray);
-    //selectedItemsList.reserve(arraySize);
-    
-    // Store the key as a const char* to avoid repeated c_str() calls
-    const char* jsonKeyCStr = jsonKey.c_str();
-    
-    // Iterate over the JSON array
-    for (int i = 0; i < arraySize; ++i) {
-        cJSON* item = cJSON_GetArrayItem(jsonArray, i);
-        if (cJSON_IsObject(item)) {
-            cJSON* keyValue = cJSON_GetObjectItemCaseSensitive(item, jsonKeyCStr);
-            if (cJSON_IsString(keyValue) && keyValue->valuestring) {
-                selectedItemsList.emplace_back(keyValue->valuestring);
+
+    std::vector<std::string> wrappedLines;
+
+    bool firstLine = true;
+    std::string currentLine;
+
+    if (wrappingMode == "char") {
+        for (char c : text) {
+            const float currentMaxWidth = firstLine ? maxWidth : maxWidth - indentWidth;
+
+            currentLine.push_back(c);
+            if (tsl::gfx::calculateStringWidth(currentLine, fontSize, false) > currentMaxWidth) {
+                // Remove last character and push line
+                const char lastChar = currentLine.back();
+                currentLine.pop_back();
+                if (!currentLine.empty()) {
+                    if (useIndent && !firstLine)
+                        wrappedLines.push_back(indent + currentLine);
+                    else
+                        wrappedLines.push_back(currentLine);
+                }
+                currentLine = lastChar;
+                firstLine = false;
             }
         }
-    }
-}
 
+        if (!currentLine.empty()) {
+            if (useIndent && !firstLine)
+                wrappedLines.push_back(indent + currentLine);
+            else
+                wrappedLines.push_back(currentLine);
+        }
+    } 
+    else {
+        // Word wrapping
+        StringStream stream(text);
+        std::string currentWord;
+
+        std::string testLine;
 
+        while (stream >> currentWord) {
+            const float currentMaxWidth = firstLine ? maxWidth : maxWidth - indentWidth;
 
-/**
- * @brief Replaces a placeholder with a replacement string in the input.
- *
- * This function replaces all occurrences of a specified placeholder with the
- * provided replacement string in the input string.
- *
- * @param input The input string.
- * @param placeholder The placeholder to replace.
- * @param replacement The string to replace the placeholder with.
- * @return The input string with placeholders replaced by the replacement string.
- */
-inline void applyPlaceholderReplacement(std::string& input, const std::string& placeholder, const std::string& replacement) {
-    const size_t pos = input.find(placeholder);
-    if (pos == std::string::npos) {
-        return;  // Returns original string directly if no placeholder is found
+            testLine = currentLine;
+            if (!testLine.empty()) testLine.push_back(' ');
+            testLine += currentWord;
+
+            if (tsl::gfx::calculateStringWidth(testLine, fontSize, false) > currentMaxWidth) {
+                if (!currentLine.empty()) {
+                    if (useIndent && !firstLine)
+                        wrappedLines.push_back(indent + currentLine);
+                    else
+                        wrappedLines.push_back(currentLine);
+                }
+                currentLine = std::move(currentWord);
+                firstLine = false;
+            } else {
+                currentLine.swap(testLine);
+            }
+        }
+
+        if (!currentLine.empty()) {
+            if (useIndent && !firstLine)
+                wrappedLines.push_back(indent + currentLine);
+            else
+                wrappedLines.push_back(currentLine);
+        }
     }
-    //std::string result = input;
-    input.replace(pos, placeholder.length(), replacement);
-    //return result;
+
+    return wrappedLines;
 }
 
+// ─── Helper: flatten + placeholder + wrap & expand ─────────────────────────────
+// Resolves table commands (placeholders, list/json/ini/hex sources) into section and info text
+static bool resolveTableLines(
+    const std::vector<std::vector<std::string>>& tableData,
+    const std::string&                           packagePath,
+    std::vector<std::string>&                    outSection,
+    std::vector<std::string>&                    outInfo
+) {
+    outSection.clear();
+    outInfo.clear();
+
+    bool anyReplacementsMade = false;
 
+    std::vector<std::string> lines;
 
+    std::string listFileSourcePath;
+    std::string hexPath, iniPath, listString, listPath, jsonString, jsonPath;
+    bool inErista = false, inMariko = false;
 
-void applyReplaceIniPlaceholder(std::string& arg, const std::string& commandName, const std::string& iniPath) {
-    const std::string searchString = "{" + commandName + "(";
-    
-    // Early exit: Check if placeholder pattern exists before doing any INI work
-    if (arg.find(searchString) == std::string::npos) {
-        return; // No placeholders found, nothing to do
-    }
-    
-    // Pre-declare variables outside the loop
-    size_t startPos = 0;
-    size_t endPos;
-    size_t commaPos;
-    size_t entryIndex;
-    std::string placeholderContent;
-    std::string replacement;
-    std::string iniSection;
-    std::string iniKey;
-    
-    // Cache section names to avoid re-parsing INI file multiple times
-    std::vector<std::string> sectionNames;
-    bool sectionsLoaded = false;
-    
-    // Build result incrementally to avoid expensive string replacement operations
-    std::string result;
-    size_t lastPos = 0;
-    const size_t searchStringLen = searchString.length();
-    
-    // Process all occurrences of the placeholder
-    while ((startPos = arg.find(searchString, lastPos)) != std::string::npos) {
-        endPos = arg.find(")}", startPos);
-        if (endPos == std::string::npos || endPos <= startPos) {
-            // Invalid placeholder, append text up to this point and continue searching
-            result.append(arg, lastPos, startPos + searchStringLen - lastPos);
-            lastPos = startPos + searchStringLen;
+    for (const auto& cmds : tableData) {
+        if (cmds.empty()) continue;
+        const auto& name = cmds[0];
+
+        if (name == "erista:") {
+            inErista = true;
+            inMariko = false;
             continue;
         }
-        
-        // Append text before placeholder
-        result.append(arg, lastPos, startPos - lastPos);
-        
-        placeholderContent = arg.substr(startPos + searchStringLen, 
-                                       endPos - startPos - searchStringLen);
-        trim(placeholderContent);
-        
-        commaPos = placeholderContent.find(',');
-        
-        if (commaPos != std::string::npos) {
-            // Handle section,key format
-            iniSection = placeholderContent.substr(0, commaPos);
-            trim(iniSection);
-            removeQuotes(iniSection);
-            
-            iniKey = placeholderContent.substr(commaPos + 1);
-            trim(iniKey);
-            removeQuotes(iniKey);
-            
-            replacement = returnOrNull(parseValueFromIniSection(iniPath, iniSection, iniKey));
-        } else {
-            // Check if the content is an integer
-            if (std::all_of(placeholderContent.begin(), placeholderContent.end(), ::isdigit)) {
-                if (!isValidNumber(placeholderContent)) {
-                    replacement = NULL_STR;
-                } else {
-                    entryIndex = ult::stoi(placeholderContent);
-                    
-                    // Load section names only once when needed
-                    if (!sectionsLoaded) {
-                        sectionNames = parseSectionsFromIni(iniPath);
-                        sectionsLoaded = true;
-                    }
-                    
-                    if (entryIndex < sectionNames.size()) {
-                        replacement = sectionNames[entryIndex];
-                    } else {
-                        replacement = NULL_STR;
-                    }
+        if (name == "mariko:") {
+            inErista = false;
+            inMariko = true;
+            continue;
+        }
+
+        if ((inErista && usingErista) || (inMariko && usingMariko) || (!inErista && !inMariko)) {
+            auto cmd = cmds;  // Copy for placeholder replacements
+
+            // Track if any placeholder replacements were made
+            if (applyPlaceholderReplacements(
+                cmd, hexPath, iniPath,
+                listString, listPath,
+                jsonString, jsonPath
+            )) {
+                anyReplacementsMade = true;
+            }
+
+            if (cmd[0] == "list_file_source" && cmd.size() >= 2 && listFileSourcePath.empty()) {
+                listFileSourcePath = cmd[1];
+                preprocessPath(listFileSourcePath, packagePath);
+                lines = readListFromFile(listFileSourcePath);
+                for (const auto& line : lines) {
+                    outSection.push_back(line);
+                    outInfo.push_back("");
                 }
-            } else {
-                replacement = NULL_STR;
+            }
+            else if (cmd[0] == LIST_STR && cmd.size() >= 2) {
+                listString = cmd[1];
+                removeQuotes(listString);
+            }
+            else if (cmd[0] == LIST_FILE_STR && cmd.size() >= 2) {
+                listPath = cmd[1];
+                preprocessPath(listPath, packagePath);
+            }
+            else if (cmd[0] == JSON_STR && cmd.size() >= 2) {
+                jsonString = cmd[1];
+            }
+            else if (cmd[0] == JSON_FILE_STR && cmd.size() >= 2) {
+                jsonPath = cmd[1];
+                preprocessPath(jsonPath, packagePath);
+            }
+            else if (cmd[0] == INI_FILE_STR && cmd.size() >= 2) {
+                iniPath = cmd[1];
+                preprocessPath(iniPath, packagePath);
+            }
+            else if (cmd[0] == HEX_FILE_STR && cmd.size() >= 2) {
+                hexPath = cmd[1];
+                preprocessPath(hexPath, packagePath);
+            }
+            else {
+                outSection.push_back(cmd[0]);
+                outInfo.push_back(cmd.size() > 2 ? cmd[2] : "");
             }
         }
-        
-        // Append the replacement
-        result.append(replacement);
-        
-        // Update lastPos to continue after this placeholder
-        lastPos = endPos + 2;
     }
-    
-    // Append remaining text after last placeholder
-    result.append(arg, lastPos);
-    
-    // Replace original string with result
-    arg = std::move(result);
-}
 
+    // Return true if any placeholder replacements were made
+    return anyReplacementsMade;
+}
 
 /**
- * @brief Replaces a JSON source placeholder with the actual JSON source.
- *
- * Optimized version with variables moved to usage scope to avoid repeated allocations.
+ * @brief Bounded cache of string widths and wrapped lines used by table layout.
  *
- * @param arg The input string containing the placeholder.
- * @param commandName The name of the JSON command (e.g., "json", "json_file").
- * @param jsonPathOrString The path to the JSON file or the JSON string itself.
- * @return std::string The input string with the placeholder replaced by the actual JSON source,
- *                   or the original input string if replacement failed or jsonDict is nullptr.
+ * Entries are keyed by the string hash plus font size (and wrap mode, width and indent flag
+ * for wrapped lines); the string itself is kept to rule out hash collisions. When a table
+ * reaches its capacity it is simply emptied. Only used from the UI thread.
  */
+class TextMeasureCache {
+public:
+    float width(const std::string& text, size_t fontSize) {
+        const u64 key = combine(std::hash<std::string>{}(text), fontSize);
+        auto it = widths.find(key);
+        if (it != widths.end() && it->second.fontSize == fontSize && it->second.text == text)
+            return it->second.width;
+
+        const float measured = tsl::gfx::calculateStringWidth(text, fontSize, false);
+        if (widths.size() >= WIDTH_CAPACITY)
+            widths.clear();
+        widths[key] = WidthEntry{text, fontSize, measured};
+        return measured;
+    }
+
+    const std::vector<std::string>& wrap(
+        const std::string& text,
+        float maxWidth,
+        const std::string& wrappingMode,
+        bool useIndent,
+        const std::string& indent,
+        float indentWidth,
+        size_t fontSize
+    ) {
+        const u8 mode = (wrappingMode == "char") ? 1 : (wrappingMode == "word") ? 2 : 0;
+        const u32 widthKey = static_cast<u32>(maxWidth);
+        const u64 key = combine(combine(combine(std::hash<std::string>{}(text), fontSize),
+            (static_cast<u64>(widthKey) << 8) | (static_cast<u64>(mode) << 1) | useIndent), indent.size());
+
+        auto it = wraps.find(key);
+        if (it != wraps.end()) {
+            const WrapEntry& entry = it->second;
+            if (entry.fontSize == fontSize && entry.mode == mode && entry.maxWidth == widthKey &&
+                entry.useIndent == useIndent && entry.text == text)
+                return entry.lines;
+        }
+
+        if (wraps.size() >= WRAP_CAPACITY)
+            wraps.clear();
+        WrapEntry& entry = wraps[key];
+        entry.text = text;
+        entry.fontSize = fontSize;
+        entry.maxWidth = widthKey;
+        entry.mode = mode;
+        entry.useIndent = useIndent;
+        entry.lines = wrapText(text, maxWidth, wrappingMode, useIndent, indent, indentWidth, fontSize);
+        return entry.lines;
+    }
+
+    void clear() {
+        widths.clear();
+        wraps.clear();
+    }
+
+private:
+    static constexpr size_t WIDTH_CAPACITY = 256;
+    static constexpr size_t WRAP_CAPACITY = 128;
+
+    struct WidthEntry {
+        std::string text;
+        size_t fontSize = 0;
+        float width = 0.0f;
+    };
+
+    struct WrapEntry {
+        std::string text;
+        size_t fontSize = 0;
+        u32 maxWidth = 0;
+        u8 mode = 0;
+        bool useIndent = false;
+        std::vector<std::string> lines;
+    };
+
+    std::unordered_map<u64, WidthEntry> widths;
+    std::unordered_map<u64, WrapEntry> wraps;
+
+    static u64 combine(u64 seed, u64 value) {
+        return seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+    }
+};
+
+static TextMeasureCache textMeasureCache;
+
 /**
- * @brief Replaces a JSON source placeholder with the actual JSON source.
- *
- * Optimized version with variables moved outside loops to avoid repeated allocations.
- *
- * @param arg The input string containing the placeholder.
- * @param commandName The name of the JSON command (e.g., "json", "json_file").
- * @param jsonPathOrString The path to the JSON file or the JSON string itself.
- * @return std::string The input string with the placeholder replaced by the actual JSON source,
- *                   or the original input string if replacement failed or jsonDict is nullptr.
+ * @brief Rows of the previous layout of one table, so unchanged rows skip wrapping and measuring.
  */
-std::string replaceJsonPlaceholder(const std::string& arg, const std::string& commandName, const std::string& jsonPathOrString) {
-    // Early exit: Check if placeholder pattern exists before doing any JSON work
-    const std::string searchString = "{" + commandName + "(";
-    if (arg.find(searchString) == std::string::npos) {
-        return arg; // No placeholders found, return original
-    }
-    
-    // Load JSON data only if we have placeholders to process
-    std::unique_ptr<json_t, JsonDeleter> jsonDict;
-    if (commandName == "json" || commandName == "json_source") {
-        jsonDict.reset(stringToJson(jsonPathOrString));
-    } else if (commandName == "json_file" || commandName == "json_file_source") {
-        jsonDict.reset(readJsonFromFile(jsonPathOrString));
-    }
-    if (!jsonDict) {
-        return arg; // Return original string if JSON data couldn't be loaded
-    }
-    
-    // Build result incrementally to avoid expensive string replacement operations
-    std::string result;
-    
-    size_t lastPos = 0;
-    size_t startPos = arg.find(searchString);
-    
-    const size_t searchStringLen = searchString.length();
-    
-    // Pre-declare variables outside loops to avoid repeated allocations
-    size_t endPos, nextPos, commaPos, index;
-    std::string key;
-    bool validValue;
-    
-    while (startPos != std::string::npos) {
-        endPos = arg.find(")}", startPos);
-        if (endPos == std::string::npos) {
-            break; // Break if no closing tag is found
+struct TableLayoutCache {
+    std::vector<std::string> lines;
+    std::vector<std::string> infos;
+    std::vector<std::vector<std::string>> wrappedLines;
+    std::vector<float> infoWidths;
+};
+
+// Wraps resolved lines and computes their x/y placement for TableDrawer
+static void layoutTableLines(
+    const std::vector<std::string>&              lines,
+    const std::vector<std::string>&              infos,
+    size_t                                       columnOffset,
+    size_t                                       startGap,
+    size_t                                       newlineGap,
+    const std::string&                           wrappingMode,
+    const std::string&                           alignment,
+    bool                                         useWrappedTextIndent,
+    std::vector<std::string>&                    outSection,
+    std::vector<std::string>&                    outInfo,
+    std::vector<s32>&                            outY,
+    std::vector<int>&                            outX,
+    TableLayoutCache*                            rowCache = nullptr
+) {
+    static constexpr size_t lineHeight = 16;
+    static constexpr size_t fontSize = 16;
+    const size_t xMax = tsl::cfg::FramebufferWidth - 95;
+    static const std::string indent = "└ ";
+    const float indentWidth = textMeasureCache.width(indent, fontSize);
+
+    outSection.clear();
+    //outSection.shrink_to_fit();
+    outInfo.clear();
+    //outInfo.shrink_to_fit();
+    outY.clear();
+    //outY.shrink_to_fit();
+    outX.clear();
+    //outX.shrink_to_fit();
+
+    size_t curY = startGap;
+
+    // A small lambda to wrap and push lines with proper x,y and info alignment
+    auto processLines = [&](const std::vector<std::string>& lines, const std::vector<std::string>& infos) {
+        static const std::string emptyInfo;
+        std::string infoText;
+        int xPos;
+        float infoWidth;
+        std::vector<std::string> wrappedLines;
+
+        // Rows whose text matches the previous layout of this table reuse its wrapped lines and widths
+        const size_t previousCount = rowCache ? rowCache->lines.size() : 0;
+        if (rowCache) {
+            rowCache->wrappedLines.resize(lines.size());
+            rowCache->infoWidths.resize(lines.size(), 0.0f);
         }
-        
-        // Append text before placeholder
-        result.append(arg, lastPos, startPos - lastPos);
-        
-        nextPos = startPos + searchStringLen;
-        cJSON* value = reinterpret_cast<cJSON*>(jsonDict.get()); // Get the JSON root object
-        validValue = true;
-        
-        while (nextPos < endPos && validValue) {
-            commaPos = arg.find(',', nextPos);
-            if (commaPos == std::string::npos || commaPos > endPos) {
-                commaPos = endPos; // Set to endPos if no comma is found or it's beyond endPos
+
+        for (size_t i = 0; i < lines.size(); ++i) {
+            const std::string& baseText = lines[i];
+            const std::string& infoTextRaw = (i < infos.size()) ? infos[i] : emptyInfo;
+            infoText = (infoTextRaw.find(NULL_STR) != std::string::npos) ? UNAVAILABLE_SELECTION : infoTextRaw;
+
+            const bool sameLine = i < previousCount && rowCache->lines[i] == baseText;
+            const bool sameInfo = i < previousCount && i < rowCache->infos.size() && rowCache->infos[i] == infoTextRaw;
+
+            // Wrap the base text according to wrappingMode and indent params
+            if (!sameLine) {
+                if (wrappingMode == "char" || wrappingMode == "word")
+                    wrappedLines = textMeasureCache.wrap(baseText, xMax - 8, wrappingMode,
+                        useWrappedTextIndent, indent, indentWidth, fontSize);
+                else
+                    wrappedLines = { baseText };
+                if (rowCache)
+                    rowCache->wrappedLines[i] = wrappedLines;
             }
-            
-            // Reuse string capacity for key
-            key.assign(arg, nextPos, commaPos - nextPos);
-            
-            if (cJSON_IsObject(value)) {
-                value = cJSON_GetObjectItemCaseSensitive(value, key.c_str()); // Navigate through object
-            } else if (cJSON_IsArray(value)) {
-                index = std::stoul(key); // Convert key to index for arrays
-                value = cJSON_GetArrayItem(value, index);
+            const std::vector<std::string>& rowLines = sameLine ? rowCache->wrappedLines[i] : wrappedLines;
+
+            // Cache width of info text only once per base line, not per wrapped line
+            if (sameInfo) {
+                infoWidth = rowCache->infoWidths[i];
             } else {
-                validValue = false; // Set validValue to false if value is neither object nor array
+                infoWidth = textMeasureCache.width(infoText, fontSize);
+                if (rowCache)
+                    rowCache->infoWidths[i] = infoWidth;
+            }
+
+            for (const auto& line : rowLines) {
+                outSection.push_back(line);
+                outInfo.push_back(infoText);
+
+                xPos = 0;
+                if (alignment == LEFT_STR) {
+                    xPos = static_cast<int>(columnOffset);
+                } else if (alignment == RIGHT_STR) {
+                    xPos = static_cast<int>(xMax - infoWidth + (columnOffset - 160 + 1));
+                } else { // CENTER_STR
+                    xPos = static_cast<int>(columnOffset + (xMax - infoWidth) / 2);
+                }
+
+                outX.push_back(xPos);
+                outY.push_back(static_cast<s32>(curY));
+                curY += lineHeight + newlineGap;
             }
-            nextPos = commaPos + 1; // Move next position past the comma
-        }
-        
-        if (validValue && value && cJSON_IsString(value) && value->valuestring) {
-            result.append(value->valuestring); // Append replacement value
-        } else {
-            // If replacement failed, keep the original placeholder
-            //result.append(arg, startPos, endPos + 2 - startPos);
-            result.append(NULL_STR);
         }
-        
-        lastPos = endPos + 2;
-        startPos = arg.find(searchString, lastPos); // Find next occurrence from last position
+    };
+
+    processLines(lines, infos);
+
+    if (rowCache) {
+        rowCache->lines = lines;
+        rowCache->infos = infos;
     }
-    
-    // Append remaining text after last placeholder
-    result.append(arg, lastPos);
-    
-    return result; // Return the modified string
 }
 
-// Helper function to replace placeholders
-void replaceAllPlaceholders(std::string& source, const std::string& placeholder, const std::string& replacement) {
-    //std::string modifiedArg = source;
-    std::string lastArg;
-    while (source.find(placeholder) != std::string::npos) {
-        //modifiedArg = replacePlaceholder(modifiedArg, placeholder, replacement);
-        applyPlaceholderReplacement(source, placeholder, replacement);
-        if (source == lastArg)
-            break;
-        lastArg = source;
+static bool buildTableDrawerLines(
+    const std::vector<std::vector<std::string>>& tableData,
+    std::vector<std::string>&                    sectionLines,
+    std::vector<std::string>&                    infoLines,
+    const std::string&                           packagePath,
+    size_t                                       columnOffset,
+    size_t                                       startGap,
+    size_t                                       newlineGap,
+    const std::string&                           wrappingMode,
+    const std::string&                           alignment,
+    bool                                         useWrappedTextIndent,
+    std::vector<std::string>&                    outSection,
+    std::vector<std::string>&                    outInfo,
+    std::vector<s32>&                            outY,
+    std::vector<int>&                            outX
+) {
+    if (tableData.empty()) {
+        layoutTableLines(sectionLines, infoLines, columnOffset, startGap, newlineGap,
+            wrappingMode, alignment, useWrappedTextIndent, outSection, outInfo, outY, outX);
+        return false;
     }
-    return;
+
+    std::vector<std::string> baseSection, baseInfo;
+    const bool anyReplacementsMade = resolveTableLines(tableData, packagePath, baseSection, baseInfo);
+    layoutTableLines(baseSection, baseInfo, columnOffset, startGap, newlineGap,
+        wrappingMode, alignment, useWrappedTextIndent, outSection, outInfo, outY, outX);
+    return anyReplacementsMade;
 }
 
 
 
-// Helper function to replace all placeholders in a single pass
-bool replacePlaceholdersInArg(std::string& source, const std::unordered_map<std::string, std::string>& replacements) {
-    bool replaced = false;
-    size_t pos;
-    for (const auto& [placeholder, replacement] : replacements) {
-        pos = 0;
-        while ((pos = source.find(placeholder, pos)) != std::string::npos) {
-            source.replace(pos, placeholder.length(), replacement);
-            pos += replacement.length();  // Move past the replacement to avoid infinite loop
-            replaced = true;
-        }
+// Helper function moved outside - no lambda creation overhead
+static tsl::Color getRawColor(const std::string& c, tsl::Color defaultColor) {
+    // Check most common/special case first
+    if (c == DEFAULT_STR) return defaultColor;
+    
+    // Quick length check to eliminate impossible matches
+    const size_t len = c.length();
+    
+    // Group by length to reduce comparisons
+    switch (len) {
+        case 4:
+            if (c == "text") return tsl::defaultTextColor;
+            if (c == "info") return tsl::infoTextColor;
+            break;
+            
+        case 6:
+            if (c == "header") return tsl::headerTextColor;
+            break;
+            
+        case 7:
+            if (c[0] == 'w' && c == "warning") return tsl::warningTextColor;
+            if (c[0] == 's' && c == "section") return tsl::sectionTextColor;
+            if (c[0] == 'b' && c == "bad_ram") return tsl::badRamTextColor;
+            break;
+            
+        case 8:
+            if (c == "on_value") return tsl::onTextColor;
+            break;
+            
+        case 9:
+            if (c == "off_value") return tsl::offTextColor;
+            break;
+            
+        case 11:
+            if (c[0] == 'h' && c == "healthy_ram") return tsl::healthyRamTextColor;
+            if (c[0] == 'n' && c == "neutral_ram") return tsl::neutralRamTextColor;
+            break;
     }
-    return replaced;
+    
+    return tsl::RGB888(c);
 }
 
+/**
+ * @brief Re-resolves ;polling=true tables on a background thread.
+ *
+ * Each table keeps its own copy of the table commands. Resolution holds interpreterStateMutex,
+ * so it never overlaps an interpreter run, and finished lines are handed over under the table's
+ * mutex only when the text changed; TableDrawer swaps them in and lays them out. Tables that
+ * have not been drawn recently (hidden overlay, other menu) are skipped, and the thread exits
+ * once no table is alive.
+ */
+class PollingTableRefresher {
+public:
+    struct Table {
+        std::vector<std::vector<std::string>> tableData;
+        std::string packagePath;
+        u64 intervalNs = 0;
+        u64 nextRefreshNs = 0;
+        std::atomic<u64> lastDrawnNs{0};
+
+        std::mutex linesMutex;
+        std::vector<std::string> section, info; // guarded by linesMutex
+        bool changed = false;                   // guarded by linesMutex
+
+        std::vector<std::string> resolvedSection, resolvedInfo; // worker only
+    };
 
-// Optimized getSourceReplacement function
-std::vector<std::vector<std::string>> getSourceReplacement(const std::vector<std::vector<std::string>>& commands,
-    const std::string& entry, size_t entryIndex, const std::string& packagePath = "") {
+    std::shared_ptr<Table> add(const std::vector<std::vector<std::string>>& tableData, const std::string& packagePath, u64 intervalMs) {
+        auto table = std::make_shared<Table>();
+        table->tableData = tableData;
+        table->packagePath = packagePath;
+        table->intervalNs = std::max<u64>(intervalMs, MIN_INTERVAL_MS) * 1000000ULL;
+        const u64 currentNs = armTicksToNs(armGetSystemTick());
+        table->nextRefreshNs = currentNs + table->intervalNs;
+        table->lastDrawnNs.store(currentNs, std::memory_order_relaxed);
 
-    bool inEristaSection = false;
-    bool inMarikoSection = false;
+        bool startWorker = false;
+        {
+            std::lock_guard<std::mutex> lock(refresherMutex);
+            tables.push_back(table);
+            if (!running) {
+                running = true;
+                stopping = false;
+                startWorker = true;
+            }
+        }
 
-    std::vector<std::vector<std::string>> modifiedCommands;
-    std::string listString, listPath, jsonString, jsonPath, iniPath;
-    bool usingFileSource = false;
+        if (startWorker) {
+            if (!worker.tryStart([this]() { run(); }, 0x10000, 0x3B)) {
+                std::lock_guard<std::mutex> lock(refresherMutex);
+                running = false; // tables keep their initial content
+            }
+        } else {
+            wakeCondition.notify_one();
+        }
+        return table;
+    }
 
-    std::string fileName = getNameFromPath(entry);
-    if (!isDirectory(entry)) {
-        dropExtension(fileName);
+    // Moves newly resolved lines into section/info; false when nothing changed since the last call
+    static bool takeLines(Table& table, std::vector<std::string>& section, std::vector<std::string>& info) {
+        std::lock_guard<std::mutex> lock(table.linesMutex);
+        if (!table.changed)
+            return false;
+        section.swap(table.section);
+        info.swap(table.info);
+        table.changed = false;
+        return true;
     }
 
-    std::vector<std::string> modifiedCmd;
-    std::string commandName;
-    std::string modifiedArg;
-    size_t startPos, endPos;
-    std::string replacement;
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(refresherMutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        worker.join();
+
+        std::lock_guard<std::mutex> lock(refresherMutex);
+        tables.clear();
+        running = false;
+    }
+
+private:
+    static constexpr u64 MIN_INTERVAL_MS = 1000;
+    static constexpr u64 DRAWN_GRACE_NS = 1000000000ULL;
+
+    std::vector<std::weak_ptr<Table>> tables;
+    std::mutex refresherMutex;
+    std::condition_variable wakeCondition;
+    BackgroundJob worker;
+    bool running = false;
+    bool stopping = false;
+
+    void run() {
+        std::vector<std::shared_ptr<Table>> due;
+        std::unique_lock<std::mutex> lock(refresherMutex);
+        while (!stopping) {
+            tables.erase(std::remove_if(tables.begin(), tables.end(),
+                [](const std::weak_ptr<Table>& table) { return table.expired(); }), tables.end());
+            if (tables.empty())
+                break;
 
-    std::string path;
-    std::string raw;
+            const u64 currentNs = armTicksToNs(armGetSystemTick());
+            u64 nextDueNs = UINT64_MAX;
+            for (const auto& weakTable : tables) {
+                auto table = weakTable.lock();
+                if (!table)
+                    continue;
+                if (table->nextRefreshNs <= currentNs) {
+                    table->nextRefreshNs = currentNs + table->intervalNs;
+                    if (currentNs - table->lastDrawnNs.load(std::memory_order_relaxed) < table->intervalNs + DRAWN_GRACE_NS)
+                        due.push_back(table);
+                }
+                nextDueNs = std::min(nextDueNs, table->nextRefreshNs);
+            }
 
-    const std::string indexStr = ult::to_string(entryIndex);
+            if (due.empty()) {
+                wakeCondition.wait_for(lock, std::chrono::nanoseconds(nextDueNs - currentNs));
+                continue;
+            }
 
-    for (const auto& cmd : commands) {
-        if (cmd.empty()) {
-            continue;
+            lock.unlock();
+            for (const auto& table : due)
+                refresh(*table);
+            due.clear(); // a table whose list is gone is freed here, outside the lock
+            lock.lock();
         }
+        running = false;
+    }
 
-        modifiedCmd.clear();
-        //modifiedCmd.shrink_to_fit();
-        //modifiedCmd.reserve(cmd.size());
-        commandName = cmd[0];
-
-        if (commandName == "download") {
-            isDownloadCommand.store(true, std::memory_order_release);
+    static void refresh(Table& table) {
+        std::vector<std::string> section, info;
+        {
+            std::lock_guard<std::recursive_mutex> stateLock(interpreterStateMutex);
+            resolveTableLines(table.tableData, table.packagePath, section, info);
         }
 
-        if (stringToLowercase(commandName) == "erista:") {
-            inEristaSection = true;
-            inMarikoSection = false;
-            continue;
-        } else if (stringToLowercase(commandName) == "mariko:") {
-            inEristaSection = false;
-            inMarikoSection = true;
-            continue;
-        }
+        if (section == table.resolvedSection && info == table.resolvedInfo)
+            return;
+        table.resolvedSection = section;
+        table.resolvedInfo = info;
 
-        if ((inEristaSection && usingErista) ||
-            (inMarikoSection && usingMariko) ||
-            (!inEristaSection && !inMarikoSection))
-        {
-            // Apply placeholder replacements if necessary
-            for (const auto& arg : cmd) {
-                modifiedArg = arg;
+        std::lock_guard<std::mutex> lock(table.linesMutex);
+        table.section.swap(section);
+        table.info.swap(info);
+        table.changed = true;
+    }
+};
 
-                if (commandName == "file_source") {
-                    usingFileSource = true;
-                }
-                else if (commandName == "list_source" && listString.empty()) {
-                    listString = cmd[1];
-                    removeQuotes(listString);
-                }
-                else if (commandName == "list_file_source" && listPath.empty()) {
-                    listPath = cmd[1];
-                    preprocessPath(listPath, packagePath);
-                }
-                else if (commandName == "ini_file_source" && iniPath.empty()) {
-                    iniPath = cmd[1];
-                    preprocessPath(iniPath, packagePath);
-                }
-                else if (commandName == "json_source" && jsonString.empty()) {
-                    jsonString = cmd[1];
-                }
-                else if (commandName == "json_file_source" && jsonPath.empty()) {
-                    jsonPath = cmd[1];
-                    preprocessPath(jsonPath, packagePath);
-                }
+static PollingTableRefresher pollingTableRefresher;
 
-                // These three always apply
-                replaceAllPlaceholders(modifiedArg, "{file_source}", entry);
-                replaceAllPlaceholders(modifiedArg, "{file_name}", fileName);
-                path = getParentDirNameFromPath(entry);
-                removeQuotes(path);
-                replaceAllPlaceholders(modifiedArg, "{folder_name}", path);
-                replaceAllPlaceholders(modifiedArg, "{index}", indexStr);
+void drawTable(
+    tsl::elm::List*      list,
+    const std::vector<std::vector<std::string>>& tableData,
+    std::vector<std::string>&             sectionLines,
+    std::vector<std::string>&             infoLines,
+    size_t columnOffset             = 164,
+    size_t startGap                 = 20,
+    size_t endGap                   = 9,
+    size_t newlineGap               = 4,
+    const std::string& tableSectionTextColor       = DEFAULT_STR,
+    const std::string& tableInfoTextColor          = DEFAULT_STR,
+    const std::string& tableInfoTextHighlightColor = DEFAULT_STR,
+    const std::string& alignment                   = LEFT_STR,
+    bool hideTableBackground        = false,
+    bool useHeaderIndent            = false,
+    bool isPolling                  = false,
+    bool isScrollable               = true,
+    const std::string& wrappingMode               = "none",
+    bool useWrappedTextIndent        = false,
+    const std::string& packagePath          = "",
+    size_t pollingIntervalMs         = 1000
+) {
+    // Prebuild initial buffers
+    std::vector<std::string> cacheExpSec, cacheExpInfo;
+    std::vector<s32>         cacheYOff;
+    std::vector<s32>         cacheXOff;
 
-                // {list_source(...)} block
-                if (modifiedArg.find("{list_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{list_source(");
-                    endPos   = modifiedArg.find(")}");
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        // SAFE: Use at() which does bounds checking, or catch the access
-                        const auto& listItems = stringToList(listString);  // const reference - no copy
-                        raw = (entryIndex < listItems.size()) ? listItems[entryIndex] : "";
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
-                    }
-                }
+    const bool usingPlaceholders = buildTableDrawerLines(
+        tableData, sectionLines, infoLines, packagePath,
+        columnOffset, startGap, newlineGap,
+        wrappingMode, alignment, useWrappedTextIndent,
+        cacheExpSec, cacheExpInfo, cacheYOff, cacheXOff
+    ) && isPolling;
 
-                // {list_file_source(...)} block
-                if (modifiedArg.find("{list_file_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{list_file_source(");
-                    endPos   = modifiedArg.find(")}");
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        raw = getEntryFromListFile(listPath, entryIndex);
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
-                    }
-                }
+    // Resolve colors once outside the render loop
+    const auto secRaw = getRawColor(tableSectionTextColor, tsl::sectionTextColor);
+    const auto infoRaw = getRawColor(tableInfoTextColor, tsl::infoTextColor);
+    const auto hiliteRaw = getRawColor(tableInfoTextHighlightColor, tsl::infoTextColor);
+    
+    // Pre-calculate color comparison
+    const bool sameCol = (tableInfoTextColor == tableInfoTextHighlightColor);
 
-                // {ini_file_source(...)} block - FIXED
-                if (modifiedArg.find("{ini_file_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    // applyReplaceIniPlaceholder modifies modifiedArg in place, so we just call it
-                    applyReplaceIniPlaceholder(modifiedArg, "ini_file_source", iniPath);
-                    // No additional replacement needed!
-                }
+    // Placeholder tables are resolved by pollingTableRefresher; the drawer only lays out new text
+    auto pollingTable = usingPlaceholders ? pollingTableRefresher.add(tableData, packagePath, pollingIntervalMs) : nullptr;
+    std::vector<std::string> polledSection, polledInfo;
+    auto layoutCache = usingPlaceholders ? std::make_shared<TableLayoutCache>() : nullptr;
 
-                // {json_source(...)} block
-                if (modifiedArg.find("{json_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{json_source(");
-                    endPos   = modifiedArg.find(")}");
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        raw = replaceJsonPlaceholder(
-                            modifiedArg.substr(startPos, endPos - startPos + 2),
-                            "json_source",
-                            jsonString
-                        );
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
-                    }
-                }
+    static const std::vector<std::string> specialCharacters =  {""};
+    
+    list->addItem(new tsl::elm::TableDrawer(
+        [=](tsl::gfx::Renderer* renderer, s32 x, s32 y, s32 w, s32 h) mutable {
 
-                // {json_file_source(...)} block
-                if (modifiedArg.find("{json_file_source(") != std::string::npos) {
-                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
-                    startPos = modifiedArg.find("{json_file_source(");
-                    endPos   = modifiedArg.find(")}");
-                    if (endPos != std::string::npos && endPos > startPos) {
-                        raw = replaceJsonPlaceholder(
-                            modifiedArg.substr(startPos, endPos - startPos + 2),
-                            "json_file_source",
-                            jsonPath
-                        );
-                        replacement = returnOrNull(raw);
-                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
-                    }
+            if (pollingTable) {
+                pollingTable->lastDrawnNs.store(armTicksToNs(armGetSystemTick()), std::memory_order_relaxed);
+                if (PollingTableRefresher::takeLines(*pollingTable, polledSection, polledInfo)) {
+                    layoutTableLines(
+                        polledSection, polledInfo,
+                        columnOffset, startGap, newlineGap,
+                        wrappingMode, alignment, useWrappedTextIndent,
+                        cacheExpSec, cacheExpInfo, cacheYOff, cacheXOff,
+                        layoutCache.get()
+                    );
                 }
-
-                modifiedCmd.push_back(std::move(modifiedArg));
             }
 
-            modifiedCommands.emplace_back(std::move(modifiedCmd));
-        }
-    }
-
-    if (usingFileSource) {
-        modifiedCommands.insert(modifiedCommands.begin(), { "file_name", fileName });
-        modifiedCommands.insert(modifiedCommands.begin(), { "folder_name", path });
-        modifiedCommands.insert(modifiedCommands.begin(), { "sourced_path", entry });
-    }
+            // Minimal branching, maximum cache efficiency
+            if (useHeaderIndent) {
+                renderer->drawRect(x-2, y, 4, 22, (tsl::headerSeparatorColor));
+            }
 
-    return modifiedCommands;
+            // Convert to renderer colors once per frame
+            const auto secColor = (secRaw);
+            const auto infoColor = (infoRaw);
+            const auto dividerColor = (tsl::textSeparatorColor);
+            
+            const size_t count = cacheExpSec.size();
+            const s32 baseX = x + 12;
+            
+            if (sameCol) {
+                // Fastest path: same colors, minimal function calls
+                for (size_t i = 0; i < count; ++i) {
+                    const s32 yPos = y + cacheYOff[i];
+                    renderer->drawStringWithColoredSections(cacheExpSec[i], false, specialCharacters, baseX, yPos, 16, secColor, dividerColor);
+                    renderer->drawStringWithColoredSections(cacheExpInfo[i], false, specialCharacters, x + cacheXOff[i], yPos, 16, infoColor, dividerColor);
+                }
+            } else {
+                // Different colors path
+                const auto hiliteColor = hiliteRaw;
+                
+                for (size_t i = 0; i < count; ++i) {
+                    const s32 yPos = y + cacheYOff[i];
+                    renderer->drawStringWithColoredSections(cacheExpSec[i], false, specialCharacters, baseX, yPos, 16, secColor, dividerColor);
+                    renderer->drawStringWithHighlight(
+                        cacheExpInfo[i], false, x + cacheXOff[i], yPos, 16,
+                        infoColor, hiliteColor
+                    );
+                }
+            }
+        },
+        hideTableBackground,
+        endGap,
+        isScrollable
+    ),
+    static_cast<u32>(
+        16 * cacheExpSec.size()
+        + newlineGap * (cacheExpSec.empty() ? 0 : cacheExpSec.size() - 1)
+        + endGap
+    ));
 }
 
-
-std::string getCurrentTimestamp(const std::string& format) {
-    // Try using standard POSIX time() function
-    time_t seconds = time(nullptr);
-    const u32 milliseconds = (armTicksToNs(armGetSystemTick()) / 1000000ULL) % 1000; // We lose millisecond precision with this method
-    
-    // If you need milliseconds, try to get them from system tick
-    //u64 tick_ns = armTicksToNs(armGetSystemTick());
-    //milliseconds = (armTicksToNs(armGetSystemTick()) / 1000000ULL) % 1000;
-    
-    std::string modifiedFormat = format;
-    bool hasMilliseconds = false;
-    
-    const size_t pos = modifiedFormat.find("%f");
-    if (pos != std::string::npos) {
-        modifiedFormat.erase(pos, 2);
-        hasMilliseconds = true;
-    }
-    
-    char buffer[30];
-    if (!std::strftime(buffer, sizeof(buffer), modifiedFormat.c_str(), std::localtime(&seconds))) {
-        return "";
-    }
-    
-    std::string formattedTime(buffer);
-    StringStream oss;
-    
-    if (formattedTime.find("%s") != std::string::npos) {
-        oss << static_cast<long long>(seconds); 
-        formattedTime.replace(formattedTime.find("%s"), 2, oss.str());
-        oss.clear();
-    }
-    
-    if (hasMilliseconds) {
-        std::string millisecondsStr = ult::to_string(milliseconds);
-        if (millisecondsStr.length() < 3) {
-            millisecondsStr.insert(0, 3 - millisecondsStr.length(), '0');
-        }
-        if (pos > 0 && format[pos - 1] == '.') {
-            formattedTime += millisecondsStr;
-        } else {
-            formattedTime += "." + millisecondsStr;
-        }
-    }
-    
-    return formattedTime;
+// ─── addTable simply forwards through ───────────────────────────────────────────
+void addTable(
+    tsl::elm::List*       list,
+    const std::vector<std::vector<std::string>>& tableData,
+    const std::string&                     packagePath,
+    const size_t&                          columnOffset                = 164,
+    const size_t&                          tableStartGap               = 20,
+    const size_t&                          tableEndGap                 = 9,
+    const size_t&                          tableSpacing                = 0,
+    const std::string&                     tableSectionTextColor       = DEFAULT_STR,
+    const std::string&                     tableInfoTextColor          = DEFAULT_STR,
+    const std::string&                     tableInfoTextHighlightColor = DEFAULT_STR,
+    const std::string&                     tableAlignment              = RIGHT_STR,
+    const bool&                            hideTableBackground         = false,
+    const bool&                            useHeaderIndent             = false,
+    const bool&                            isPolling                   = false,
+    const bool&                            isScrollable                = true,
+    const std::string&                     wrappingMode                = "none",
+    const bool&                            useWrappedTextIndent        = false,
+    const size_t&                          pollingIntervalMs           = 1000
+) {
+    std::vector<std::string> sectionLines, infoLines;
+    drawTable(
+        list, tableData,
+        sectionLines, infoLines,
+        columnOffset, tableStartGap, tableEndGap, tableSpacing,
+        tableSectionTextColor, tableInfoTextColor, tableInfoTextHighlightColor,
+        tableAlignment, hideTableBackground, useHeaderIndent,
+        isPolling, isScrollable, wrappingMode, useWrappedTextIndent,
+        packagePath, pollingIntervalMs
+    );
 }
 
 
+void addHelpInfo(tsl::elm::List* list) {
+    // Add a section break with small text to indicate the "Commands" section
+    addHeader(list, USER_GUIDE);
 
+    // Adjust the horizontal offset as needed
+    const int xOffset = ult::stoi(USERGUIDE_OFFSET);
 
+    // Define the section lines and info lines directly
+    std::vector<std::string> sectionLines = {
+        SETTINGS_MENU,
+        SCRIPT_OVERLAY,
+        STAR_FAVORITE,
+        APP_SETTINGS
+    };
 
-// Helper function to skip spaces
-void skipSpaces(const std::string& expression, size_t& pos) {
-    while (pos < expression.length() && std::isspace(expression[pos])) {
-        ++pos;
-    }
+    std::vector<std::string> infoLines = {
+        "\uE0B5 (" + ON_MAIN_MENU + ")",
+        "\uE0B6 (" + ON_A_COMMAND + ")",
+        "\uE0E2 (" + ON_OVERLAY_PACKAGE + ")",
+        "\uE0E3 (" + ON_OVERLAY_PACKAGE + ")"
+    };
+
+    std::vector<std::vector<std::string>> dummyTableData;
+
+    // Draw the table with the defined lines
+    drawTable(list, dummyTableData, sectionLines, infoLines, xOffset, 20, 9, 4);
+    //drawTable(list, sectionLines, infoLines, xOffset, 19, 12, 4, DEFAULT_STR, DEFAULT_STR, LEFT_STR, false, false, true, "none", false);
 }
 
-// Helper function to parse a number or a nested expression in parentheses
-double parseExpression(const std::string& expression, size_t& pos, bool& valid);
 
-double parseNumber(const std::string& expression, size_t& pos, bool& valid) {
-    skipSpaces(expression, pos);
 
-    // Check if the expression starts with a '(' indicating a nested expression
-    if (expression[pos] == '(') {
-        ++pos;  // Skip the '('
-        const double result = parseExpression(expression, pos, valid);
-        if (expression[pos] == ')') {
-            ++pos;  // Skip the ')'
-        } else {
-            valid = false;  // Unmatched parentheses
-        }
-        return result;
-    }
+void addPackageInfo(tsl::elm::List* list, auto& packageHeader, std::string type = PACKAGE_STR) {
+    // Add a section break with small text to indicate the "Commands" section
+    addHeader(list, (type == PACKAGE_STR ? PACKAGE_INFO : OVERLAY_INFO));
 
-    // Parse a number
-    double result = 0.0f;
-    bool hasDecimal = false;
-    double decimalPlace = 0.1f;
-    bool isNegative = false;
+    const int maxLineLength = 28;  // Adjust the maximum line length as needed
+    const int xOffset = 120;    // Adjust the horizontal offset as needed
+    //int numEntries = 0;   // Count of the number of entries
 
-    if (expression[pos] == '-') {
-        isNegative = true;
-        ++pos;
-    }
+    std::vector<std::string> sectionLines;
+    std::vector<std::string> infoLines;
 
-    while (pos < expression.length() && (std::isdigit(expression[pos]) || expression[pos] == '.')) {
-        if (expression[pos] == '.') {
-            hasDecimal = true;
-            ++pos;
-            continue;
-        }
+    // Helper function to add text with wrapping
+    auto addWrappedText = [&](const std::string& header, const std::string& text) {
+        sectionLines.push_back(header);
+        const std::string::size_type aboutHeaderLength = header.length();
+        
+        size_t startPos = 0;
+        size_t spacePos = 0;
 
-        if (hasDecimal) {
-            result += (expression[pos] - '0') * decimalPlace;
-            decimalPlace *= 0.1f;
-        } else {
-            result = result * 10.0f + (expression[pos] - '0');
-        }
-        ++pos;
-    }
+        size_t endPos;
+        std::string line;
 
-    if (isNegative) {
-        result = -result;
-    }
+        while (startPos < text.length()) {
+            endPos = std::min(startPos + maxLineLength, text.length());
+            line = text.substr(startPos, endPos - startPos);
+            
+            // Check if the current line ends with a space; if not, find the last space in the line
+            if (endPos < text.length() && text[endPos] != ' ') {
+                spacePos = line.find_last_of(' ');
+                if (spacePos != std::string::npos) {
+                    endPos = startPos + spacePos;
+                    line = text.substr(startPos, endPos - startPos);
+                }
+            }
 
-    valid = true;
-    return result;
-}
+            infoLines.push_back(line);
+            startPos = endPos + 1;
+            //numEntries++;
 
-// Function to evaluate an expression, which may include parentheses
-double parseExpression(const std::string& expression, size_t& pos, bool& valid) {
-    skipSpaces(expression, pos);
+            // Add corresponding newline to the packageSectionString
+            if (startPos < text.length())
+                sectionLines.push_back(std::string(aboutHeaderLength, ' '));
+        }
+    };
 
-    double result = parseNumber(expression, pos, valid);
-    if (!valid) return 0;
+    // Adding package header info
+    if (!packageHeader.title.empty()) {
+        sectionLines.push_back(_TITLE);
+        infoLines.push_back(packageHeader.title);
+        //numEntries++;
+    }
 
-    char op;
-    double operand;
-    while (pos < expression.length()) {
-        skipSpaces(expression, pos);
-        if (pos >= expression.length()) break;
+    if (!packageHeader.version.empty()) {
+        sectionLines.push_back(_VERSION);
+        infoLines.push_back(packageHeader.version);
+        //numEntries++;
+    }
 
-        op = expression[pos++];
-        skipSpaces(expression, pos);
+    if (!packageHeader.creator.empty()) {
+        //sectionLines.push_back(CREATOR);
+        //infoLines.push_back(packageHeader.creator);
+        //numEntries++;
+        addWrappedText(_CREATOR, packageHeader.creator);
+    }
 
-        operand = parseNumber(expression, pos, valid);
-        if (!valid) return 0;
+    if (!packageHeader.about.empty()) {
+        addWrappedText(_ABOUT, packageHeader.about);
+    }
 
-        switch (op) {
-            case '+':
-                result += operand;
-                break;
-            case '-':
-                result -= operand;
-                break;
-            case '*':
-                result *= operand;
-                break;
-            case '/':
-                if (operand == 0) {
-                    valid = false;  // Division by zero
-                    return 0;
-                }
-                result /= operand;
-                break;
-            case '%':
-                if (STBTT_fmod(result, 1.0f) != 0.0f || STBTT_fmod(operand, 1.0f) != 0.0f) {
-                    valid = false;  // Modulus only valid for integers
-                    return 0;
-                }
-                result = static_cast<int>(result) % static_cast<int>(operand);
-                break;
-            default:
-                valid = false;
-                return 0;
-        }
+    if (!packageHeader.credits.empty()) {
+        addWrappedText(_CREDITS, packageHeader.credits);
     }
 
-    valid = true;
-    return result;
-}
+    std::vector<std::vector<std::string>> dummyTableData;
 
-// Function to evaluate a complete expression (this will call parseExpression)
-double evaluateExpression(const std::string& expression, bool& valid) {
-    size_t pos = 0;
-    return parseExpression(expression, pos, valid);
+    // Drawing the table with section lines and info lines
+    //drawTable(list, sectionLines, infoLines, xOffset, 20, 12, 3);
+    drawTable(list, dummyTableData, sectionLines, infoLines, xOffset, 20, 9, 3, DEFAULT_STR, DEFAULT_STR, DEFAULT_STR, LEFT_STR, false, false, true);
 }
 
-// Handle Math Placeholder with Parentheses, Modulus, and Optional Integer Support
-std::string handleMath(const std::string& placeholder) {
-    const size_t startPos = placeholder.find('(') + 1;
-    const size_t endPos = placeholder.find(')');
-
-    if (startPos == std::string::npos || endPos == std::string::npos || startPos >= endPos) {
-        return NULL_STR;
-    }
 
-    std::string mathExpression = placeholder.substr(startPos, endPos - startPos);
-    removeQuotes(mathExpression);
 
-    const size_t commaPos = mathExpression.find(',');
-    bool forceInteger = false;
 
-    if (commaPos != std::string::npos) {
-        std::string secondParam = mathExpression.substr(commaPos + 1);
-        trim(secondParam);
-        forceInteger = (secondParam == TRUE_STR);
-        mathExpression = mathExpression.substr(0, commaPos);
-    }
 
-    size_t pos;
-    // Add spaces around operators to ensure proper parsing
-    for (const char op : {'+', '-', '*', '/'}) {
-        pos = 0;
-        while ((pos = mathExpression.find(op, pos)) != std::string::npos) {
-            if (pos > 0 && mathExpression[pos - 1] != ' ') {
-                mathExpression.insert(pos, " ");
-                pos++;
-            }
-            if (pos + 1 < mathExpression.size() && mathExpression[pos + 1] != ' ') {
-                mathExpression.insert(pos + 1, " ");
-            }
-            pos += 2; // Move past the operator and space
-        }
-    }
+/**
+ * @brief Ultrahand-Overlay Protected Folders
+ *
+ * This block of code defines two vectors containing paths to protected folders used in the
+ * Ultrahand-Overlay project. These folders are designated as protected to prevent certain
+ * operations that may pose security risks.
+ *
+ * The two vectors include:
+ *
+ * - `protectedFolders`: Paths to standard protected folders.
+ * - `ultraProtectedFolders`: Paths to ultra protected folders with stricter security.
+ *
+ * These protected folder paths are used within the Ultrahand-Overlay project to enforce
+ * safety conditions and ensure that certain operations are not performed on sensitive
+ * directories.
+ */
 
-    bool valid = false;
-    const double result = evaluateExpression(mathExpression, valid);
+/**
+ * @brief Ultrahand-Overlay Protected Folders
+ *
+ * This block of code defines two vectors containing paths to protected folders used in the
+ * Ultrahand-Overlay project. These folders are designated as protected to prevent certain
+ * operations that may pose security risks.
+ *
+ * The two vectors include:
+ *
+ * - `protectedFolders`: Paths to standard protected folders.
+ * - `ultraProtectedFolders`: Paths to ultra protected folders with stricter security.
+ *
+ * These protected folder paths are used within the Ultrahand-Overlay project to enforce
+ * safety conditions and ensure that certain operations are not performed on sensitive
+ * directories.
+ */
 
-    if (!valid) {
-        return NULL_STR;
+bool isDangerousCombination(const std::string& originalPath) {
+    // Early exit: Check for double wildcards first (cheapest check)
+    if (originalPath.find("**") != std::string::npos) {
+        return true;
     }
-
-    // Format the result with StringStream
-    StringStream oss;
-    if (forceInteger || STBTT_fmod(result, 1.0) == 0.0) {
-        oss << static_cast<int>(result);  // Integer output if required
+    
+    // Early exit: Check if path contains wildcards at all
+    const bool hasWildcards = originalPath.find('*') != std::string::npos;
+    
+    // 1) Normalize repeated wildcards only if wildcards exist
+    std::string patternPath;
+    if (hasWildcards) {
+        //patternPath.reserve(originalPath.length()); // Avoid reallocations
+        bool lastWasStar = false;
+        for (char c : originalPath) {
+            if (c == '*') {
+                if (!lastWasStar) {
+                    patternPath += c;
+                    lastWasStar = true;
+                }
+                // skip extra '*'
+            } else {
+                patternPath += c;
+                lastWasStar = false;
+            }
+        }
     } else {
-        // Manually format to two decimal places for double output
-        const int intPart = static_cast<int>(result);
-        const int decimalPart = static_cast<int>((result - intPart) * 100);  // Get two decimal places
-
-        oss << intPart << ".";
-
-        // Handle cases where decimal part has only one digit (e.g., 3.1 should be 3.10)
-        if (decimalPart < 10) {
-            oss << "0";
+        patternPath = originalPath; // No wildcards, use as-is
+    }
+    
+    // 2) Define folder sets with precomputed lengths for faster comparisons
+    struct FolderInfo {
+        const char* path;
+        size_t length;
+    };
+    
+    static constexpr FolderInfo albumFolders[] = {
+        {"sdmc:/Nintendo/Album/", 20},
+        {"sdmc:/emuMMC/RAW1/Nintendo/Album/", 33}
+    };
+    
+    static constexpr FolderInfo ultraProtectedFolders[] = {
+        {"sdmc:/Nintendo/Contents/", 23},
+        {"sdmc:/Nintendo/save/", 18},
+        {"sdmc:/emuMMC/RAW1/Nintendo/Contents/", 36},
+        {"sdmc:/emuMMC/RAW1/Nintendo/save/", 31}
+    };
+    
+    static constexpr FolderInfo restrictedWildcardFolders[] = {
+        {"sdmc:/config/", 13},
+        {"sdmc:/bootloader/", 18},
+        {"sdmc:/atmosphere/", 18},
+        {"sdmc:/switch/", 14}
+    };
+    
+    static constexpr FolderInfo protectedFolders[] = {
+        {"sdmc:/Nintendo/", 16},
+        {"sdmc:/emuMMC/", 13},
+        {"sdmc:/emuMMC/RAW1/", 18}
+    };
+    
+    // 3) Check for directory traversal patterns (before other dangerous patterns)
+    //if (patternPath.find("/../") != std::string::npos || 
+    //    patternPath.find("../") == 0 ||
+    //    patternPath.find("/..") == patternPath.length() - 3) {
+    //    return true;
+    //}
+    
+    // 4) Check other always dangerous patterns (cheap string searches)
+    static const std::vector<const char*> alwaysDangerousPatterns = {
+        "~",
+        "null*",
+        "*null"
+    };
+    
+    for (const auto& pat : alwaysDangerousPatterns) {
+        if (patternPath.find(pat) != std::string::npos) {
+            return true;
         }
-        oss << decimalPart;
     }
-
-    return oss.str();
-}
-
-
-std::string handleLength(const std::string& placeholder) {
-    const size_t startPos = placeholder.find('(') + 1;
-    const size_t endPos = placeholder.find(')');
     
-    if (startPos != std::string::npos && endPos != std::string::npos && endPos > startPos) {
-        std::string str = placeholder.substr(startPos, endPos - startPos);
-        trim(str);  // Remove any extra spaces
-        removeQuotes(str);  // If your strings are wrapped in quotes, remove them
+    // 5) Root folder wildcard check (only if wildcards exist)
+    if (hasWildcards) {
+        static constexpr const char rootPrefix[] = "sdmc:/";
+        static constexpr size_t rootLen = 6; // Length of "sdmc:/"
         
-        // Return the length of the string as a string
-        return ult::to_string(str.length());
+        if (patternPath.length() >= rootLen && 
+            patternPath.compare(0, rootLen, rootPrefix) == 0) {
+            size_t nextSlash = patternPath.find('/', rootLen);
+            if (nextSlash == std::string::npos) nextSlash = patternPath.size();
+            const size_t wildcardPos = patternPath.find('*', rootLen);
+            if (wildcardPos != std::string::npos && wildcardPos < nextSlash) {
+                return true; // wildcard in top-level directory disallowed
+            }
+        } else {
+            // Disallow wildcards outside sdmc:/
+            return true;
+        }
     }
     
-    return placeholder;  // If invalid, return the original placeholder
+    // 6) Check ultra-protected folders (highest priority)
+    for (const auto& folder : ultraProtectedFolders) {
+        if (patternPath.length() >= folder.length &&
+            patternPath.compare(0, folder.length, folder.path) == 0) {
+            return true;
+        }
+    }
+    
+    // 7) Check restricted wildcard folders (only if wildcards exist)
+    std::string relative;
+    if (hasWildcards) {
+        for (const auto& folder : restrictedWildcardFolders) {
+            if (patternPath.length() >= folder.length &&
+                patternPath.compare(0, folder.length, folder.path) == 0) {
+                
+                // OPTIMIZED: Create relative string only when processing restricted folders
+                relative = patternPath.substr(folder.length);
+                
+                // If relative is empty or just '*', it means "the whole folder" or "all files"
+                if (relative.empty() || relative == "*" || relative == "*/") {
+                    return true; // block broad delete or targeting folder itself
+                }
+                
+                // Otherwise allow wildcards deeper inside folder
+                return false;
+            }
+        }
+    }
+    
+    // 8) Check protected folders
+    bool isAlbum;
+    
+    for (const auto& folder : protectedFolders) {
+        if (patternPath.length() >= folder.length &&
+            patternPath.compare(0, folder.length, folder.path) == 0) {
+            
+            // Check if this is an album folder (exception to protection)
+            isAlbum = false;
+            for (const auto& albumFolder : albumFolders) {
+                if (patternPath.length() >= albumFolder.length &&
+                    patternPath.compare(0, albumFolder.length, albumFolder.path) == 0) {
+                    isAlbum = true;
+                    break;
+                }
+            }
+            
+            if (isAlbum) {
+                return false; // wildcards allowed in album folders
+            }
+            
+            // Check for wildcards in protected folder (only if wildcards exist)
+            if (hasWildcards) {
+                // OPTIMIZED: Create relative string only when processing protected folders
+                relative = patternPath.substr(folder.length);
+                if (relative.find('*') != std::string::npos) {
+                    return true; // wildcard in protected folder disallowed
+                }
+            }
+            return false;
+        }
+    }
+    
+    // 9) Otherwise, no dangerous combination detected
+    return false;
 }
 
 
+// Function to populate selectedItemsListOff from a JSON array based on a key
+void populateSelectedItemsListFromJson(const std::string& sourceType, const std::string& jsonStringOrPath, const std::string& jsonKey, std::vector<std::string>& selectedItemsList) {
+    selectedItemsList.clear();
 
-// Define the replacePlaceholders function outside of applyPlaceholderReplacements
-//auto replacePlaceholders = [](std::string& arg, const std::string& placeholder, const std::function<std::string(const std::string&)>& replacer) {
-//    size_t startPos, endPos;
-//    std::string lastArg, replacement;
-//
-//    size_t nestedStartPos, nextStartPos, nextEndPos;
-//
-//    while ((startPos = arg.find(placeholder)) != std::string::npos) {
-//        nestedStartPos = startPos;
-//        while (true) {
-//            nextStartPos = arg.find(placeholder, nestedStartPos + 1);
-//            nextEndPos = arg.find(")}", nestedStartPos);
-//            if (nextStartPos != std::string::npos && nextStartPos < nextEndPos) {
-//                nestedStartPos = nextStartPos;
-//            } else {
-//                endPos = nextEndPos;
-//                break;
-//            }
-//        }
-//
-//        if (endPos == std::string::npos || endPos <= startPos) break;
-//
-//        replacement = replacer(arg.substr(startPos, endPos - startPos + 2));
-//        if (replacement.empty()) {
-//            replacement = NULL_STR;
-//        }
-//        arg.replace(startPos, endPos - startPos + 2, replacement);
-//        if (arg == lastArg) {
-//            if (interpreterLogging) {
-//                disableLogging = false;
-//                logMessage("failed replacement arg: " + arg);
-//            }
-//            replacement = NULL_STR;
-//            arg.replace(startPos, endPos - startPos + 2, replacement);
-//            break;
-//        }
-//        lastArg = arg;
-//    }
-//};
+    // Check for empty JSON source strings
+    if (jsonStringOrPath.empty()) {
+        return;
+    }
+    // Use a unique_ptr to manage JSON object with appropriate deleter
+    std::unique_ptr<json_t, JsonDeleter> jsonData(nullptr, JsonDeleter());
+    // Convert JSON string or read from file based on the source type
+    if (sourceType == JSON_STR) {
+        jsonData.reset(stringToJson(jsonStringOrPath));
+    } else if (sourceType == JSON_FILE_STR) {
+        jsonData.reset(readJsonFromFile(jsonStringOrPath));
+    }
+    // Early return if jsonData is null or not an array
+    if (!jsonData) {
+        return;
+    }
+    
+    cJSON* jsonArray = reinterpret_cast<cJSON*>(jsonData.get());
+    if (!cJSON_IsArray(jsonArray)) {
+        return;
+    }
+    
+    // Prepare for efficient insertion
+    const int arraySize = cJSON_GetArraySize(jsonArray);
+    //selectedItemsList.reserve(arraySize);
+    
+    // Store the key as a const char* to avoid repeated c_str() calls
+    const char* jsonKeyCStr = jsonKey.c_str();
+    
+    // Iterate over the JSON array
+    for (int i = 0; i < arraySize; ++i) {
+        cJSON* item = cJSON_GetArrayItem(jsonArray, i);
+        if (cJSON_IsObject(item)) {
+            cJSON* keyValue = cJSON_GetObjectItemCaseSensitive(item, jsonKeyCStr);
+            if (cJSON_IsString(keyValue) && keyValue->valuestring) {
+                selectedItemsList.emplace_back(keyValue->valuestring);
+            }
+        }
+    }
+}
 
-// Finds the next occurrence of ANY function-style placeholder opener from `starts`,
-// beginning at `from`. On tie (same index), it prefers the LONGEST token.
-// Returns npos if none found, and sets matchedLen accordingly.
-static size_t findNextOpenToken(const std::string& s,
-                                size_t from,
-                                const std::vector<std::string>& starts,
-                                size_t& matchedLen)
-{
-    size_t bestPos = std::string::npos;
-    matchedLen = 0;
 
-    for (const auto& tok : starts) {
-        const size_t pos = s.find(tok, from);
-        if (pos == std::string::npos) continue;
+/**
+ * @brief Flat open-addressing set of path hashes.
+ *
+ * Only membership is tracked, so paths are reduced to 64-bit FNV-1a hashes and no
+ * strings are retained. Slots live in one power-of-two vector with linear probing;
+ * a zero slot marks an empty bucket (hash 0 is remapped to 1).
+ */
+class PathHashSet {
+public:
+    void reserve(size_t expectedCount) {
+        size_t capacity = 16;
+        while (capacity < expectedCount * 2)
+            capacity <<= 1;
+        if (capacity > slots.size())
+            rehash(capacity);
+    }
 
-        if (bestPos == std::string::npos || pos < bestPos ||
-            (pos == bestPos && tok.size() > matchedLen)) {
-            bestPos = pos;
-            matchedLen = tok.size();
+    void insert(std::string_view path) {
+        if ((count + 1) * 2 > slots.size())
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        if (placeHash(slots, hashPath(path)))
+            ++count;
+    }
+
+    bool contains(std::string_view path) const {
+        if (count == 0)
+            return false;
+        const u64 hash = hashPath(path);
+        const size_t mask = slots.size() - 1;
+        for (size_t i = static_cast<size_t>(hash) & mask; ; i = (i + 1) & mask) {
+            if (slots[i] == hash) return true;
+            if (slots[i] == 0) return false;
         }
     }
-    return bestPos;
-}
 
-// Starting at `startPos` which points to the FIRST character of the opener of the
-// CURRENT placeholder (e.g., the '{' in "{slice("), find the matching closing
-// pair for that placeholder. We count nested openers of ANY placeholder type
-// and match on ")}" closes.
-//
-// Return value: index of the ')' in the matching closing ")}" (so you can substr
-// with +2 to include ")}"). Returns npos if unmatched.
-static size_t findMatchingClose(const std::string& s,
-                                size_t startPos,
-                                const std::vector<std::string>& starts,
-                                size_t outerOpenLen)
-{
-    // We have already seen one opener at startPos
-    int depth = 1;
-    size_t scan = startPos + outerOpenLen;
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
 
-    size_t openLen;
-    bool openerFirst;
+    void clear() {
+        slots = {};
+        count = 0;
+    }
 
-    while (scan < s.size()) {
-        // Find next opener (any) and next closer ")}"
-        const size_t nextCloser = s.find(")}", scan);
+private:
+    std::vector<u64> slots;
+    size_t count = 0;
 
-        openLen = 0;
-        const size_t nextOpener = findNextOpenToken(s, scan, starts, openLen);
+    static u64 hashPath(std::string_view path) {
+        u64 hash = 0xcbf29ce484222325ULL;
+        for (const char c : path) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash ? hash : 1;
+    }
 
-        // Decide which token comes first
-        if (nextCloser == std::string::npos && nextOpener == std::string::npos) {
-            return std::string::npos; // no more tokens
+    // Returns false if the hash was already present
+    static bool placeHash(std::vector<u64>& table, u64 hash) {
+        const size_t mask = table.size() - 1;
+        for (size_t i = static_cast<size_t>(hash) & mask; ; i = (i + 1) & mask) {
+            if (table[i] == hash) return false;
+            if (table[i] == 0) {
+                table[i] = hash;
+                return true;
+            }
         }
+    }
 
-        openerFirst = false;
-        if (nextOpener != std::string::npos) {
-            if (nextCloser == std::string::npos) openerFirst = true;
-            else openerFirst = (nextOpener < nextCloser);
+    void rehash(size_t newCapacity) {
+        std::vector<u64> newSlots(newCapacity, 0);
+        for (const u64 hash : slots) {
+            if (hash != 0)
+                placeHash(newSlots, hash);
         }
+        slots.swap(newSlots);
+    }
+};
 
-        if (openerFirst) {
-            // Found a nested opener
-            ++depth;
-            scan = nextOpener + openLen; // continue after this opener
-        } else {
-            // Found a closer
-            --depth;
-            if (depth == 0) {
-                return nextCloser; // return index of ')'
-            }
-            scan = nextCloser + 2; // continue after ")}"
+
+/**
+ * @brief Natural ordering compare ("mod2" < "mod10").
+ *
+ * Runs of digits are compared by numeric value (leading zeros ignored, fewer zeros
+ * first on ties); all other bytes are compared as-is. Case folding is expected to
+ * be done by the caller once per key, not per comparison.
+ *
+ * @return <0, 0 or >0 like std::string::compare.
+ */
+int naturalCompare(std::string_view a, std::string_view b) {
+    size_t i = 0, j = 0;
+    size_t runStartA, runStartB, runEndA, runEndB, digitsA, digitsB;
+    int cmp;
+
+    while (i < a.size() && j < b.size()) {
+        const unsigned char ca = a[i];
+        const unsigned char cb = b[j];
+
+        if (std::isdigit(ca) && std::isdigit(cb)) {
+            runStartA = i;
+            runStartB = j;
+            while (runStartA < a.size() && a[runStartA] == '0') ++runStartA;
+            while (runStartB < b.size() && b[runStartB] == '0') ++runStartB;
+
+            runEndA = runStartA;
+            runEndB = runStartB;
+            while (runEndA < a.size() && std::isdigit(static_cast<unsigned char>(a[runEndA]))) ++runEndA;
+            while (runEndB < b.size() && std::isdigit(static_cast<unsigned char>(b[runEndB]))) ++runEndB;
+
+            // Longer significant digit run is the larger number
+            digitsA = runEndA - runStartA;
+            digitsB = runEndB - runStartB;
+            if (digitsA != digitsB)
+                return digitsA < digitsB ? -1 : 1;
+
+            cmp = a.substr(runStartA, digitsA).compare(b.substr(runStartB, digitsB));
+            if (cmp != 0)
+                return cmp;
+
+            // Same value, fewer leading zeros first
+            if ((runStartA - i) != (runStartB - j))
+                return (runStartA - i) < (runStartB - j) ? -1 : 1;
+
+            i = runEndA;
+            j = runEndB;
+            continue;
         }
+
+        if (ca != cb)
+            return ca < cb ? -1 : 1;
+        ++i;
+        ++j;
     }
 
-    return std::string::npos; // unmatched
+    const size_t remainingA = a.size() - i;
+    const size_t remainingB = b.size() - j;
+    if (remainingA == remainingB)
+        return 0;
+    return remainingA < remainingB ? -1 : 1;
 }
 
-bool replacePlaceholdersRecursively(
-    std::string& arg,
-    const std::vector<std::pair<std::string, std::function<std::string(const std::string&)>>>& placeholders)
-{
-    bool anyReplacementsMade = false;
 
-    // Precompute all opener tokens ("{slice(", "{math(", ...).
-    std::vector<std::string> starts;
-    starts.reserve(placeholders.size());
-    for (const auto& pr : placeholders) {
-        starts.push_back(pr.first);
+/**
+ * @brief Sorts file_source selection items by their grouping keys.
+ *
+ * Group and name keys are derived once per item (decorate), item indices are sorted
+ * on those keys, and the items are then moved into their final order (undecorate),
+ * so path parsing no longer happens inside the comparator.
+ *
+ * @param items Selection item paths, sorted in place.
+ * @param grouping The selection grouping ("split2", "split4", "split5" or any other).
+ * @param naturalOrder Compare keys case-folded with numeric runs ordered by value.
+ */
+void sortSelectionItems(std::vector<std::string>& items, const std::string& grouping, bool naturalOrder = false) {
+    const size_t itemCount = items.size();
+    if (itemCount < 2)
+        return;
+
+    struct SortKey {
+        std::string group;
+        std::string name;
+        bool hasSeparator = false;
+    };
+
+    const bool groupByParent = (grouping == "split2" || grouping == "split4");
+    const bool groupBySeparator = (grouping == "split5");
+
+    std::vector<SortKey> keys(itemCount);
+    size_t separatorPos;
+
+    for (size_t i = 0; i < itemCount; ++i) {
+        SortKey& key = keys[i];
+        if (groupBySeparator) {
+            // "Group - Name" parent folders: folders without a separator come first
+            key.group = getParentDirNameFromPath(items[i]);
+            removeQuotes(key.group);
+            separatorPos = key.group.find(" - ");
+            if (separatorPos != std::string::npos) {
+                key.hasSeparator = true;
+                key.name = key.group.substr(separatorPos + 3);
+                key.group.resize(separatorPos);
+            }
+        } else {
+            if (groupByParent)
+                key.group = getParentDirNameFromPath(items[i]);
+            key.name = getNameFromPath(items[i]);
+        }
+
+        if (naturalOrder) {
+            key.group = stringToLowercase(key.group);
+            key.name = stringToLowercase(key.name);
+        }
     }
 
-    bool replacedThisPass;
-    size_t searchPos;
-    std::string replacement;
-    std::string inner;
+    auto compareKeys = [naturalOrder](const std::string& a, const std::string& b) {
+        return naturalOrder ? naturalCompare(a, b) : a.compare(b);
+    };
 
-    // Keep sweeping until no replacements occur.
-    for (;;) {
-        replacedThisPass = false;
+    std::vector<size_t> order(itemCount);
+    std::iota(order.begin(), order.end(), 0);
+
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        const SortKey& a = keys[lhs];
+        const SortKey& b = keys[rhs];
+        if (a.hasSeparator != b.hasSeparator)
+            return !a.hasSeparator;
+        int cmp = compareKeys(a.group, b.group);
+        if (cmp != 0)
+            return cmp < 0;
+        cmp = compareKeys(a.name, b.name);
+        if (cmp != 0)
+            return cmp < 0;
+        return lhs < rhs; // keep equal keys in source order
+    });
 
-        // Try each placeholder type.
-        for (size_t t = 0; t < placeholders.size(); ++t) {
-            const auto& opener = placeholders[t].first;      // e.g., "{slice("
-            const auto& replacer = placeholders[t].second;
+    keys = {};
 
-            searchPos = 0;
+    std::vector<std::string> sortedItems;
+    sortedItems.reserve(itemCount);
+    for (const size_t index : order) {
+        sortedItems.push_back(std::move(items[index]));
+    }
+    items.swap(sortedItems);
+}
 
-            while (true) {
-                // Find the next occurrence of THIS opener
-                const size_t startPos = arg.find(opener, searchPos);
-                if (startPos == std::string::npos) break;
 
-                // Find its matching ")}" by counting nested ANY opener
-                const size_t closePos = findMatchingClose(arg, startPos, starts, opener.size());
-                if (closePos == std::string::npos) {
-                    // Unbalanced; skip this and move on to avoid infinite loop
-                    searchPos = startPos + opener.size();
-                    continue;
-                }
 
-                // Full placeholder text including wrapper: "{name(...)}"
-                const size_t fullLen = (closePos - startPos) + 2; // include the ")}"
-                const std::string placeholderText = arg.substr(startPos, fullLen);
+/**
+ * @brief Replaces a placeholder with a replacement string in the input.
+ *
+ * This function replaces all occurrences of a specified placeholder with the
+ * provided replacement string in the input string.
+ *
+ * @param input The input string.
+ * @param placeholder The placeholder to replace.
+ * @param replacement The string to replace the placeholder with.
+ * @return The input string with placeholders replaced by the replacement string.
+ */
+inline void applyPlaceholderReplacement(std::string& input, const std::string& placeholder, const std::string& replacement) {
+    const size_t pos = input.find(placeholder);
+    if (pos == std::string::npos) {
+        return;  // Returns original string directly if no placeholder is found
+    }
+    //std::string result = input;
+    input.replace(pos, placeholder.length(), replacement);
+    //return result;
+}
 
-                // Resolve INNER content first (exclude the outer wrapper)
-                const size_t innerStart = opener.size();
-                const size_t innerLen   = placeholderText.size() - innerStart - 2; // minus ")}"
-                inner = placeholderText.substr(innerStart, innerLen);
 
-                // Recurse on inner only (so we don't re-match the outer opener)
-                replacePlaceholdersRecursively(inner, placeholders);
 
-                // Rebuild the outer placeholder with resolved args
-                const std::string resolvedPlaceholder = opener + inner + ")}";
 
-                // Call the replacer on the resolved placeholder
-                replacement = replacer(resolvedPlaceholder);
-                if (replacement.empty()) {
-                    replacement = NULL_STR; // preserve your NULL_STR convention
-                }
+/**
+ * @brief Parsed placeholder sources shared by the entries of a command batch.
+ *
+ * While a batch is running (see interpretAndExecuteBatch), JSON documents and INI files referenced
+ * by placeholders are parsed once and reused across entries. File-backed entries remember the
+ * size and modification time they were parsed at, so a command that rewrites the file causes
+ * the next lookup to reload it. The INI and JSON write commands also drop the entry explicitly,
+ * since a same-size rewrite within the filesystem's timestamp granularity leaves the stamp unchanged.
+ */
+class BatchSourceCache {
+public:
+    json_t* json(const std::string& commandName, const std::string& jsonPathOrString) {
+        const bool fromFile = (commandName == "json_file" || commandName == "json_file_source");
+        if (!fromFile && commandName != "json" && commandName != "json_source")
+            return nullptr;
 
-                // Perform replacement if it changes anything
-                const std::string before = arg;
-                arg.replace(startPos, fullLen, replacement);
+        FileStamp stamp;
+        if (fromFile && !readStamp(jsonPathOrString, stamp))
+            return nullptr;
 
-                if (arg != before) {
-                    anyReplacementsMade = true;
-                    replacedThisPass = true;
-                    // Continue scanning after the replacement
-                    searchPos = startPos + replacement.size();
-                } else {
-                    // If nothing changed, advance to avoid re-hitting the same spot
-                    searchPos = startPos + opener.size();
-                }
-            }
+        auto& entry = jsonDocuments[jsonPathOrString];
+        if (!entry.document || (fromFile && entry.stamp != stamp)) {
+            entry.document.reset(fromFile ? readJsonFromFile(jsonPathOrString) : stringToJson(jsonPathOrString));
+            entry.stamp = stamp;
         }
+        return entry.document.get();
+    }
 
-        if (!replacedThisPass) break;
+    const tsl::hlp::ini::IniData* ini(const std::string& iniPath) {
+        FileStamp stamp;
+        if (!readStamp(iniPath, stamp))
+            return nullptr;
+
+        auto& entry = iniFiles[iniPath];
+        if (!entry.loaded || entry.stamp != stamp) {
+            entry.data = getParsedDataFromIniFile(iniPath);
+            entry.sectionNames = parseSectionsFromIni(iniPath);
+            entry.stamp = stamp;
+            entry.loaded = true;
+        }
+        return &entry.data;
     }
 
-    return anyReplacementsMade;
-}
+    const std::vector<std::string>* iniSections(const std::string& iniPath) {
+        if (!ini(iniPath))
+            return nullptr;
+        return &iniFiles[iniPath].sectionNames;
+    }
 
+    // Forgets any parsed copy of path so the next lookup reads it again
+    void invalidate(const std::string& path) {
+        jsonDocuments.erase(path);
+        iniFiles.erase(path);
+    }
 
+    void clear() {
+        jsonDocuments.clear();
+        iniFiles.clear();
+    }
 
-std::unordered_map<std::string, std::string> generalPlaceholders;
-void updateGeneralPlaceholders() {
-    generalPlaceholders = {
-        {"{ram_vendor}", memoryVendor},
-        {"{ram_model}", memoryModel},
-        {"{ams_version}", amsVersion},
-        {"{hos_version}", hosVersion},
-        {"{cpu_speedo}", ult::to_string(cpuSpeedo0)},
-        {"{cpu_iddq}", ult::to_string(cpuIDDQ)},
-        {"{gpu_speedo}", ult::to_string(cpuSpeedo2)},
-        {"{gpu_iddq}", ult::to_string(gpuIDDQ)},
-        {"{soc_speedo}", ult::to_string(socSpeedo0)},
-        {"{soc_iddq}", ult::to_string(socIDDQ)},
-        {"{title_id}", getTitleIdAsString()},
-        {"{build_id}", getBuildIdAsString()},
-        {"{local_ip}", getLocalIpAddress()}
+private:
+    struct FileStamp {
+        off_t size = 0;
+        time_t mtime = 0;
+        bool operator!=(const FileStamp& other) const { return size != other.size || mtime != other.mtime; }
     };
-}
 
-bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::string& hexPath, const std::string& iniPath, const std::string& listString, const std::string& listPath, const std::string& jsonString, const std::string& jsonPath) {
-    bool replacementsMade = false;
+    struct JsonEntry {
+        std::unique_ptr<json_t, JsonDeleter> document;
+        FileStamp stamp;
+    };
+
+    struct IniEntry {
+        tsl::hlp::ini::IniData data;
+        std::vector<std::string> sectionNames;
+        FileStamp stamp;
+        bool loaded = false;
+    };
+
+    static bool readStamp(const std::string& path, FileStamp& stamp) {
+        struct stat fileInfo;
+        if (stat(path.c_str(), &fileInfo) != 0)
+            return false;
+        stamp.size = fileInfo.st_size;
+        stamp.mtime = fileInfo.st_mtime;
+        return true;
+    }
+
+    std::unordered_map<std::string, JsonEntry> jsonDocuments;
+    std::unordered_map<std::string, IniEntry> iniFiles;
+};
+
+// Set only while interpretAndExecuteBatch is running, and only visible to the thread running it
+static thread_local BatchSourceCache* activeBatchCache = nullptr;
+
+
+void applyReplaceIniPlaceholder(std::string& arg, const std::string& commandName, const std::string& iniPath) {
+    const std::string searchString = "{" + commandName + "(";
     
-    std::vector<std::pair<std::string, std::function<std::string(const std::string&)>>> placeholders = {
-        {"{hex_file(", [&](const std::string& placeholder) { return returnOrNull(replaceHexPlaceholder(placeholder, hexPath)); }},
-        {"{ini_file(", [&](const std::string& placeholder) { 
-            std::string result = placeholder;
-            applyReplaceIniPlaceholder(result, INI_FILE_STR, iniPath); 
-            return returnOrNull(result); 
-        }},
-        {"{list(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find('(') + 1;
-            const std::string indexStr = placeholder.substr(startPos, placeholder.find(')') - startPos);
-            if (!isValidNumber(indexStr)) {
-                return NULL_STR;
-            }
-            return returnOrNull(stringToList(listString)[ult::stoi(indexStr)]);
-        }},
-        {"{list_file(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find('(') + 1;
-            std::string indexStr = placeholder.substr(startPos, placeholder.find(')') - startPos);
-            if (!isValidNumber(indexStr)) {
-                return NULL_STR;
-            }
-            return returnOrNull(getEntryFromListFile(listPath, ult::stoi(indexStr)));
-        }},
-        {"{json(", [&](const std::string& placeholder) { return replaceJsonPlaceholder(placeholder, JSON_STR, jsonString); }},
-        {"{json_file(", [&](const std::string& placeholder) { return replaceJsonPlaceholder(placeholder, JSON_FILE_STR, jsonPath); }},
-        {"{timestamp(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find("(") + 1;
-            const size_t endPos = placeholder.find(")");
-            std::string format = (endPos != std::string::npos) ? placeholder.substr(startPos, endPos - startPos) : "%Y-%m-%d %H:%M:%S";
-            removeQuotes(format);
-            return returnOrNull(getCurrentTimestamp(format));
-        }},
-        {"{decimal_to_hex(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find("(") + 1;
-            const std::string params = placeholder.substr(startPos, placeholder.find(")") - startPos);
-            
-            const size_t commaPos = params.find(",");
-            std::string decimalValue;
-            std::string order;
+    // Early exit: Check if placeholder pattern exists before doing any INI work
+    if (arg.find(searchString) == std::string::npos) {
+        return; // No placeholders found, nothing to do
+    }
+    
+    // Pre-declare variables outside the loop
+    size_t startPos = 0;
+    size_t endPos;
+    size_t commaPos;
+    size_t entryIndex;
+    std::string placeholderContent;
+    std::string replacement;
+    std::string iniSection;
+    std::string iniKey;
+    
+    // Cache section names to avoid re-parsing INI file multiple times
+    std::vector<std::string> sectionNames;
+    bool sectionsLoaded = false;
+    
+    // Build result incrementally to avoid expensive string replacement operations
+    std::string result;
+    size_t lastPos = 0;
+    const size_t searchStringLen = searchString.length();
+    
+    // Process all occurrences of the placeholder
+    while ((startPos = arg.find(searchString, lastPos)) != std::string::npos) {
+        endPos = arg.find(")}", startPos);
+        if (endPos == std::string::npos || endPos <= startPos) {
+            // Invalid placeholder, append text up to this point and continue searching
+            result.append(arg, lastPos, startPos + searchStringLen - lastPos);
+            lastPos = startPos + searchStringLen;
+            continue;
+        }
+        
+        // Append text before placeholder
+        result.append(arg, lastPos, startPos - lastPos);
+        
+        placeholderContent = arg.substr(startPos + searchStringLen, 
+                                       endPos - startPos - searchStringLen);
+        trim(placeholderContent);
+        
+        commaPos = placeholderContent.find(',');
+        
+        if (commaPos != std::string::npos) {
+            // Handle section,key format
+            iniSection = placeholderContent.substr(0, commaPos);
+            trim(iniSection);
+            removeQuotes(iniSection);
             
-            if (commaPos != std::string::npos) {
-                decimalValue = params.substr(0, commaPos);
-                order = params.substr(commaPos + 1);
-                order.erase(0, order.find_first_not_of(" \t\n\r"));
-                order.erase(order.find_last_not_of(" \t\n\r") + 1);
-            } else {
-                decimalValue = params;
-                order = "";
-            }
+            iniKey = placeholderContent.substr(commaPos + 1);
+            trim(iniKey);
+            removeQuotes(iniKey);
             
-            if (order.empty()) {
-                return returnOrNull(decimalToHex(decimalValue));
-            } else {
-                if (!isValidNumber(order)) {
-                    return NULL_STR;
+            if (activeBatchCache) {
+                const auto* iniData = activeBatchCache->ini(iniPath);
+                replacement = NULL_STR;
+                if (iniData) {
+                    const auto sectionIt = iniData->find(iniSection);
+                    if (sectionIt != iniData->end()) {
+                        const auto keyIt = sectionIt->second.find(iniKey);
+                        if (keyIt != sectionIt->second.end())
+                            replacement = returnOrNull(keyIt->second);
+                    }
                 }
-                return returnOrNull(decimalToHex(decimalValue, ult::stoi(order)));
+            } else {
+                replacement = returnOrNull(parseValueFromIniSection(iniPath, iniSection, iniKey));
             }
-        }},
-        {"{ascii_to_hex(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find("(") + 1;
-            //size_t endPos = placeholder.find(")");
-            //std::string asciiValue = placeholder.substr(startPos, placeholder.find(")") - startPos);
-            return returnOrNull(asciiToHex(placeholder.substr(startPos, placeholder.find(")") - startPos)));
-        }},
-        {"{hex_to_rhex(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find("(") + 1;
-            //size_t endPos = placeholder.find(")");
-            //std::string hexValue = placeholder.substr(startPos, placeholder.find(")") - startPos);
-            return returnOrNull(hexToReversedHex(placeholder.substr(startPos, placeholder.find(")") - startPos)));
-        }},
-        {"{hex_to_decimal(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find("(") + 1;
-            //size_t endPos = placeholder.find(")");
-            //std::string hexValue = placeholder.substr(startPos, placeholder.find(")") - startPos);
-            return returnOrNull(hexToDecimal(placeholder.substr(startPos, placeholder.find(")") - startPos)));
-        }},
-        {"{random(", [&](const std::string& placeholder) {
-            std::srand(std::time(0));
-            
-            const size_t startPos = placeholder.find('(') + 1;
-            const size_t endPos = placeholder.find(')');
-            const std::string parameters = placeholder.substr(startPos, endPos - startPos);
-            const size_t commaPos = parameters.find(',');
-            
-            if (commaPos != std::string::npos) {
-                std::string lowStr = parameters.substr(0, commaPos);
-                std::string highStr = parameters.substr(commaPos + 1);
-                
-                if (!isValidNumber(lowStr) || !isValidNumber(highStr)) {
-                    return NULL_STR;
+        } else {
+            // Check if the content is an integer
+            if (std::all_of(placeholderContent.begin(), placeholderContent.end(), ::isdigit)) {
+                if (!isValidNumber(placeholderContent)) {
+                    replacement = NULL_STR;
+                } else {
+                    entryIndex = ult::stoi(placeholderContent);
+                    
+                    // Load section names only once when needed
+                    if (!sectionsLoaded) {
+                        const auto* cachedSections = activeBatchCache ? activeBatchCache->iniSections(iniPath) : nullptr;
+                        sectionNames = cachedSections ? *cachedSections : parseSectionsFromIni(iniPath);
+                        sectionsLoaded = true;
+                    }
+                    
+                    if (entryIndex < sectionNames.size()) {
+                        replacement = sectionNames[entryIndex];
+                    } else {
+                        replacement = NULL_STR;
+                    }
                 }
-                
-                const int lowValue = ult::stoi(lowStr);
-                const int highValue = ult::stoi(highStr);
-                return returnOrNull(ult::to_string(lowValue + rand() % (highValue - lowValue + 1)));
-            }
-            return returnOrNull(placeholder);
-        }},
-        {"{slice(", [&](const std::string& placeholder) {
-            const size_t startPos = placeholder.find('(');
-            const size_t endPos = placeholder.rfind(')');
-            if (startPos == std::string::npos || endPos == std::string::npos || endPos <= startPos + 1) {
-                return NULL_STR;
+            } else {
+                replacement = NULL_STR;
             }
+        }
         
-            const std::string parameters = placeholder.substr(startPos + 1, endPos - startPos - 1);
-            const size_t firstComma = parameters.find(',');
-            const size_t secondComma = (firstComma == std::string::npos) ? std::string::npos : parameters.find(',', firstComma + 1);
-            if (firstComma == std::string::npos || secondComma == std::string::npos) {
-                return NULL_STR;
+        // Append the replacement
+        result.append(replacement);
+        
+        // Update lastPos to continue after this placeholder
+        lastPos = endPos + 2;
+    }
+    
+    // Append remaining text after last placeholder
+    result.append(arg, lastPos);
+    
+    // Replace original string with result
+    arg = std::move(result);
+}
+
+
+/**
+ * @brief Replaces a JSON source placeholder with the actual JSON source.
+ *
+ * Optimized version with variables moved to usage scope to avoid repeated allocations.
+ *
+ * @param arg The input string containing the placeholder.
+ * @param commandName The name of the JSON command (e.g., "json", "json_file").
+ * @param jsonPathOrString The path to the JSON file or the JSON string itself.
+ * @return std::string The input string with the placeholder replaced by the actual JSON source,
+ *                   or the original input string if replacement failed or jsonDict is nullptr.
+ */
+/**
+ * @brief Replaces a JSON source placeholder with the actual JSON source.
+ *
+ * Optimized version with variables moved outside loops to avoid repeated allocations.
+ *
+ * @param arg The input string containing the placeholder.
+ * @param commandName The name of the JSON command (e.g., "json", "json_file").
+ * @param jsonPathOrString The path to the JSON file or the JSON string itself.
+ * @return std::string The input string with the placeholder replaced by the actual JSON source,
+ *                   or the original input string if replacement failed or jsonDict is nullptr.
+ */
+std::string replaceJsonPlaceholder(const std::string& arg, const std::string& commandName, const std::string& jsonPathOrString) {
+    // Early exit: Check if placeholder pattern exists before doing any JSON work
+    const std::string searchString = "{" + commandName + "(";
+    if (arg.find(searchString) == std::string::npos) {
+        return arg; // No placeholders found, return original
+    }
+    
+    // Load JSON data only if we have placeholders to process (batches reuse their parsed copy)
+    std::unique_ptr<json_t, JsonDeleter> jsonDict;
+    json_t* jsonRoot = nullptr;
+    if (activeBatchCache) {
+        jsonRoot = activeBatchCache->json(commandName, jsonPathOrString);
+    } else {
+        if (commandName == "json" || commandName == "json_source") {
+            jsonDict.reset(stringToJson(jsonPathOrString));
+        } else if (commandName == "json_file" || commandName == "json_file_source") {
+            jsonDict.reset(readJsonFromFile(jsonPathOrString));
+        }
+        jsonRoot = jsonDict.get();
+    }
+    if (!jsonRoot) {
+        return arg; // Return original string if JSON data couldn't be loaded
+    }
+    
+    // Build result incrementally to avoid expensive string replacement operations
+    std::string result;
+    
+    size_t lastPos = 0;
+    size_t startPos = arg.find(searchString);
+    
+    const size_t searchStringLen = searchString.length();
+    
+    // Pre-declare variables outside loops to avoid repeated allocations
+    size_t endPos, nextPos, commaPos, index;
+    std::string key;
+    bool validValue;
+    
+    while (startPos != std::string::npos) {
+        endPos = arg.find(")}", startPos);
+        if (endPos == std::string::npos) {
+            break; // Break if no closing tag is found
+        }
+        
+        // Append text before placeholder
+        result.append(arg, lastPos, startPos - lastPos);
+        
+        nextPos = startPos + searchStringLen;
+        cJSON* value = reinterpret_cast<cJSON*>(jsonRoot); // Get the JSON root object
+        validValue = true;
+        
+        while (nextPos < endPos && validValue) {
+            commaPos = arg.find(',', nextPos);
+            if (commaPos == std::string::npos || commaPos > endPos) {
+                commaPos = endPos; // Set to endPos if no comma is found or it's beyond endPos
+            }
+            
+            // Reuse string capacity for key
+            key.assign(arg, nextPos, commaPos - nextPos);
+            
+            if (cJSON_IsObject(value)) {
+                value = cJSON_GetObjectItemCaseSensitive(value, key.c_str()); // Navigate through object
+            } else if (cJSON_IsArray(value)) {
+                index = std::stoul(key); // Convert key to index for arrays
+                value = cJSON_GetArrayItem(value, index);
+            } else {
+                validValue = false; // Set validValue to false if value is neither object nor array
+            }
+            nextPos = commaPos + 1; // Move next position past the comma
+        }
+        
+        if (validValue && value && cJSON_IsString(value) && value->valuestring) {
+            result.append(value->valuestring); // Append replacement value
+        } else {
+            // If replacement failed, keep the original placeholder
+            //result.append(arg, startPos, endPos + 2 - startPos);
+            result.append(NULL_STR);
+        }
+        
+        lastPos = endPos + 2;
+        startPos = arg.find(searchString, lastPos); // Find next occurrence from last position
+    }
+    
+    // Append remaining text after last placeholder
+    result.append(arg, lastPos);
+    
+    return result; // Return the modified string
+}
+
+// Helper function to replace placeholders
+void replaceAllPlaceholders(std::string& source, const std::string& placeholder, const std::string& replacement) {
+    //std::string modifiedArg = source;
+    std::string lastArg;
+    while (source.find(placeholder) != std::string::npos) {
+        //modifiedArg = replacePlaceholder(modifiedArg, placeholder, replacement);
+        applyPlaceholderReplacement(source, placeholder, replacement);
+        if (source == lastArg)
+            break;
+        lastArg = source;
+    }
+    return;
+}
+
+
+
+// Helper function to replace all placeholders in a single pass
+bool replacePlaceholdersInArg(std::string& source, const std::unordered_map<std::string, std::string>& replacements) {
+    bool replaced = false;
+    size_t pos;
+    for (const auto& [placeholder, replacement] : replacements) {
+        pos = 0;
+        while ((pos = source.find(placeholder, pos)) != std::string::npos) {
+            source.replace(pos, placeholder.length(), replacement);
+            pos += replacement.length();  // Move past the replacement to avoid infinite loop
+            replaced = true;
+        }
+    }
+    return replaced;
+}
+
+
+// Optimized getSourceReplacement function
+std::vector<std::vector<std::string>> getSourceReplacement(const std::vector<std::vector<std::string>>& commands,
+    const std::string& entry, size_t entryIndex, const std::string& packagePath = "") {
+
+    bool inEristaSection = false;
+    bool inMarikoSection = false;
+
+    std::vector<std::vector<std::string>> modifiedCommands;
+    std::string listString, listPath, jsonString, jsonPath, iniPath;
+    bool usingFileSource = false;
+
+    std::string fileName = getNameFromPath(entry);
+    if (!isDirectory(entry)) {
+        dropExtension(fileName);
+    }
+
+    std::vector<std::string> modifiedCmd;
+    std::string commandName;
+    std::string modifiedArg;
+    size_t startPos, endPos;
+    std::string replacement;
+
+    std::string path;
+    std::string raw;
+
+    const std::string indexStr = ult::to_string(entryIndex);
+
+    for (const auto& cmd : commands) {
+        if (cmd.empty()) {
+            continue;
+        }
+
+        modifiedCmd.clear();
+        //modifiedCmd.shrink_to_fit();
+        //modifiedCmd.reserve(cmd.size());
+        commandName = cmd[0];
+
+        if (commandName == "download" || commandName == "download-unzip") {
+            isDownloadCommand.store(true, std::memory_order_release);
+        }
+
+        if (stringToLowercase(commandName) == "erista:") {
+            inEristaSection = true;
+            inMarikoSection = false;
+            continue;
+        } else if (stringToLowercase(commandName) == "mariko:") {
+            inEristaSection = false;
+            inMarikoSection = true;
+            continue;
+        }
+
+        if ((inEristaSection && usingErista) ||
+            (inMarikoSection && usingMariko) ||
+            (!inEristaSection && !inMarikoSection))
+        {
+            // Apply placeholder replacements if necessary
+            for (const auto& arg : cmd) {
+                modifiedArg = arg;
+
+                if (commandName == "file_source") {
+                    usingFileSource = true;
+                }
+                else if (commandName == "list_source" && listString.empty()) {
+                    listString = cmd[1];
+                    removeQuotes(listString);
+                }
+                else if (commandName == "list_file_source" && listPath.empty()) {
+                    listPath = cmd[1];
+                    preprocessPath(listPath, packagePath);
+                }
+                else if (commandName == "ini_file_source" && iniPath.empty()) {
+                    iniPath = cmd[1];
+                    preprocessPath(iniPath, packagePath);
+                }
+                else if (commandName == "json_source" && jsonString.empty()) {
+                    jsonString = cmd[1];
+                }
+                else if (commandName == "json_file_source" && jsonPath.empty()) {
+                    jsonPath = cmd[1];
+                    preprocessPath(jsonPath, packagePath);
+                }
+
+                // These three always apply
+                replaceAllPlaceholders(modifiedArg, "{file_source}", entry);
+                replaceAllPlaceholders(modifiedArg, "{file_name}", fileName);
+                path = getParentDirNameFromPath(entry);
+                removeQuotes(path);
+                replaceAllPlaceholders(modifiedArg, "{folder_name}", path);
+                replaceAllPlaceholders(modifiedArg, "{index}", indexStr);
+
+                // {list_source(...)} block
+                if (modifiedArg.find("{list_source(") != std::string::npos) {
+                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
+                    startPos = modifiedArg.find("{list_source(");
+                    endPos   = modifiedArg.find(")}");
+                    if (endPos != std::string::npos && endPos > startPos) {
+                        // SAFE: Use at() which does bounds checking, or catch the access
+                        const auto& listItems = stringToList(listString);  // const reference - no copy
+                        raw = (entryIndex < listItems.size()) ? listItems[entryIndex] : "";
+                        replacement = returnOrNull(raw);
+                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
+                    }
+                }
+
+                // {list_file_source(...)} block
+                if (modifiedArg.find("{list_file_source(") != std::string::npos) {
+                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
+                    startPos = modifiedArg.find("{list_file_source(");
+                    endPos   = modifiedArg.find(")}");
+                    if (endPos != std::string::npos && endPos > startPos) {
+                        raw = getEntryFromListFile(listPath, entryIndex);
+                        replacement = returnOrNull(raw);
+                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
+                    }
+                }
+
+                // {ini_file_source(...)} block - FIXED
+                if (modifiedArg.find("{ini_file_source(") != std::string::npos) {
+                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
+                    // applyReplaceIniPlaceholder modifies modifiedArg in place, so we just call it
+                    applyReplaceIniPlaceholder(modifiedArg, "ini_file_source", iniPath);
+                    // No additional replacement needed!
+                }
+
+                // {json_source(...)} block
+                if (modifiedArg.find("{json_source(") != std::string::npos) {
+                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
+                    startPos = modifiedArg.find("{json_source(");
+                    endPos   = modifiedArg.find(")}");
+                    if (endPos != std::string::npos && endPos > startPos) {
+                        raw = replaceJsonPlaceholder(
+                            modifiedArg.substr(startPos, endPos - startPos + 2),
+                            "json_source",
+                            jsonString
+                        );
+                        replacement = returnOrNull(raw);
+                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
+                    }
+                }
+
+                // {json_file_source(...)} block
+                if (modifiedArg.find("{json_file_source(") != std::string::npos) {
+                    applyPlaceholderReplacement(modifiedArg, "*", indexStr);
+                    startPos = modifiedArg.find("{json_file_source(");
+                    endPos   = modifiedArg.find(")}");
+                    if (endPos != std::string::npos && endPos > startPos) {
+                        raw = replaceJsonPlaceholder(
+                            modifiedArg.substr(startPos, endPos - startPos + 2),
+                            "json_file_source",
+                            jsonPath
+                        );
+                        replacement = returnOrNull(raw);
+                        modifiedArg.replace(startPos, endPos - startPos + 2, replacement);
+                    }
+                }
+
+                modifiedCmd.push_back(std::move(modifiedArg));
+            }
+
+            modifiedCommands.emplace_back(std::move(modifiedCmd));
+        }
+    }
+
+    if (usingFileSource) {
+        modifiedCommands.insert(modifiedCommands.begin(), { "file_name", fileName });
+        modifiedCommands.insert(modifiedCommands.begin(), { "folder_name", path });
+        modifiedCommands.insert(modifiedCommands.begin(), { "sourced_path", entry });
+    }
+
+    return modifiedCommands;
+}
+
+
+std::string getCurrentTimestamp(const std::string& format) {
+    // Try using standard POSIX time() function
+    time_t seconds = time(nullptr);
+    const u32 milliseconds = (armTicksToNs(armGetSystemTick()) / 1000000ULL) % 1000; // We lose millisecond precision with this method
+    
+    // If you need milliseconds, try to get them from system tick
+    //u64 tick_ns = armTicksToNs(armGetSystemTick());
+    //milliseconds = (armTicksToNs(armGetSystemTick()) / 1000000ULL) % 1000;
+    
+    std::string modifiedFormat = format;
+    bool hasMilliseconds = false;
+    
+    const size_t pos = modifiedFormat.find("%f");
+    if (pos != std::string::npos) {
+        modifiedFormat.erase(pos, 2);
+        hasMilliseconds = true;
+    }
+    
+    char buffer[30];
+    if (!std::strftime(buffer, sizeof(buffer), modifiedFormat.c_str(), std::localtime(&seconds))) {
+        return "";
+    }
+    
+    std::string formattedTime(buffer);
+    StringStream oss;
+    
+    if (formattedTime.find("%s") != std::string::npos) {
+        oss << static_cast<long long>(seconds); 
+        formattedTime.replace(formattedTime.find("%s"), 2, oss.str());
+        oss.clear();
+    }
+    
+    if (hasMilliseconds) {
+        std::string millisecondsStr = ult::to_string(milliseconds);
+        if (millisecondsStr.length() < 3) {
+            millisecondsStr.insert(0, 3 - millisecondsStr.length(), '0');
+        }
+        if (pos > 0 && format[pos - 1] == '.') {
+            formattedTime += millisecondsStr;
+        } else {
+            formattedTime += "." + millisecondsStr;
+        }
+    }
+    
+    return formattedTime;
+}
+
+
+
+
+
+// Helper function to skip spaces
+void skipSpaces(const std::string& expression, size_t& pos) {
+    while (pos < expression.length() && std::isspace(expression[pos])) {
+        ++pos;
+    }
+}
+
+// Helper function to parse a number or a nested expression in parentheses
+double parseExpression(const std::string& expression, size_t& pos, bool& valid);
+
+double parseNumber(const std::string& expression, size_t& pos, bool& valid) {
+    skipSpaces(expression, pos);
+
+    // Check if the expression starts with a '(' indicating a nested expression
+    if (expression[pos] == '(') {
+        ++pos;  // Skip the '('
+        const double result = parseExpression(expression, pos, valid);
+        if (expression[pos] == ')') {
+            ++pos;  // Skip the ')'
+        } else {
+            valid = false;  // Unmatched parentheses
+        }
+        return result;
+    }
+
+    // Parse a number
+    double result = 0.0f;
+    bool hasDecimal = false;
+    double decimalPlace = 0.1f;
+    bool isNegative = false;
+
+    if (expression[pos] == '-') {
+        isNegative = true;
+        ++pos;
+    }
+
+    while (pos < expression.length() && (std::isdigit(expression[pos]) || expression[pos] == '.')) {
+        if (expression[pos] == '.') {
+            hasDecimal = true;
+            ++pos;
+            continue;
+        }
+
+        if (hasDecimal) {
+            result += (expression[pos] - '0') * decimalPlace;
+            decimalPlace *= 0.1f;
+        } else {
+            result = result * 10.0f + (expression[pos] - '0');
+        }
+        ++pos;
+    }
+
+    if (isNegative) {
+        result = -result;
+    }
+
+    valid = true;
+    return result;
+}
+
+// Function to evaluate an expression, which may include parentheses
+double parseExpression(const std::string& expression, size_t& pos, bool& valid) {
+    skipSpaces(expression, pos);
+
+    double result = parseNumber(expression, pos, valid);
+    if (!valid) return 0;
+
+    char op;
+    double operand;
+    while (pos < expression.length()) {
+        skipSpaces(expression, pos);
+        if (pos >= expression.length()) break;
+
+        op = expression[pos++];
+        skipSpaces(expression, pos);
+
+        operand = parseNumber(expression, pos, valid);
+        if (!valid) return 0;
+
+        switch (op) {
+            case '+':
+                result += operand;
+                break;
+            case '-':
+                result -= operand;
+                break;
+            case '*':
+                result *= operand;
+                break;
+            case '/':
+                if (operand == 0) {
+                    valid = false;  // Division by zero
+                    return 0;
+                }
+                result /= operand;
+                break;
+            case '%':
+                if (STBTT_fmod(result, 1.0f) != 0.0f || STBTT_fmod(operand, 1.0f) != 0.0f) {
+                    valid = false;  // Modulus only valid for integers
+                    return 0;
+                }
+                result = static_cast<int>(result) % static_cast<int>(operand);
+                break;
+            default:
+                valid = false;
+                return 0;
+        }
+    }
+
+    valid = true;
+    return result;
+}
+
+// Function to evaluate a complete expression (this will call parseExpression)
+double evaluateExpression(const std::string& expression, bool& valid) {
+    size_t pos = 0;
+    return parseExpression(expression, pos, valid);
+}
+
+// Handle Math Placeholder with Parentheses, Modulus, and Optional Integer Support
+std::string handleMath(const std::string& placeholder) {
+    const size_t startPos = placeholder.find('(') + 1;
+    const size_t endPos = placeholder.find(')');
+
+    if (startPos == std::string::npos || endPos == std::string::npos || startPos >= endPos) {
+        return NULL_STR;
+    }
+
+    std::string mathExpression = placeholder.substr(startPos, endPos - startPos);
+    removeQuotes(mathExpression);
+
+    const size_t commaPos = mathExpression.find(',');
+    bool forceInteger = false;
+
+    if (commaPos != std::string::npos) {
+        std::string secondParam = mathExpression.substr(commaPos + 1);
+        trim(secondParam);
+        forceInteger = (secondParam == TRUE_STR);
+        mathExpression = mathExpression.substr(0, commaPos);
+    }
+
+    size_t pos;
+    // Add spaces around operators to ensure proper parsing
+    for (const char op : {'+', '-', '*', '/'}) {
+        pos = 0;
+        while ((pos = mathExpression.find(op, pos)) != std::string::npos) {
+            if (pos > 0 && mathExpression[pos - 1] != ' ') {
+                mathExpression.insert(pos, " ");
+                pos++;
+            }
+            if (pos + 1 < mathExpression.size() && mathExpression[pos + 1] != ' ') {
+                mathExpression.insert(pos + 1, " ");
+            }
+            pos += 2; // Move past the operator and space
+        }
+    }
+
+    bool valid = false;
+    const double result = evaluateExpression(mathExpression, valid);
+
+    if (!valid) {
+        return NULL_STR;
+    }
+
+    // Format the result with StringStream
+    StringStream oss;
+    if (forceInteger || STBTT_fmod(result, 1.0) == 0.0) {
+        oss << static_cast<int>(result);  // Integer output if required
+    } else {
+        // Manually format to two decimal places for double output
+        const int intPart = static_cast<int>(result);
+        const int decimalPart = static_cast<int>((result - intPart) * 100);  // Get two decimal places
+
+        oss << intPart << ".";
+
+        // Handle cases where decimal part has only one digit (e.g., 3.1 should be 3.10)
+        if (decimalPart < 10) {
+            oss << "0";
+        }
+        oss << decimalPart;
+    }
+
+    return oss.str();
+}
+
+
+std::string handleLength(const std::string& placeholder) {
+    const size_t startPos = placeholder.find('(') + 1;
+    const size_t endPos = placeholder.find(')');
+    
+    if (startPos != std::string::npos && endPos != std::string::npos && endPos > startPos) {
+        std::string str = placeholder.substr(startPos, endPos - startPos);
+        trim(str);  // Remove any extra spaces
+        removeQuotes(str);  // If your strings are wrapped in quotes, remove them
+        
+        // Return the length of the string as a string
+        return ult::to_string(str.length());
+    }
+    
+    return placeholder;  // If invalid, return the original placeholder
+}
+
+
+
+// Define the replacePlaceholders function outside of applyPlaceholderReplacements
+//auto replacePlaceholders = [](std::string& arg, const std::string& placeholder, const std::function<std::string(const std::string&)>& replacer) {
+//    size_t startPos, endPos;
+//    std::string lastArg, replacement;
+//
+//    size_t nestedStartPos, nextStartPos, nextEndPos;
+//
+//    while ((startPos = arg.find(placeholder)) != std::string::npos) {
+//        nestedStartPos = startPos;
+//        while (true) {
+//            nextStartPos = arg.find(placeholder, nestedStartPos + 1);
+//            nextEndPos = arg.find(")}", nestedStartPos);
+//            if (nextStartPos != std::string::npos && nextStartPos < nextEndPos) {
+//                nestedStartPos = nextStartPos;
+//            } else {
+//                endPos = nextEndPos;
+//                break;
+//            }
+//        }
+//
+//        if (endPos == std::string::npos || endPos <= startPos) break;
+//
+//        replacement = replacer(arg.substr(startPos, endPos - startPos + 2));
+//        if (replacement.empty()) {
+//            replacement = NULL_STR;
+//        }
+//        arg.replace(startPos, endPos - startPos + 2, replacement);
+//        if (arg == lastArg) {
+//            if (interpreterLogging) {
+//                disableLogging = false;
+//                logMessage("failed replacement arg: " + arg);
+//            }
+//            replacement = NULL_STR;
+//            arg.replace(startPos, endPos - startPos + 2, replacement);
+//            break;
+//        }
+//        lastArg = arg;
+//    }
+//};
+
+// Finds the next occurrence of ANY function-style placeholder opener from `starts`,
+// beginning at `from`. On tie (same index), it prefers the LONGEST token.
+// Returns npos if none found, and sets matchedLen accordingly.
+static size_t findNextOpenToken(const std::string& s,
+                                size_t from,
+                                const std::vector<std::string>& starts,
+                                size_t& matchedLen)
+{
+    size_t bestPos = std::string::npos;
+    matchedLen = 0;
+
+    for (const auto& tok : starts) {
+        const size_t pos = s.find(tok, from);
+        if (pos == std::string::npos) continue;
+
+        if (bestPos == std::string::npos || pos < bestPos ||
+            (pos == bestPos && tok.size() > matchedLen)) {
+            bestPos = pos;
+            matchedLen = tok.size();
+        }
+    }
+    return bestPos;
+}
+
+// Starting at `startPos` which points to the FIRST character of the opener of the
+// CURRENT placeholder (e.g., the '{' in "{slice("), find the matching closing
+// pair for that placeholder. We count nested openers of ANY placeholder type
+// and match on ")}" closes.
+//
+// Return value: index of the ')' in the matching closing ")}" (so you can substr
+// with +2 to include ")}"). Returns npos if unmatched.
+static size_t findMatchingClose(const std::string& s,
+                                size_t startPos,
+                                const std::vector<std::string>& starts,
+                                size_t outerOpenLen)
+{
+    // We have already seen one opener at startPos
+    int depth = 1;
+    size_t scan = startPos + outerOpenLen;
+
+    size_t openLen;
+    bool openerFirst;
+
+    while (scan < s.size()) {
+        // Find next opener (any) and next closer ")}"
+        const size_t nextCloser = s.find(")}", scan);
+
+        openLen = 0;
+        const size_t nextOpener = findNextOpenToken(s, scan, starts, openLen);
+
+        // Decide which token comes first
+        if (nextCloser == std::string::npos && nextOpener == std::string::npos) {
+            return std::string::npos; // no more tokens
+        }
+
+        openerFirst = false;
+        if (nextOpener != std::string::npos) {
+            if (nextCloser == std::string::npos) openerFirst = true;
+            else openerFirst = (nextOpener < nextCloser);
+        }
+
+        if (openerFirst) {
+            // Found a nested opener
+            ++depth;
+            scan = nextOpener + openLen; // continue after this opener
+        } else {
+            // Found a closer
+            --depth;
+            if (depth == 0) {
+                return nextCloser; // return index of ')'
+            }
+            scan = nextCloser + 2; // continue after ")}"
+        }
+    }
+
+    return std::string::npos; // unmatched
+}
+
+bool replacePlaceholdersRecursively(
+    std::string& arg,
+    const std::vector<std::pair<std::string, std::function<std::string(const std::string&)>>>& placeholders)
+{
+    bool anyReplacementsMade = false;
+
+    // Precompute all opener tokens ("{slice(", "{math(", ...).
+    std::vector<std::string> starts;
+    starts.reserve(placeholders.size());
+    for (const auto& pr : placeholders) {
+        starts.push_back(pr.first);
+    }
+
+    bool replacedThisPass;
+    size_t searchPos;
+    std::string replacement;
+    std::string inner;
+
+    // Keep sweeping until no replacements occur.
+    for (;;) {
+        replacedThisPass = false;
+
+        // Try each placeholder type.
+        for (size_t t = 0; t < placeholders.size(); ++t) {
+            const auto& opener = placeholders[t].first;      // e.g., "{slice("
+            const auto& replacer = placeholders[t].second;
+
+            searchPos = 0;
+
+            while (true) {
+                // Find the next occurrence of THIS opener
+                const size_t startPos = arg.find(opener, searchPos);
+                if (startPos == std::string::npos) break;
+
+                // Find its matching ")}" by counting nested ANY opener
+                const size_t closePos = findMatchingClose(arg, startPos, starts, opener.size());
+                if (closePos == std::string::npos) {
+                    // Unbalanced; skip this and move on to avoid infinite loop
+                    searchPos = startPos + opener.size();
+                    continue;
+                }
+
+                // Full placeholder text including wrapper: "{name(...)}"
+                const size_t fullLen = (closePos - startPos) + 2; // include the ")}"
+                const std::string placeholderText = arg.substr(startPos, fullLen);
+
+                // Resolve INNER content first (exclude the outer wrapper)
+                const size_t innerStart = opener.size();
+                const size_t innerLen   = placeholderText.size() - innerStart - 2; // minus ")}"
+                inner = placeholderText.substr(innerStart, innerLen);
+
+                // Recurse on inner only (so we don't re-match the outer opener)
+                replacePlaceholdersRecursively(inner, placeholders);
+
+                // Rebuild the outer placeholder with resolved args
+                const std::string resolvedPlaceholder = opener + inner + ")}";
+
+                // Call the replacer on the resolved placeholder
+                replacement = replacer(resolvedPlaceholder);
+                if (replacement.empty()) {
+                    replacement = NULL_STR; // preserve your NULL_STR convention
+                }
+
+                // Perform replacement if it changes anything
+                const std::string before = arg;
+                arg.replace(startPos, fullLen, replacement);
+
+                if (arg != before) {
+                    anyReplacementsMade = true;
+                    replacedThisPass = true;
+                    // Continue scanning after the replacement
+                    searchPos = startPos + replacement.size();
+                } else {
+                    // If nothing changed, advance to avoid re-hitting the same spot
+                    searchPos = startPos + opener.size();
+                }
+            }
+        }
+
+        if (!replacedThisPass) break;
+    }
+
+    return anyReplacementsMade;
+}
+
+
+
+std::unordered_map<std::string, std::string> generalPlaceholders;
+void updateGeneralPlaceholders() {
+    generalPlaceholders = {
+        {"{ram_vendor}", memoryVendor},
+        {"{ram_model}", memoryModel},
+        {"{ams_version}", amsVersion},
+        {"{hos_version}", hosVersion},
+        {"{cpu_speedo}", ult::to_string(cpuSpeedo0)},
+        {"{cpu_iddq}", ult::to_string(cpuIDDQ)},
+        {"{gpu_speedo}", ult::to_string(cpuSpeedo2)},
+        {"{gpu_iddq}", ult::to_string(gpuIDDQ)},
+        {"{soc_speedo}", ult::to_string(socSpeedo0)},
+        {"{soc_iddq}", ult::to_string(socIDDQ)},
+        {"{title_id}", getTitleIdAsString()},
+        {"{build_id}", getBuildIdAsString()},
+        {"{local_ip}", getLocalIpAddress()}
+    };
+}
+
+// Decodes an even-length hex string into raw bytes; fails on any non-hex character
+static bool decodeHexString(const std::string& hex, std::string& bytes) {
+    if (hex.empty() || (hex.size() & 1))
+        return false;
+
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    bytes.resize(hex.size() / 2);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        const int high = nibble(hex[2 * i]);
+        const int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        bytes[i] = static_cast<char>((high << 4) | low);
+    }
+    return true;
+}
+
+/**
+ * @brief Cheap change fingerprint of a file: "size:mtime:crc32(first 4 KiB)".
+ */
+static bool readFileStamp(const std::string& filePath, std::string& stamp) {
+    static constexpr size_t STAMP_HEADER_SIZE = 4096;
+
+    struct stat fileInfo;
+    if (stat(filePath.c_str(), &fileInfo) != 0)
+        return false;
+
+    FILE* file = fopen(filePath.c_str(), "rb");
+    if (!file)
+        return false;
+    std::vector<u8> header(STAMP_HEADER_SIZE);
+    const size_t headerSize = fread(header.data(), 1, header.size(), file);
+    fclose(file);
+
+    char crcBuffer[9];
+    snprintf(crcBuffer, sizeof(crcBuffer), "%08X", crc32Calculate(header.data(), headerSize));
+    stamp = ult::to_string(static_cast<long long>(fileInfo.st_size)) + ":" +
+            ult::to_string(static_cast<long long>(fileInfo.st_mtime)) + ":" + crcBuffer;
+    return true;
+}
+
+/**
+ * @brief Persistent index of custom hex anchor offsets.
+ *
+ * Maps (file, ASCII anchor, occurrence) to the anchor's byte offset so that hex-by-custom-offset
+ * and the {hex_file(...)} placeholder do not rescan the target file every session. The index lives
+ * in SETTINGS_PATH/hex_offsets.ini with one section per file and one "<hex anchor>@<occurrence>"
+ * key per cached occurrence, and is loaded on first use. A section is only trusted while the
+ * file's size, mtime and CRC32 of its first 4 KiB match the stored stamp. Writes made by the
+ * interpreter update the stamp and drop occurrences they may have moved.
+ */
+class HexOffsetIndex {
+public:
+    // Resolves the offset of the given anchor occurrence (0-based), scanning the file on a miss
+    bool lookup(const std::string& filePath, const std::string& asciiPattern, size_t occurrence, size_t& offset) {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        if (asciiPattern.empty())
+            return false;
+        ensureLoaded();
+
+        std::string stamp;
+        if (!readFileStamp(filePath, stamp))
+            return false;
+
+        auto& section = indexData[filePath];
+        if (section[STAMP_KEY] != stamp) {
+            section.clear();
+            section[STAMP_KEY] = stamp;
+            dirty = true;
+        }
+
+        const std::string key = asciiToHex(asciiPattern) + '@' + ult::to_string(occurrence);
+        const auto it = section.find(key);
+        if (it != section.end()) {
+            offset = std::strtoull(it->second.c_str(), nullptr, 10);
+            return true;
+        }
+
+        const size_t found = scanOccurrence(filePath, asciiPattern, occurrence);
+        if (found == std::string::npos)
+            return false;
+        section.emplace(key, ult::to_string(found));
+        dirty = true;
+        offset = found;
+        return true;
+    }
+
+    // Records an interpreter write of length bytes at offset
+    void noteWrite(const std::string& filePath, size_t offset, size_t length) {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        ensureLoaded();
+
+        auto sectionIt = indexData.find(filePath);
+        if (sectionIt == indexData.end())
+            return;
+        auto& section = sectionIt->second;
+
+        for (auto it = section.begin(); it != section.end(); ) {
+            const size_t separator = it->first.rfind('@');
+            if (it->first == STAMP_KEY || separator == std::string::npos) {
+                it = (it->first == STAMP_KEY) ? std::next(it) : section.erase(it);
+                continue;
+            }
+            const size_t patternLen = separator / 2;
+            const size_t occurrence = std::strtoull(it->first.c_str() + separator + 1, nullptr, 10);
+            const size_t anchor = std::strtoull(it->second.c_str(), nullptr, 10);
+
+            // Writes past the anchor cannot renumber it; writes over it always can. A write in front
+            // of it can only be proven harmless for the first occurrence, by checking that it did not
+            // form a new one.
+            bool touched = false;
+            if (offset < anchor + patternLen) {
+                touched = offset + length > anchor || occurrence != 0;
+                if (!touched) {
+                    std::string pattern;
+                    touched = !decodeHexString(it->first.substr(0, separator), pattern) || windowContains(filePath, offset, length, pattern);
+                }
+            }
+            it = touched ? section.erase(it) : std::next(it);
+        }
+
+        std::string stamp;
+        if (readFileStamp(filePath, stamp))
+            section[STAMP_KEY] = stamp;
+        else
+            indexData.erase(sectionIt);
+        dirty = true;
+    }
+
+    // Drops everything known about a file (used when the write location is unknown)
+    void invalidate(const std::string& filePath) {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        ensureLoaded();
+        if (indexData.erase(filePath) > 0)
+            dirty = true;
+    }
+
+    // Drops every indexed file at or below path (a file, a directory or a wildcard pattern)
+    void invalidateUnder(std::string path) {
+        const size_t wildcard = path.find('*');
+        if (wildcard != std::string::npos)
+            path.resize(path.rfind('/', wildcard) + 1);
+        if (path.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(indexMutex);
+        ensureLoaded();
+        for (auto it = indexData.lower_bound(path); it != indexData.end() && it->first.compare(0, path.size(), path) == 0; ) {
+            const bool below = it->first.size() == path.size() || path.back() == '/' || it->first[path.size()] == '/';
+            if (below) {
+                it = indexData.erase(it);
+                dirty = true;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        if (!dirty)
+            return;
+        saveIniFileData(indexPath(), indexData);
+        dirty = false;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        indexData.clear();
+        loaded = true;
+        dirty = false;
+        deleteFileOrDirectory(indexPath());
+    }
+
+private:
+    static constexpr const char* STAMP_KEY = "stamp";
+
+    std::mutex indexMutex;
+    tsl::hlp::ini::IniData indexData;
+    bool loaded = false;
+    bool dirty = false;
+
+    static std::string indexPath() {
+        return SETTINGS_PATH + "hex_offsets.ini";
+    }
+
+    void ensureLoaded() {
+        if (loaded)
+            return;
+        if (isFile(indexPath()))
+            indexData = getParsedDataFromIniFile(indexPath());
+        loaded = true;
+    }
+
+    // Returns the offset of the given occurrence of pattern, reading only as far as needed
+    static size_t scanOccurrence(const std::string& filePath, const std::string& pattern, size_t occurrence) {
+        FILE* file = fopen(filePath.c_str(), "rb");
+        if (!file)
+            return std::string::npos;
+
+        const size_t overlap = pattern.size() - 1;
+        const size_t chunkSize = std::max<size_t>(HEX_BUFFER_SIZE, pattern.size());
+        std::string buffer(chunkSize + overlap, '\0');
+        size_t carried = 0;
+        size_t baseOffset = 0;
+        size_t seen = 0;
+        size_t result = std::string::npos;
+
+        while (result == std::string::npos) {
+            const size_t bytesRead = fread(buffer.data() + carried, 1, chunkSize, file);
+            const size_t available = carried + bytesRead;
+            const std::string_view view(buffer.data(), available);
+
+            for (size_t pos = findBytePattern(view, pattern); pos != std::string::npos; ) {
+                if (seen++ == occurrence) {
+                    result = baseOffset + pos;
+                    break;
+                }
+                const size_t next = findBytePattern(view.substr(pos + 1), pattern);
+                pos = (next == std::string::npos) ? next : pos + 1 + next;
+            }
+
+            if (bytesRead < chunkSize)
+                break;
+
+            // Keep the tail so anchors spanning two chunks are found exactly once
+            carried = std::min(overlap, available);
+            std::memmove(buffer.data(), buffer.data() + available - carried, carried);
+            baseOffset += available - carried;
+        }
+        fclose(file);
+        return result;
+    }
+
+    static bool windowContains(const std::string& filePath, size_t offset, size_t length, const std::string& pattern) {
+        if (pattern.empty())
+            return false;
+        const size_t start = offset > pattern.size() - 1 ? offset - (pattern.size() - 1) : 0;
+        std::string window(offset + length + pattern.size() - 1 - start, '\0');
+
+        FILE* file = fopen(filePath.c_str(), "rb");
+        if (!file)
+            return true;
+        fseek(file, static_cast<long>(start), SEEK_SET);
+        window.resize(fread(window.data(), 1, window.size(), file));
+        fclose(file);
+        return findBytePattern(window, pattern) != std::string::npos;
+    }
+};
+
+static HexOffsetIndex hexOffsetIndex;
+
+/**
+ * @brief Resolves a {hex_file(anchor, offset, length)} placeholder through the offset index.
+ *
+ * Reads length bytes at the anchor's first occurrence plus offset and returns them as
+ * uppercase hex. An optional fourth component selects another (0-based) occurrence of the
+ * anchor. Three-component placeholders the index cannot resolve are left to replaceHexPlaceholder.
+ */
+std::string replaceHexFilePlaceholder(const std::string& placeholder, const std::string& hexPath) {
+    const size_t startPos = placeholder.find('(');
+    const size_t endPos = placeholder.find(')', startPos);
+    if (hexPath.empty() || startPos == std::string::npos || endPos == std::string::npos)
+        return replaceHexPlaceholder(placeholder, hexPath);
+
+    std::vector<std::string> components;
+    size_t componentStart = startPos + 1;
+    while (componentStart <= endPos) {
+        size_t componentEnd = placeholder.find(',', componentStart);
+        if (componentEnd == std::string::npos || componentEnd > endPos)
+            componentEnd = endPos;
+        std::string component = placeholder.substr(componentStart, componentEnd - componentStart);
+        trim(component);
+        removeQuotes(component);
+        components.push_back(std::move(component));
+        componentStart = componentEnd + 1;
+    }
+
+    // Occurrences other than the first are only understood by the index
+    const bool hasOccurrence = components.size() == 4;
+    if (hasOccurrence && !isValidNumber(components[3]))
+        return NULL_STR;
+
+    size_t anchorOffset;
+    if ((components.size() != 3 && !hasOccurrence) || !isValidNumber(components[2]) ||
+        !hexOffsetIndex.lookup(hexPath, components[0], hasOccurrence ? ult::stoi(components[3]) : 0, anchorOffset))
+        return hasOccurrence ? NULL_STR : replaceHexPlaceholder(placeholder, hexPath);
+
+    const long long totalOffset = static_cast<long long>(anchorOffset) + ult::stoi(components[1]);
+    const size_t length = ult::stoi(components[2]);
+    if (totalOffset < 0 || length == 0)
+        return hasOccurrence ? NULL_STR : replaceHexPlaceholder(placeholder, hexPath);
+
+    FILE* file = fopen(hexPath.c_str(), "rb");
+    if (!file)
+        return NULL_STR;
+    std::vector<u8> bytes(length);
+    fseek(file, static_cast<long>(totalOffset), SEEK_SET);
+    const size_t bytesRead = fread(bytes.data(), 1, length, file);
+    fclose(file);
+    if (bytesRead != length)
+        return NULL_STR;
+
+    static const char hexDigits[] = "0123456789ABCDEF";
+    std::string hexData;
+    hexData.reserve(length * 2);
+    for (const u8 byte : bytes) {
+        hexData += hexDigits[byte >> 4];
+        hexData += hexDigits[byte & 0x0F];
+    }
+    return hexData;
+}
+
+bool applyPlaceholderReplacements(std::vector<std::string>& cmd, const std::string& hexPath, const std::string& iniPath, const std::string& listString, const std::string& listPath, const std::string& jsonString, const std::string& jsonPath) {
+    bool replacementsMade = false;
+    
+    std::vector<std::pair<std::string, std::function<std::string(const std::string&)>>> placeholders = {
+        {"{hex_file(", [&](const std::string& placeholder) { return returnOrNull(replaceHexFilePlaceholder(placeholder, hexPath)); }},
+        {"{ini_file(", [&](const std::string& placeholder) { 
+            std::string result = placeholder;
+            applyReplaceIniPlaceholder(result, INI_FILE_STR, iniPath); 
+            return returnOrNull(result); 
+        }},
+        {"{list(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find('(') + 1;
+            const std::string indexStr = placeholder.substr(startPos, placeholder.find(')') - startPos);
+            if (!isValidNumber(indexStr)) {
+                return NULL_STR;
+            }
+            return returnOrNull(stringToList(listString)[ult::stoi(indexStr)]);
+        }},
+        {"{list_file(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find('(') + 1;
+            std::string indexStr = placeholder.substr(startPos, placeholder.find(')') - startPos);
+            if (!isValidNumber(indexStr)) {
+                return NULL_STR;
+            }
+            return returnOrNull(getEntryFromListFile(listPath, ult::stoi(indexStr)));
+        }},
+        {"{json(", [&](const std::string& placeholder) { return replaceJsonPlaceholder(placeholder, JSON_STR, jsonString); }},
+        {"{json_file(", [&](const std::string& placeholder) { return replaceJsonPlaceholder(placeholder, JSON_FILE_STR, jsonPath); }},
+        {"{timestamp(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find("(") + 1;
+            const size_t endPos = placeholder.find(")");
+            std::string format = (endPos != std::string::npos) ? placeholder.substr(startPos, endPos - startPos) : "%Y-%m-%d %H:%M:%S";
+            removeQuotes(format);
+            return returnOrNull(getCurrentTimestamp(format));
+        }},
+        {"{decimal_to_hex(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find("(") + 1;
+            const std::string params = placeholder.substr(startPos, placeholder.find(")") - startPos);
+            
+            const size_t commaPos = params.find(",");
+            std::string decimalValue;
+            std::string order;
+            
+            if (commaPos != std::string::npos) {
+                decimalValue = params.substr(0, commaPos);
+                order = params.substr(commaPos + 1);
+                order.erase(0, order.find_first_not_of(" \t\n\r"));
+                order.erase(order.find_last_not_of(" \t\n\r") + 1);
+            } else {
+                decimalValue = params;
+                order = "";
+            }
+            
+            if (order.empty()) {
+                return returnOrNull(decimalToHex(decimalValue));
+            } else {
+                if (!isValidNumber(order)) {
+                    return NULL_STR;
+                }
+                return returnOrNull(decimalToHex(decimalValue, ult::stoi(order)));
+            }
+        }},
+        {"{ascii_to_hex(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find("(") + 1;
+            //size_t endPos = placeholder.find(")");
+            //std::string asciiValue = placeholder.substr(startPos, placeholder.find(")") - startPos);
+            return returnOrNull(asciiToHex(placeholder.substr(startPos, placeholder.find(")") - startPos)));
+        }},
+        {"{hex_to_rhex(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find("(") + 1;
+            //size_t endPos = placeholder.find(")");
+            //std::string hexValue = placeholder.substr(startPos, placeholder.find(")") - startPos);
+            return returnOrNull(hexToReversedHex(placeholder.substr(startPos, placeholder.find(")") - startPos)));
+        }},
+        {"{hex_to_decimal(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find("(") + 1;
+            //size_t endPos = placeholder.find(")");
+            //std::string hexValue = placeholder.substr(startPos, placeholder.find(")") - startPos);
+            return returnOrNull(hexToDecimal(placeholder.substr(startPos, placeholder.find(")") - startPos)));
+        }},
+        {"{random(", [&](const std::string& placeholder) {
+            std::srand(std::time(0));
+            
+            const size_t startPos = placeholder.find('(') + 1;
+            const size_t endPos = placeholder.find(')');
+            const std::string parameters = placeholder.substr(startPos, endPos - startPos);
+            const size_t commaPos = parameters.find(',');
+            
+            if (commaPos != std::string::npos) {
+                std::string lowStr = parameters.substr(0, commaPos);
+                std::string highStr = parameters.substr(commaPos + 1);
+                
+                if (!isValidNumber(lowStr) || !isValidNumber(highStr)) {
+                    return NULL_STR;
+                }
+                
+                const int lowValue = ult::stoi(lowStr);
+                const int highValue = ult::stoi(highStr);
+                return returnOrNull(ult::to_string(lowValue + rand() % (highValue - lowValue + 1)));
+            }
+            return returnOrNull(placeholder);
+        }},
+        {"{slice(", [&](const std::string& placeholder) {
+            const size_t startPos = placeholder.find('(');
+            const size_t endPos = placeholder.rfind(')');
+            if (startPos == std::string::npos || endPos == std::string::npos || endPos <= startPos + 1) {
+                return NULL_STR;
+            }
+        
+            const std::string parameters = placeholder.substr(startPos + 1, endPos - startPos - 1);
+            const size_t firstComma = parameters.find(',');
+            const size_t secondComma = (firstComma == std::string::npos) ? std::string::npos : parameters.find(',', firstComma + 1);
+            if (firstComma == std::string::npos || secondComma == std::string::npos) {
+                return NULL_STR;
+            }
+        
+            std::string strPart    = parameters.substr(0, firstComma);
+            std::string startIndex = parameters.substr(firstComma + 1, secondComma - firstComma - 1);
+            std::string endIndex   = parameters.substr(secondComma + 1);
+        
+            trim(strPart);
+            removeQuotes(strPart);
+            trim(startIndex);
+            removeQuotes(startIndex);
+            trim(endIndex);
+            removeQuotes(endIndex);
+        
+            if (startIndex.empty() || endIndex.empty() ||
+                !isValidNumber(startIndex) || !isValidNumber(endIndex)) {
+                return NULL_STR;
+            }
+        
+            const size_t sliceStart = static_cast<size_t>(ult::stoi(startIndex));
+            const size_t sliceEnd   = static_cast<size_t>(ult::stoi(endIndex));
+        
+            if (sliceEnd <= sliceStart || sliceStart >= strPart.length()) {
+                return NULL_STR;
+            }
+        
+            return returnOrNull(sliceString(strPart, sliceStart, sliceEnd));
+        }},
+        
+        {"{split(", [&](const std::string& placeholder) {
+            const size_t openParen = placeholder.find('(');
+            const size_t closeParen = placeholder.find(')');
+        
+            if (openParen == std::string::npos || closeParen == std::string::npos || closeParen <= openParen) {
+                return NULL_STR;
+            }
+        
+            const std::string parameters = placeholder.substr(openParen + 1, closeParen - openParen - 1);
+        
+            const size_t firstCommaPos = parameters.find(',');
+            const size_t lastCommaPos  = parameters.find_last_of(',');
+        
+            if (firstCommaPos == std::string::npos
+             || lastCommaPos  == std::string::npos
+             || firstCommaPos == lastCommaPos) {
+                return NULL_STR;
+            }
+        
+            std::string str = parameters.substr(0, firstCommaPos);
+            std::string delimiter = parameters.substr(firstCommaPos + 1, lastCommaPos - firstCommaPos - 1);
+            std::string indexStr = parameters.substr(lastCommaPos + 1);
+        
+            trim(str);
+            removeQuotes(str);
+            trim(delimiter);
+            removeQuotes(delimiter);
+            trim(indexStr);
+        
+            if (indexStr.empty() || !isValidNumber(indexStr)) {
+                return NULL_STR;
+            }
+        
+            std::string result = splitStringAtIndex(str, delimiter, ult::stoi(indexStr));
+        
+            return result.empty() ? NULL_STR : result;
+        }},
+        {"{math(", [&](const std::string& placeholder) { return returnOrNull(handleMath(placeholder)); }},
+        {"{length(", [&](const std::string& placeholder) { return returnOrNull(handleLength(placeholder)); }},
+    };
+
+    //generalPlaceholders = {
+    //    {"{ram_vendor}", memoryVendor},
+    //    {"{ram_model}", memoryModel},
+    //    {"{ams_version}", amsVersion},
+    //    {"{hos_version}", hosVersion},
+    //    {"{cpu_speedo}", ult::to_string(cpuSpeedo0)},
+    //    {"{cpu_iddq}", ult::to_string(cpuIDDQ)},
+    //    {"{gpu_speedo}", ult::to_string(cpuSpeedo2)},
+    //    {"{gpu_iddq}", ult::to_string(gpuIDDQ)},
+    //    {"{soc_speedo}", ult::to_string(socSpeedo0)},
+    //    {"{soc_iddq}", ult::to_string(socIDDQ)},
+    //    {"{title_id}", getTitleIdAsString()}
+    //};
+    updateGeneralPlaceholders();
+
+    // Iterate through each command and replace placeholders
+    for (auto& arg : cmd) {
+        //std::string originalArg = arg; // Store original to compare later
+        
+        // Replace general placeholders - modify these functions to return bool
+        if (replacePlaceholdersInArg(arg, generalPlaceholders)) {
+            replacementsMade = true;
+        }
+
+        // Replace button/arrow placeholders from the global map
+        if (replacePlaceholdersInArg(arg, symbolPlaceholders)) {
+            replacementsMade = true;
+        }
+
+        // Resolve nested placeholders - modify this function to return bool
+        if (replacePlaceholdersRecursively(arg, placeholders)) {
+            replacementsMade = true;
+        }
+        
+        // Alternative: Simple string comparison if you can't modify the helper functions
+        // if (arg != originalArg) {
+        //     replacementsMade = true;
+        // }
+    }
+    
+    return replacementsMade;
+}
+
+
+
+// forward declarartion
+void processCommand(const std::vector<std::string>& cmd, const std::string& packagePath, const std::string& selectedCommand);
+inline bool isFindReplaceHexCommand(std::string_view commandName);
+size_t handleFusedHexEdits(std::vector<std::vector<std::string>>& commands, size_t first, const std::string& packagePath);
+size_t handleParallelDownloads(std::vector<std::vector<std::string>>& commands, size_t first, const std::string& packagePath);
+
+#if USING_LOGGING_DIRECTIVE
+// Writes the "Executing command:" line for one command, reusing the caller's buffer
+inline void logExecutingCommand(const std::vector<std::string>& cmd, std::string& messageBuffer) {
+    messageBuffer.clear();
+    messageBuffer += "Executing command: ";
+    for (const auto& token : cmd) {
+        messageBuffer += token;
+        messageBuffer += ' ';
+    }
+    logMessage(messageBuffer);
+}
+#endif
+
+
+/**
+ * @brief Apply placeholder replacements to a list of commands and handle control flow commands.
+ *
+ * This function iterates over a list of commands, where each command is a vector of strings,
+ * and applies the `applyPlaceholderReplacements` function to handle the placeholders.
+ * It also handles control flow commands like "erista:" and "mariko:".
+ * Optimized for minimal memory usage with in-place compaction.
+ *
+ * @param commands A list of commands, where each command is represented as a vector of strings.
+ * @param packagePath The path to the package (optional).
+ * @param selectedCommand A specific command to execute (optional).
+ * @return Returns true if the placeholders were successfully applied to the commands, false otherwise.
+ */
+bool applyPlaceholderReplacementsToCommands(std::vector<std::vector<std::string>>& commands, 
+                                           const std::string& packagePath = "", 
+                                           const std::string& selectedCommand = "") {
+    
+    std::string listString, listPath, jsonString, jsonPath, hexPath, iniPath;
+    bool inEristaSection = false;
+    bool inMarikoSection = false;
+    
+    // Two-pointer technique: readIndex reads all commands, writeIndex writes kept commands
+    size_t writeIndex = 0;
+    
+    for (size_t readIndex = 0; readIndex < commands.size(); ++readIndex) {
+        auto& cmd = commands[readIndex];
+        
+        if (cmd.empty()) {
+            // Skip empty commands, don't increment writeIndex
+            cmd.shrink_to_fit();
+            continue;
+        }
+
+        const std::string_view commandName = cmd[0];
+
+        // Handle control flow commands
+        if (commandName == "erista:") {
+            inEristaSection = true;
+            inMarikoSection = false;
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue; // Don't keep this command
+        } else if (commandName == "mariko:") {
+            inEristaSection = false;
+            inMarikoSection = true;
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue; // Don't keep this command
+        } else if ((!commandName.empty() && commandName.front() == ';') ||
+                   (commandName.size() >= 7 && commandName.substr(commandName.size() - 7) == "_source") ||
+                   commandName == "logging") {
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue; // Don't keep this command
+        }
+
+        // Skip commands not relevant to current hardware
+        if ((inEristaSection && !usingErista) || (inMarikoSection && !usingMariko)) {
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue; // Don't keep this command
+        }
+
+        // Apply placeholder replacements
+        applyPlaceholderReplacements(cmd, hexPath, iniPath, listString, listPath, jsonString, jsonPath);
+
+        // Handle special commands
+        const size_t cmdSize = cmd.size();
+        bool shouldKeep = true;
+
+        if (commandName == LIST_STR && cmdSize >= 2) {
+            listString = cmd[1];
+            removeQuotes(listString);
+            shouldKeep = false;
+        } else if (commandName == LIST_FILE_STR && cmdSize >= 2) {
+            listPath = cmd[1];
+            preprocessPath(listPath, packagePath);
+            shouldKeep = false;
+        } else if (commandName == JSON_STR && cmdSize >= 2) {
+            jsonString = cmd[1];
+            shouldKeep = false;
+        } else if (commandName == JSON_FILE_STR && cmdSize >= 2) {
+            jsonPath = cmd[1];
+            preprocessPath(jsonPath, packagePath);
+            shouldKeep = false;
+        } else if (commandName == INI_FILE_STR && cmdSize >= 2) {
+            iniPath = cmd[1];
+            preprocessPath(iniPath, packagePath);
+            shouldKeep = false;
+        } else if (commandName == HEX_FILE_STR && cmdSize >= 2) {
+            hexPath = cmd[1];
+            preprocessPath(hexPath, packagePath);
+            shouldKeep = false;
+        } else if (commandName == "filter" || commandName == "file_name" || 
+                   commandName == "folder_name" || commandName == "sourced_path") {
+            shouldKeep = false;
+        }
+
+        if (!shouldKeep) {
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            cmd = {};
+            continue; // Don't keep this command
+        }
+
+        // Apply quoting logic to arguments for commands we're keeping
+        for (size_t i = 1; i < cmd.size(); ++i) {
+            std::string& argument = cmd[i];
+
+            if (argument.empty()) {
+                argument = "''";
+                continue;
+            }
+
+            if (argument.size() >= 2 &&
+                ((argument.front() == '"' && argument.back() == '"') ||
+                 (argument.front() == '\'' && argument.back() == '\''))) {
+                continue;
+            }
+
+            if (argument.find(' ') == std::string::npos) {
+                continue;
+            }
+
+            // Optimized quoting - fewer string operations
+            const bool hasSingleQuote = argument.find('\'') != std::string::npos;
+            const bool hasDoubleQuote = argument.find('"') != std::string::npos;
+            
+            if (hasSingleQuote && !hasDoubleQuote) {
+                argument.insert(0, 1, '"');
+                argument.push_back('"');
+            } else {
+                argument.insert(0, 1, '\'');
+                argument.push_back('\'');
+            }
+        }
+
+        // Keep this command - move it to the write position
+        if (writeIndex != readIndex) {
+            commands[writeIndex] = std::move(cmd);
+            cmd.shrink_to_fit();
+        }
+        ++writeIndex;
+    }
+    
+    // Resize to keep only the commands we want
+    commands.resize(writeIndex);
+    commands.shrink_to_fit();  // Always - maximize memory efficiency
+
+    // Shrink capacity if we removed a lot of commands
+    //if (commands.capacity() > commands.size() * 2) {
+    //    commands.shrink_to_fit();
+    //}
+
+    return true;
+}
+
+
+
+/**
+ * @brief Reference-counted network session shared by the commands of an interpreter run.
+ *
+ * The first acquire() brings up sockets and nifm; the session then stays up until the last
+ * release() and, while any run is active, until the outermost endRun(). Runs nest (an exec
+ * inside a run), so they are counted rather than flagged. Easy handles are pooled per host
+ * so consecutive downloads reuse keep-alive connections, and a share handle keeps DNS
+ * and TLS sessions across hosts (e.g. release redirects).
+ */
+class NetworkSession {
+public:
+    bool acquire() {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        if (references == 0 && !active) {
+            if (R_FAILED(socketInitializeDefault()))
+                return false;
+            if (R_FAILED(nifmInitialize(NifmServiceType_User))) {
+                socketExit();
+                return false;
+            }
+            shareHandle = curl_share_init();
+            if (shareHandle) {
+                // Easy handles on different threads (multi transfers, streamed installs) use the share concurrently
+                curl_share_setopt(shareHandle, CURLSHOPT_LOCKFUNC, lockShare);
+                curl_share_setopt(shareHandle, CURLSHOPT_UNLOCKFUNC, unlockShare);
+                curl_share_setopt(shareHandle, CURLSHOPT_USERDATA, this);
+                curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+                curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            }
+            active = true;
+        }
+        ++references;
+        return true;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        if (references > 0 && --references == 0 && runDepth == 0)
+            shutdown();
+    }
+
+    void beginRun() {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        ++runDepth;
+    }
+
+    // Returns true when the outermost run ended
+    bool endRun() {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        if (runDepth > 0 && --runDepth > 0)
+            return false;
+        if (references == 0)
+            shutdown();
+        return true;
+    }
+
+    // Returns a reset easy handle, reusing the pooled one for the URL's host when possible
+    CURL* takeHandle(const std::string& url) {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        CURL* curl = nullptr;
+        const auto it = active ? handlePool.find(hostKey(url)) : handlePool.end();
+        if (it != handlePool.end()) {
+            curl = it->second;
+            handlePool.erase(it);
+            // Reset keeps the handle's live connections
+            curl_easy_reset(curl);
+        } else {
+            curl = curl_easy_init();
+        }
+        if (curl && shareHandle)
+            curl_easy_setopt(curl, CURLOPT_SHARE, shareHandle);
+        return curl;
+    }
+
+    void returnHandle(const std::string& url, CURL* curl) {
+        if (!curl)
+            return;
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        if (active && handlePool.emplace(hostKey(url), curl).second)
+            return;
+        curl_easy_cleanup(curl);
+    }
+
+private:
+    std::mutex sessionMutex;
+    std::mutex shareMutexes[CURL_LOCK_DATA_LAST];
+    std::unordered_map<std::string, CURL*> handlePool;
+    CURLSH* shareHandle = nullptr;
+    size_t references = 0;
+    bool active = false;
+    size_t runDepth = 0;
+
+    static void lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userData) {
+        static_cast<NetworkSession*>(userData)->shareMutexes[data].lock();
+    }
+
+    static void unlockShare(CURL*, curl_lock_data data, void* userData) {
+        static_cast<NetworkSession*>(userData)->shareMutexes[data].unlock();
+    }
+
+    // "scheme://host[:port]" of a URL
+    static std::string hostKey(const std::string& url) {
+        const size_t schemeEnd = url.find("://");
+        const size_t hostStart = (schemeEnd == std::string::npos) ? 0 : schemeEnd + 3;
+        return stringToLowercase(url.substr(0, url.find_first_of("/?#", hostStart)));
+    }
+
+    void shutdown() {
+        if (!active)
+            return;
+        for (auto& entry : handlePool)
+            curl_easy_cleanup(entry.second);
+        handlePool.clear();
+        if (shareHandle) {
+            curl_share_cleanup(shareHandle);
+            shareHandle = nullptr;
+        }
+        nifmExit();
+        socketExit();
+        active = false;
+    }
+};
+
+static NetworkSession networkSession;
+
+/**
+ * @brief Prepares global interpreter state for a run.
+ *
+ * Selects the package log target, applies the [memory] buffer sizes from the config INI and
+ * resets the page refresh flags. Opens the run scope of the network session. Called once per
+ * run, or once per batch.
+ *
+ * @param packagePath The package the commands belong to.
+ */
+void beginInterpreterRun(const std::string& packagePath) {
+    #if USING_LOGGING_DIRECTIVE
+    if (!packagePath.empty()) {
+        disableLogging = !(parseValueFromIniSection(PACKAGES_INI_FILEPATH, getNameFromPath(packagePath), USE_LOGGING_STR) == TRUE_STR);
+        logFilePath = packagePath + "log.txt";
+    }
+    #endif
+
+    // Initialize buffer sizes based on expanded memory setting
+    //if (expandedMemory) {
+    //    COPY_BUFFER_SIZE = 262144;
+    //    HEX_BUFFER_SIZE = 8192;
+    //    UNZIP_READ_BUFFER = 262144;
+    //    UNZIP_WRITE_BUFFER = 131072;
+    //    DOWNLOAD_READ_BUFFER = 262144;
+    //    DOWNLOAD_WRITE_BUFFER = 131072;
+    //}
+
+    // Load and apply buffer configuration from INI file
+    const auto bufferSection = getKeyValuePairsFromSection(ULTRAHAND_CONFIG_INI_PATH, MEMORY_STR);
+    
+    if (!bufferSection.empty()) {
+        struct BufferConfig {
+            const char* key;
+            size_t* target;
+        };
+        
+        const BufferConfig configs[] = {
+            {"copy_buffer_size", &COPY_BUFFER_SIZE},
+            {"unzip_read_buffer", &UNZIP_READ_BUFFER},
+            {"unzip_write_buffer", &UNZIP_WRITE_BUFFER},
+            {"download_read_buffer", &DOWNLOAD_READ_BUFFER},
+            {"download_write_buffer", &DOWNLOAD_WRITE_BUFFER},
+            {"hex_buffer_size", &HEX_BUFFER_SIZE}
+        };
+        
+        for (const auto& config : configs) {
+            const auto it = bufferSection.find(config.key);
+            if (it != bufferSection.end()) {
+                *config.target = ult::stoi(it->second);
+            }
+        }
+    }
+
+    refreshPage.store(false, std::memory_order_release);
+    refreshPackage.store(false, std::memory_order_release);
+    networkSession.beginRun();
+}
+
+/**
+ * @brief Ends a run's scope of the network session. Once the outermost run ends, persists
+ * interpreter caches and restores the default log target.
+ */
+inline void endInterpreterRun() {
+    if (!networkSession.endRun())
+        return;
+    hexOffsetIndex.flush();
+
+    #if USING_LOGGING_DIRECTIVE
+    disableLogging = true;
+    logFilePath = defaultLogFilePath;
+    #endif
+}
+
+/**
+ * @brief Section state of a command list, for lists that run in several parts.
+ */
+struct CommandListState {
+    bool inEristaSection = false;
+    bool inMarikoSection = false;
+    bool inTrySection = false;
+    bool succeeded = true;  // commandSuccess when the previous part ended
+    bool finished = false;  // a try: block succeeded, so the remaining parts are skipped
+};
+
+/**
+ * @brief Executes one list of commands without any per-run setup.
+ *
+ * Handles try:/erista:/mariko: sections and placeholder replacement, clearing each command
+ * after it has been processed.
+ *
+ * @param commands A list of commands, where each command is represented as a vector of strings.
+ * @param packagePath The package the commands belong to.
+ * @param selectedCommand The command name that triggered the run.
+ * @param aborted Set to true if the run stopped on an abort request.
+ * @param state When set, the list continues from and updates this section state.
+ * @return The final command success state.
+ */
+bool runCommandList(std::vector<std::vector<std::string>>&& commands,
+                    const std::string& packagePath,
+                    const std::string& selectedCommand,
+                    bool& aborted,
+                    CommandListState* state = nullptr) {
+
+    if (state && state->finished) {
+        commands = {};
+        return true;
+    }
+
+    // Initialize state variables
+    bool inEristaSection = state ? state->inEristaSection : false;
+    bool inMarikoSection = state ? state->inMarikoSection : false;
+    bool inTrySection = state ? state->inTrySection : false;
+    
+    // String buffers for command processing
+    std::string listString, listPath, jsonString, jsonPath, hexPath, iniPath;
+    size_t groupedCount = 0;
+    
+    #if USING_LOGGING_DIRECTIVE
+    std::string messageBuffer;
+    #endif
+
+    // Reset global state
+    commandSuccess.store(state ? state->succeeded : true, std::memory_order_release);
+    interpreterLogging.store(false, std::memory_order_release);
+
+    // Process commands one by one, clearing each after processing
+    for (size_t i = 0; i < commands.size(); ++i) {
+        // Check for abort signal
+        if (abortCommand.exchange(false, std::memory_order_acq_rel)) {
+            //abortCommand.store(false, std::memory_order_release);
+            commandSuccess.store(false, std::memory_order_release);
+            // Clear all remaining commands
+            //for (size_t j = i; j < commands.size(); ++j) {
+            //    commands[j].clear();
+            //    commands[j].shrink_to_fit();
+            //}
+            commands = {};
+            //commands.clear();
+            //commands.shrink_to_fit();
+            aborted = true;
+            return commandSuccess;
+        }
+
+        auto& cmd = commands[i];
+        
+        // Skip empty commands
+        if (cmd.empty()) {
+            continue;
+        }
+
+        // Use string_view to avoid copying command name
+        const std::string_view commandName = cmd[0];
+
+        // Handle control flow commands
+        if (commandName == "try:") {
+            if (inTrySection && commandSuccess.load(std::memory_order_acquire)) {
+                // Clear remaining commands and exit
+                //for (size_t j = i; j < commands.size(); ++j) {
+                //    commands[j].clear();
+                //    commands[j].shrink_to_fit();
+                //}
+                //commands.clear();
+                //commands.shrink_to_fit();
+                commands = {};
+                if (state)
+                    state->finished = true;
+                return true;
+            }
+            commandSuccess.store(true, std::memory_order_release);
+            inTrySection = true;
+            // Clear and continue
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue;
+        }
+        
+        if (commandName == "erista:") {
+            inEristaSection = true;
+            inMarikoSection = false;
+            // Clear and continue
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue;
+        }
+        
+        if (commandName == "mariko:") {
+            inEristaSection = false;
+            inMarikoSection = true;
+            // Clear and continue
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue;
+        }
+
+        // Skip commands in try section if previous command failed
+        if (!commandSuccess.load(std::memory_order_acquire) && inTrySection) {
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue;
+        }
+
+        // Determine if command should execute based on platform sections
+        const bool shouldExecute = 
+            (inEristaSection && !inMarikoSection && usingErista) ||
+            (!inEristaSection && inMarikoSection && usingMariko) ||
+            (!inEristaSection && !inMarikoSection);
+
+        if (!shouldExecute) {
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue;
+        }
+
+        // Only execute if not in try section or if we're succeeding in try section
+        if (inTrySection && !commandSuccess.load(std::memory_order_acquire)) {
+            cmd = {};
+            //cmd.clear();
+            //cmd.shrink_to_fit();
+            continue;
+        }
+
+        // Apply placeholder replacements only if needed
+        bool hasPlaceholders = false;
+        for (const auto& arg : cmd) {
+            if (arg.find('{') != std::string::npos) {
+                hasPlaceholders = true;
+                break;
+            }
+        }
+        
+        if (hasPlaceholders) {
+            applyPlaceholderReplacements(cmd, hexPath, iniPath, listString, listPath, jsonString, jsonPath);
+        }
+
+        #if USING_LOGGING_DIRECTIVE
+        if (interpreterLogging.load(std::memory_order_acquire)) {
+            disableLogging = false;
+        }
+
+        if (!disableLogging) {
+            logExecutingCommand(cmd, messageBuffer);
+        }
+        #endif
+
+        const size_t cmdSize = cmd.size();
+
+        // Process different command types with direct assignment to reuse string buffers
+        if (commandName == LIST_STR) {
+            if (cmdSize >= 2) {
+                listString = cmd[1]; // Reuses existing string buffer
+                removeQuotes(listString);
+            }
+        } 
+        else if (commandName == LIST_FILE_STR) {
+            if (cmdSize >= 2) {
+                listPath = cmd[1];
+                preprocessPath(listPath, packagePath);
+            }
+        } 
+        else if (commandName == JSON_STR) {
+            if (cmdSize >= 2) {
+                jsonString = cmd[1];
+            }
+        } 
+        else if (commandName == JSON_FILE_STR) {
+            if (cmdSize >= 2) {
+                jsonPath = cmd[1];
+                preprocessPath(jsonPath, packagePath);
+            }
+        } 
+        else if (commandName == INI_FILE_STR) {
+            if (cmdSize >= 2) {
+                iniPath = cmd[1];
+                preprocessPath(iniPath, packagePath);
+            }
+        } 
+        else if (commandName == HEX_FILE_STR) {
+            if (cmdSize >= 2) {
+                hexPath = cmd[1];
+                preprocessPath(hexPath, packagePath);
+            }
+        } 
+        else if (isFindReplaceHexCommand(commandName) && cmdSize >= 4 &&
+                 (groupedCount = handleFusedHexEdits(commands, i, packagePath)) > 0) {
+            // Consecutive hex edits on the same file were applied in one pass
+            i += groupedCount - 1;
+        }
+        else if (commandName == "download" && cmdSize >= 3 &&
+                 (groupedCount = handleParallelDownloads(commands, i, packagePath)) > 0) {
+            // Consecutive independent downloads ran concurrently
+            i += groupedCount - 1;
+        }
+        else {
+            // Process all other commands
+            processCommand(cmd, packagePath, selectedCommand);
+        }
+        
+        // Clear the processed command immediately to free its memory
+        cmd = {};
+        //cmd.clear();
+        //cmd.shrink_to_fit();
+    }
+
+    // Final cleanup
+    commands = {};
+    //commands.clear();
+    //commands.shrink_to_fit();
+
+    if (state) {
+        state->inEristaSection = inEristaSection;
+        state->inMarikoSection = inMarikoSection;
+        state->inTrySection = inTrySection;
+        state->succeeded = commandSuccess.load(std::memory_order_acquire);
+    }
+    return commandSuccess.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Interpret and execute a list of commands.
+ *
+ * This function interprets and executes a list of commands based on their names and arguments.
+ * Optimized for minimal memory usage by clearing processed commands immediately.
+ *
+ * @param commands A list of commands, where each command is represented as a vector of strings.
+ */
+bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& commands, 
+                                const std::string& packagePath = "", 
+                                const std::string& selectedCommand = "") {
+    std::lock_guard<std::recursive_mutex> stateLock(interpreterStateMutex);
+    beginInterpreterRun(packagePath);
+
+    bool aborted = false;
+    const bool success = runCommandList(std::move(commands), packagePath, selectedCommand, aborted);
+
+    endInterpreterRun();
+    return success;
+}
+
+/**
+ * @brief Applies one command template to a list of entries.
+ *
+ * Per-run setup happens once for the whole batch and placeholder sources stay parsed across
+ * entries (see BatchSourceCache). Each entry gets its own try:/platform section state; a failed
+ * entry marks the batch as failed but does not stop it, while an abort does. Overall progress
+ * is published through batchPercentage.
+ *
+ * @param commandTemplate The selection commands with {source} style placeholders.
+ * @param entries The entries to substitute into the template.
+ * @param entryIndices Original index of each entry for {index}; empty to use the position.
+ * @param packagePath The package the commands belong to.
+ * @param selectedCommand The command name that triggered the run.
+ * @return true if every entry succeeded.
+ */
+bool interpretAndExecuteBatch(const std::vector<std::vector<std::string>>& commandTemplate,
+                              const std::vector<std::string>& entries,
+                              const std::vector<u32>& entryIndices,
+                              const std::string& packagePath = "",
+                              const std::string& selectedCommand = "") {
+    std::lock_guard<std::recursive_mutex> stateLock(interpreterStateMutex);
+    beginInterpreterRun(packagePath);
+
+    BatchSourceCache sourceCache;
+    activeBatchCache = &sourceCache;
+
+    bool batchSuccess = true;
+    bool aborted = false;
+    const size_t entryCount = entries.size();
+    batchPercentage.store(0, std::memory_order_release);
+
+    for (size_t e = 0; e < entryCount && !aborted; ++e) {
+        const size_t entryIndex = (e < entryIndices.size()) ? entryIndices[e] : e;
+        if (!runCommandList(getSourceReplacement(commandTemplate, entries[e], entryIndex, packagePath), packagePath, selectedCommand, aborted))
+            batchSuccess = false;
+
+        batchPercentage.store(static_cast<int>((e + 1) * 100 / entryCount), std::memory_order_release);
+    }
+
+    activeBatchCache = nullptr;
+    batchPercentage.store(-1, std::memory_order_release);
+    commandSuccess.store(batchSuccess && !aborted, std::memory_order_release);
+
+    endInterpreterRun();
+    return commandSuccess.load(std::memory_order_acquire);
+}
+
+
+// Helper function to parse command arguments
+void parseCommandArguments(const std::vector<std::string>& cmd, const std::string& packagePath, std::string& sourceListPath, std::string& destinationListPath, std::string& logSource, std::string& logDestination, std::string& sourcePath, std::string& destinationPath, std::string& copyFilterListPath, std::string& filterListPath) {
+    for (size_t i = 1; i < cmd.size(); ++i) {
+        if (cmd[i] == "-src" && i + 1 < cmd.size()) {
+            sourceListPath = cmd[++i];
+            preprocessPath(sourceListPath, packagePath);
+        } else if (cmd[i] == "-dest" && i + 1 < cmd.size()) {
+            destinationListPath = cmd[++i];
+            preprocessPath(destinationListPath, packagePath);
+        } else if (cmd[i] == "-log_src" && i + 1 < cmd.size()) {
+            logSource = cmd[++i];
+            preprocessPath(logSource, packagePath);
+        } else if (cmd[i] == "-log_dest" && i + 1 < cmd.size()) {
+            logDestination = cmd[++i];
+            preprocessPath(logDestination, packagePath);
+        } else if ((cmd[i] == "-copy_filter" || cmd[i] == "-cp_filter") && i + 1 < cmd.size()) {
+            copyFilterListPath = cmd[++i];
+            preprocessPath(copyFilterListPath, packagePath);
+        } else if (cmd[i] == "-filter" && i + 1 < cmd.size()) {
+            filterListPath = cmd[++i];
+            preprocessPath(filterListPath, packagePath);
+        } else if (sourcePath.empty()) {
+            sourcePath = cmd[i];
+            preprocessPath(sourcePath, packagePath);
+        } else if (destinationPath.empty()) {
+            destinationPath = cmd[i];
+            preprocessPath(destinationPath, packagePath);
+        }
+    }
+}
+
+
+void handleMakeDirCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    if (cmd.size() >= 2) {
+        std::string sourcePath = cmd[1];
+        preprocessPath(sourcePath, packagePath);
+        createDirectory(sourcePath);
+    }
+}
+
+void handleCopyCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    // Declare only the strings we always need
+    std::string sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath;
+    parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
+    
+    if (!sourceListPath.empty() && !destinationListPath.empty()) {
+        // Process list-based copying
+        auto sourceFilesList = readListFromFile(sourceListPath);
+        auto destinationFilesList = readListFromFile(destinationListPath);
+        
+        // Only create filterSet if filter file exists
+        std::unique_ptr<std::unordered_set<std::string>> filterSet;
+        if (!filterListPath.empty()) {
+            filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath));
+        }
+        
+        const size_t listSize = std::min(sourceFilesList.size(), destinationFilesList.size());
+        for (size_t i = 0; i < listSize; ++i) {
+            // Reuse existing sourcePath and destinationPath strings
+            sourcePath = std::move(sourceFilesList[i]);
+            sourceFilesList[i].shrink_to_fit();     // Free the capacity
+            preprocessPath(sourcePath, packagePath);
+            
+            destinationPath = std::move(destinationFilesList[i]);
+            destinationFilesList[i].shrink_to_fit(); // Free the capacity
+            preprocessPath(destinationPath, packagePath);
+            
+            // Only check filter if it exists
+            const bool shouldCopy = !filterSet || filterSet->find(sourcePath) == filterSet->end();
+            
+            if (shouldCopy) {
+                const long long totalSize = getTotalSize(sourcePath);
+                long long totalBytesCopied = 0;
+                copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
+                hexOffsetIndex.invalidateUnder(destinationPath);
             }
+        }
         
-            std::string strPart    = parameters.substr(0, firstComma);
-            std::string startIndex = parameters.substr(firstComma + 1, secondComma - firstComma - 1);
-            std::string endIndex   = parameters.substr(secondComma + 1);
+    } else {
+        // Single file/directory copying - early returns to avoid unnecessary work
+        if (sourcePath.empty() || destinationPath.empty()) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Source and destination paths must be specified.");
+            #endif
+            return;
+        }
         
-            trim(strPart);
-            removeQuotes(strPart);
-            trim(startIndex);
-            removeQuotes(startIndex);
-            trim(endIndex);
-            removeQuotes(endIndex);
+        if (!isFileOrDirectory(sourcePath)) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Source file or directory doesn't exist: " + sourcePath);
+            #endif
+            return;
+        }
         
-            if (startIndex.empty() || endIndex.empty() ||
-                !isValidNumber(startIndex) || !isValidNumber(endIndex)) {
-                return NULL_STR;
-            }
+        if (sourcePath.find('*') != std::string::npos) {
+            copyFileOrDirectoryByPattern(sourcePath, destinationPath, logSource, logDestination);
+        } else {
+            const long long totalSize = getTotalSize(sourcePath);
+            long long totalBytesCopied = 0;
+            copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize, logSource, logDestination);
+        }
+        hexOffsetIndex.invalidateUnder(destinationPath);
+    }
+}
+
+void handleDeleteCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    // Declare only the strings we need
+    std::string sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath;
+    parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
+    
+    if (!sourceListPath.empty()) {
+        // Process list-based deletion
+        auto sourceFilesList = readListFromFile(sourceListPath);
         
-            const size_t sliceStart = static_cast<size_t>(ult::stoi(startIndex));
-            const size_t sliceEnd   = static_cast<size_t>(ult::stoi(endIndex));
+        // Only create filterSet if filter file exists
+        std::unique_ptr<std::unordered_set<std::string>> filterSet;
+        if (!filterListPath.empty()) {
+            filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath));
+        }
         
-            if (sliceEnd <= sliceStart || sliceStart >= strPart.length()) {
-                return NULL_STR;
+        for (size_t i = 0; i < sourceFilesList.size(); ++i) {
+            // Move string to avoid copy
+            sourcePath = std::move(sourceFilesList[i]);
+            sourceFilesList[i].shrink_to_fit();     // Free the capacity
+            preprocessPath(sourcePath, packagePath);
+            
+            // Only check filter if it exists
+            const bool shouldDelete = !filterSet || filterSet->find(sourcePath) == filterSet->end();
+            
+            if (shouldDelete) {
+                deleteFileOrDirectory(sourcePath);
             }
+            
+            // Clear the vector element immediately to free memory
+            //sourceFilesList[i].clear();
+        }
         
-            return returnOrNull(sliceString(strPart, sliceStart, sliceEnd));
-        }},
+    } else {
+        // Single file/directory deletion - early returns for error conditions
+        if (sourcePath.empty()) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Source path must be specified.");
+            #endif
+            return;
+        }
         
-        {"{split(", [&](const std::string& placeholder) {
-            const size_t openParen = placeholder.find('(');
-            const size_t closeParen = placeholder.find(')');
+        if (isDangerousCombination(sourcePath)) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Dangerous combination detected.");
+            #endif
+            return;
+        }
         
-            if (openParen == std::string::npos || closeParen == std::string::npos || closeParen <= openParen) {
-                return NULL_STR;
-            }
+        // Perform the delete operation
+        if (sourcePath.find('*') != std::string::npos) {
+            deleteFileOrDirectoryByPattern(sourcePath, logSource);
+        } else {
+            deleteFileOrDirectory(sourcePath, logSource);
+        }
+    }
+}
+
+
+void handleMirrorCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    // Early validation
+    if (cmd.size() < 2) {
+        #if USING_LOGGING_DIRECTIVE
+        if (!disableLogging)
+            logMessage("Mirror command requires at least a source path.");
+        #endif
+        return;
+    }
+    
+    // Extract and preprocess source path
+    std::string sourcePath = cmd[1];
+    preprocessPath(sourcePath, packagePath);
+    
+    // Extract destination path or use default
+    std::string destinationPath;
+    if (cmd.size() >= 3) {
+        destinationPath = cmd[2];
+        preprocessPath(destinationPath, packagePath);
+    } else {
+        destinationPath = ROOT_PATH;
+    }
+    
+    // Determine operation type using string_view to avoid string creation
+    const std::string_view commandName = cmd[0];
+    const std::string operation = (commandName == "mirror_copy" || commandName == "mirror_cp") ? "copy" : "delete";
+    
+    if (sourcePath.find('*') == std::string::npos) {
+        // Single directory mirror
+        mirrorFiles(sourcePath, destinationPath, operation);
+    } else {
+        // Wildcard mirror - get file list and process with immediate cleanup
+        auto fileList = getFilesListByWildcards(sourcePath);
         
-            const std::string parameters = placeholder.substr(openParen + 1, closeParen - openParen - 1);
+        // Process files one by one, freeing memory as we go
+        for (size_t i = 0; i < fileList.size(); ++i) {
+            // Move the string to avoid copy
+            const auto sourceDirectory = std::move(fileList[i]);
+            fileList[i].shrink_to_fit();     // Free the capacity
+            mirrorFiles(sourceDirectory, destinationPath, operation);
+            
+            // Clear the vector element immediately to free memory
+            //fileList[i].clear();
+        }
+    }
+}
+
+void handleMoveCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    // Declare only the strings we need
+    std::string sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath;
+    parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
+    
+    if (!sourceListPath.empty() && !destinationListPath.empty()) {
+        // Load filter sets (these are typically small)
+        std::unique_ptr<std::unordered_set<std::string>> copyFilterSet;
+        if (!copyFilterListPath.empty()) {
+            copyFilterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(copyFilterListPath));
+        }
         
-            const size_t firstCommaPos = parameters.find(',');
-            const size_t lastCommaPos  = parameters.find_last_of(',');
+        std::unique_ptr<std::unordered_set<std::string>> filterSet;
+        if (!filterListPath.empty()) {
+            filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath));
+        }
+    
+        // Pre-allocate strings to avoid reallocations in loop
+        //sourcePath.reserve(1024);
+        //destinationPath.reserve(1024);
+    
+        // Stream process both files line by line
+    #if !USING_FSTREAM_DIRECTIVE
+        FILE* sourceFile = fopen(sourceListPath.c_str(), "r");
+        FILE* destFile = fopen(destinationListPath.c_str(), "r");
         
-            if (firstCommaPos == std::string::npos
-             || lastCommaPos  == std::string::npos
-             || firstCommaPos == lastCommaPos) {
-                return NULL_STR;
+        if (!sourceFile || !destFile) {
+            if (sourceFile) fclose(sourceFile);
+            if (destFile) fclose(destFile);
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Failed to open source or destination list files");
+            #endif
+            return;
+        }
+        
+        // Set larger buffers for better I/O performance
+        static constexpr size_t FILE_BUFFER_SIZE = 8192;
+        setvbuf(sourceFile, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+        setvbuf(destFile, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+        
+        static constexpr size_t BUFFER_SIZE = 8192;
+        char sourceBuffer[BUFFER_SIZE];
+        char destBuffer[BUFFER_SIZE];
+        
+        // Static string for repeated log messages to reduce allocations
+        #if USING_LOGGING_DIRECTIVE
+        static const std::string skipDirMsg = "Skipping non-empty directory: ";
+        #endif
+        
+        // Process files line by line simultaneously
+        while (fgets(sourceBuffer, BUFFER_SIZE, sourceFile) && 
+               fgets(destBuffer, BUFFER_SIZE, destFile)) {
+            
+            // Optimized newline removal - scan once instead of using strlen
+            char* srcEnd = sourceBuffer;
+            while (*srcEnd && *srcEnd != '\n') ++srcEnd;
+            const size_t sourceLen = srcEnd - sourceBuffer;
+            *srcEnd = '\0';
+            
+            char* destEnd = destBuffer;
+            while (*destEnd && *destEnd != '\n') ++destEnd;
+            const size_t destLen = destEnd - destBuffer;
+            *destEnd = '\0';
+            
+            // Clear and append to reuse existing string capacity
+            sourcePath.clear();
+            sourcePath.append(sourceBuffer, sourceLen);
+            
+            destinationPath.clear();
+            destinationPath.append(destBuffer, destLen);
+            
+            preprocessPath(sourcePath, packagePath);
+            preprocessPath(destinationPath, packagePath);
+            
+            // Cache filter lookup result
+            const bool shouldProcess = !filterSet || filterSet->find(sourcePath) == filterSet->end();
+            
+            if (shouldProcess) {
+                // Check if it's a directory using the buffer directly (avoid string access)
+                const bool isDirectory = sourceLen > 0 && sourcePath[sourceLen - 1] == '/';
+                
+                if (!isDirectory) {
+                    // Check copy filter once and cache result
+                    const bool shouldCopy = copyFilterSet && copyFilterSet->find(sourcePath) != copyFilterSet->end();
+                    
+                    if (shouldCopy) {
+                        const long long totalSize = getTotalSize(sourcePath);
+                        long long totalBytesCopied = 0;
+                        copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
+                    } else {
+                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
+                    }
+                } else {
+                    if (isDirectoryEmpty(sourcePath)) {
+                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
+                    }
+                    #if USING_LOGGING_DIRECTIVE
+                    else if (!disableLogging) {
+                        logMessage(skipDirMsg + sourcePath);
+                    }
+                    #endif
+                }
+                hexOffsetIndex.invalidateUnder(sourcePath);
+                hexOffsetIndex.invalidateUnder(destinationPath);
             }
+            
+            // Periodically shrink strings if they've grown too large
+            // This prevents unbounded memory growth for very long paths
+            //if (sourcePath.capacity() > 8192) {
+            //    sourcePath.shrink_to_fit();
+            //}
+            //if (destinationPath.capacity() > 8192) {
+            //    destinationPath.shrink_to_fit();
+            //}
+        }
         
-            std::string str = parameters.substr(0, firstCommaPos);
-            std::string delimiter = parameters.substr(firstCommaPos + 1, lastCommaPos - firstCommaPos - 1);
-            std::string indexStr = parameters.substr(lastCommaPos + 1);
-        
-            trim(str);
-            removeQuotes(str);
-            trim(delimiter);
-            removeQuotes(delimiter);
-            trim(indexStr);
+        fclose(sourceFile);
+        fclose(destFile);
         
-            if (indexStr.empty() || !isValidNumber(indexStr)) {
-                return NULL_STR;
-            }
+    #else
+        std::ifstream sourceFile(sourceListPath);
+        std::ifstream destFile(destinationListPath);
         
-            std::string result = splitStringAtIndex(str, delimiter, ult::stoi(indexStr));
+        if (!sourceFile.is_open() || !destFile.is_open()) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Failed to open source or destination list files");
+            #endif
+            return;
+        }
         
-            return result.empty() ? NULL_STR : result;
-        }},
-        {"{math(", [&](const std::string& placeholder) { return returnOrNull(handleMath(placeholder)); }},
-        {"{length(", [&](const std::string& placeholder) { return returnOrNull(handleLength(placeholder)); }},
-    };
-
-    //generalPlaceholders = {
-    //    {"{ram_vendor}", memoryVendor},
-    //    {"{ram_model}", memoryModel},
-    //    {"{ams_version}", amsVersion},
-    //    {"{hos_version}", hosVersion},
-    //    {"{cpu_speedo}", ult::to_string(cpuSpeedo0)},
-    //    {"{cpu_iddq}", ult::to_string(cpuIDDQ)},
-    //    {"{gpu_speedo}", ult::to_string(cpuSpeedo2)},
-    //    {"{gpu_iddq}", ult::to_string(gpuIDDQ)},
-    //    {"{soc_speedo}", ult::to_string(socSpeedo0)},
-    //    {"{soc_iddq}", ult::to_string(socIDDQ)},
-    //    {"{title_id}", getTitleIdAsString()}
-    //};
-    updateGeneralPlaceholders();
-
-    // Iterate through each command and replace placeholders
-    for (auto& arg : cmd) {
-        //std::string originalArg = arg; // Store original to compare later
+        // Set larger buffers for better I/O performance
+        char sourceFileBuffer[8192], destFileBuffer[8192];
+        sourceFile.rdbuf()->pubsetbuf(sourceFileBuffer, sizeof(sourceFileBuffer));
+        destFile.rdbuf()->pubsetbuf(destFileBuffer, sizeof(destFileBuffer));
         
-        // Replace general placeholders - modify these functions to return bool
-        if (replacePlaceholdersInArg(arg, generalPlaceholders)) {
-            replacementsMade = true;
+        // Process files line by line simultaneously
+        while (std::getline(sourceFile, sourcePath) && std::getline(destFile, destinationPath)) {
+            preprocessPath(sourcePath, packagePath);
+            preprocessPath(destinationPath, packagePath);
+            
+            // Cache filter lookup result  
+            const bool shouldProcess = !filterSet || filterSet->find(sourcePath) == filterSet->end();
+            
+            if (shouldProcess) {
+                // Check if it's a directory (ends with /)
+                const bool isDirectory = !sourcePath.empty() && sourcePath.back() == '/';
+                
+                if (!isDirectory) {
+                    // Check copy filter once and cache result
+                    const bool shouldCopy = copyFilterSet && copyFilterSet->find(sourcePath) != copyFilterSet->end();
+                    
+                    if (shouldCopy) {
+                        const long long totalSize = getTotalSize(sourcePath);
+                        long long totalBytesCopied = 0;
+                        copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
+                    } else {
+                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
+                    }
+                } else {
+                    if (isDirectoryEmpty(sourcePath)) {
+                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
+                    }
+                    #if USING_LOGGING_DIRECTIVE
+                    else if (!disableLogging) {
+                        logMessage("Skipping non-empty directory: " + sourcePath);
+                    }
+                    #endif
+                }
+                hexOffsetIndex.invalidateUnder(sourcePath);
+                hexOffsetIndex.invalidateUnder(destinationPath);
+            }
         }
-
-        // Replace button/arrow placeholders from the global map
-        if (replacePlaceholdersInArg(arg, symbolPlaceholders)) {
-            replacementsMade = true;
+    #endif
+    
+        
+    } else {
+        // Single file/directory moving - early returns for error conditions
+        if (sourcePath.empty() || destinationPath.empty()) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Source and destination paths must be specified.");
+            #endif
+            return;
         }
-
-        // Resolve nested placeholders - modify this function to return bool
-        if (replacePlaceholdersRecursively(arg, placeholders)) {
-            replacementsMade = true;
+        
+        if (isDangerousCombination(sourcePath)) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Dangerous combination detected.");
+            #endif
+            return;
         }
         
-        // Alternative: Simple string comparison if you can't modify the helper functions
-        // if (arg != originalArg) {
-        //     replacementsMade = true;
-        // }
+        // Perform the move operation
+        if (sourcePath.find('*') != std::string::npos) {
+            moveFilesOrDirectoriesByPattern(sourcePath, destinationPath, logSource, logDestination);
+        } else {
+            moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
+        }
+        hexOffsetIndex.invalidateUnder(sourcePath);
+        hexOffsetIndex.invalidateUnder(destinationPath);
     }
-    
-    return replacementsMade;
 }
 
-
-
-// forward declarartion
-void processCommand(const std::vector<std::string>& cmd, const std::string& packagePath, const std::string& selectedCommand);
-
-
-/**
- * @brief Apply placeholder replacements to a list of commands and handle control flow commands.
- *
- * This function iterates over a list of commands, where each command is a vector of strings,
- * and applies the `applyPlaceholderReplacements` function to handle the placeholders.
- * It also handles control flow commands like "erista:" and "mariko:".
- * Optimized for minimal memory usage with in-place compaction.
- *
- * @param commands A list of commands, where each command is represented as a vector of strings.
- * @param packagePath The path to the package (optional).
- * @param selectedCommand A specific command to execute (optional).
- * @return Returns true if the placeholders were successfully applied to the commands, false otherwise.
- */
-bool applyPlaceholderReplacementsToCommands(std::vector<std::vector<std::string>>& commands, 
-                                           const std::string& packagePath = "", 
-                                           const std::string& selectedCommand = "") {
+void handleIniCommands(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    const std::string& command = cmd[0];
+    const size_t cmdSize = cmd.size();
     
-    std::string listString, listPath, jsonString, jsonPath, hexPath, iniPath;
-    bool inEristaSection = false;
-    bool inMarikoSection = false;
+    // All commands need at least sourcePath and section
+    if (cmdSize < 3)
+        return;
     
-    // Two-pointer technique: readIndex reads all commands, writeIndex writes kept commands
-    size_t writeIndex = 0;
+    std::string sourcePath = cmd[1];
+    preprocessPath(sourcePath, packagePath);
+    std::string desiredSection = cmd[2];
+    removeQuotes(desiredSection);
     
-    for (size_t readIndex = 0; readIndex < commands.size(); ++readIndex) {
-        auto& cmd = commands[readIndex];
+    if (command == "add-ini-section") {
+        addIniSection(sourcePath, desiredSection);
         
-        if (cmd.empty()) {
-            // Skip empty commands, don't increment writeIndex
-            cmd.shrink_to_fit();
-            continue;
-        }
-
-        const std::string_view commandName = cmd[0];
-
-        // Handle control flow commands
-        if (commandName == "erista:") {
-            inEristaSection = true;
-            inMarikoSection = false;
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue; // Don't keep this command
-        } else if (commandName == "mariko:") {
-            inEristaSection = false;
-            inMarikoSection = true;
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue; // Don't keep this command
-        } else if ((!commandName.empty() && commandName.front() == ';') ||
-                   (commandName.size() >= 7 && commandName.substr(commandName.size() - 7) == "_source") ||
-                   commandName == "logging") {
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue; // Don't keep this command
-        }
-
-        // Skip commands not relevant to current hardware
-        if ((inEristaSection && !usingErista) || (inMarikoSection && !usingMariko)) {
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue; // Don't keep this command
-        }
-
-        // Apply placeholder replacements
-        applyPlaceholderReplacements(cmd, hexPath, iniPath, listString, listPath, jsonString, jsonPath);
-
-        // Handle special commands
-        const size_t cmdSize = cmd.size();
-        bool shouldKeep = true;
-
-        if (commandName == LIST_STR && cmdSize >= 2) {
-            listString = cmd[1];
-            removeQuotes(listString);
-            shouldKeep = false;
-        } else if (commandName == LIST_FILE_STR && cmdSize >= 2) {
-            listPath = cmd[1];
-            preprocessPath(listPath, packagePath);
-            shouldKeep = false;
-        } else if (commandName == JSON_STR && cmdSize >= 2) {
-            jsonString = cmd[1];
-            shouldKeep = false;
-        } else if (commandName == JSON_FILE_STR && cmdSize >= 2) {
-            jsonPath = cmd[1];
-            preprocessPath(jsonPath, packagePath);
-            shouldKeep = false;
-        } else if (commandName == INI_FILE_STR && cmdSize >= 2) {
-            iniPath = cmd[1];
-            preprocessPath(iniPath, packagePath);
-            shouldKeep = false;
-        } else if (commandName == HEX_FILE_STR && cmdSize >= 2) {
-            hexPath = cmd[1];
-            preprocessPath(hexPath, packagePath);
-            shouldKeep = false;
-        } else if (commandName == "filter" || commandName == "file_name" || 
-                   commandName == "folder_name" || commandName == "sourced_path") {
-            shouldKeep = false;
+    } else if (command == "rename-ini-section" && cmdSize >= 4) {
+        std::string desiredNewSection = cmd[3];
+        removeQuotes(desiredNewSection);
+        renameIniSection(sourcePath, desiredSection, desiredNewSection);
+        
+    } else if (command == "remove-ini-section") {
+        removeIniSection(sourcePath, desiredSection);
+        
+    } else if (command == "remove-ini-key" && cmdSize >= 4) {
+        std::string desiredKey = cmd[3];
+        removeQuotes(desiredKey);
+        removeIniKey(sourcePath, desiredSection, desiredKey);
+        
+    } else if ((command == "set-ini-val" || command == "set-ini-value") && cmdSize >= 5) {
+        std::string desiredKey = cmd[3];
+        removeQuotes(desiredKey);
+        
+        std::string desiredValue;
+        for (size_t i = 4; i < cmdSize; ++i) {
+            if (i > 4)
+                desiredValue += ' ';
+            desiredValue += cmd[i];
         }
-
-        if (!shouldKeep) {
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            cmd = {};
-            continue; // Don't keep this command
+        removeQuotes(desiredValue);
+        
+        setIniFileValue(sourcePath, desiredSection, desiredKey, desiredValue);
+        
+    } else if (command == "set-ini-key" && cmdSize >= 5) {
+        std::string desiredKey = cmd[3];
+        removeQuotes(desiredKey);
+        
+        std::string desiredNewKey;
+        for (size_t i = 4; i < cmdSize; ++i) {
+            if (i > 4)
+                desiredNewKey += ' ';
+            desiredNewKey += cmd[i];
         }
+        removeQuotes(desiredNewKey);
+        
+        setIniFileKey(sourcePath, desiredSection, desiredKey, desiredNewKey);
+    }
 
-        // Apply quoting logic to arguments for commands we're keeping
-        for (size_t i = 1; i < cmd.size(); ++i) {
-            std::string& argument = cmd[i];
+    if (activeBatchCache)
+        activeBatchCache->invalidate(sourcePath);
+}
 
-            if (argument.empty()) {
-                argument = "''";
-                continue;
-            }
+void handleJsonCommands(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    const std::string& command = cmd[0];
+    const size_t cmdSize = cmd.size();
+    
+    if (cmdSize < 4)
+        return;
+    
+    std::string sourcePath = cmd[1];
+    preprocessPath(sourcePath, packagePath);
+    
+    std::string key = cmd[2];
+    removeQuotes(key);
+    
+    std::string value;
+    for (size_t i = 3; i < cmdSize; ++i) {
+        if (i > 3)
+            value += ' ';
+        value += cmd[i];
+    }
+    removeQuotes(value);
+    
+    if (command == "set-json-key") {
+        ult::renameJsonKey(sourcePath, key, value);
+    } else if (command == "set-json-val" || command == "set-json-value") {
+        ult::setJsonValue(sourcePath, key, value, true);
+    }
 
-            if (argument.size() >= 2 &&
-                ((argument.front() == '"' && argument.back() == '"') ||
-                 (argument.front() == '\'' && argument.back() == '\''))) {
-                continue;
-            }
+    if (activeBatchCache)
+        activeBatchCache->invalidate(sourcePath);
+}
 
-            if (argument.find(' ') == std::string::npos) {
-                continue;
-            }
+inline std::string getUnquoted(const std::vector<std::string>& cmd, size_t index) {
+    std::string value = cmd[index];
+    removeQuotes(value);
+    return value;
+}
 
-            // Optimized quoting - fewer string operations
-            const bool hasSingleQuote = argument.find('\'') != std::string::npos;
-            const bool hasDoubleQuote = argument.find('"') != std::string::npos;
-            
-            if (hasSingleQuote && !hasDoubleQuote) {
-                argument.insert(0, 1, '"');
-                argument.push_back('"');
-            } else {
-                argument.insert(0, 1, '\'');
-                argument.push_back('\'');
-            }
-        }
+/**
+ * @brief A find/replace hex edit, as produced by hex-by-swap/string/decimal/rdecimal.
+ */
+struct HexFindReplaceEdit {
+    std::string findHex;
+    std::string replacementHex;
+    size_t occurrence = 0;  // 0 replaces every match, otherwise only the n-th match (1-based)
+};
 
-        // Keep this command - move it to the write position
-        if (writeIndex != readIndex) {
-            commands[writeIndex] = std::move(cmd);
-            cmd.shrink_to_fit();
+/**
+ * @brief Resolves a hex-by-swap/string/decimal/rdecimal command into a find/replace edit.
+ *
+ * @return false if the command is not a find/replace edit or its arguments are invalid.
+ */
+bool buildHexFindReplace(const std::string& secondArg, const std::string& thirdArg, const std::string& fourthArg, const std::string& commandName, const std::vector<std::string>& cmd, HexFindReplaceEdit& edit) {
+    std::string& hexDataToReplace = edit.findHex;
+    std::string& hexDataReplacement = edit.replacementHex;
+    size_t occurrenceArgIndex = 0;
+    
+    if (commandName == "hex-by-swap") {
+        hexDataToReplace = secondArg;
+        hexDataReplacement = thirdArg;
+        occurrenceArgIndex = 4;
+        
+    } else if (commandName == "hex-by-string") {
+        hexDataToReplace = asciiToHex(secondArg);
+        hexDataReplacement = asciiToHex(thirdArg);
+        
+        // Pad to same length
+        const size_t lenDiff = (hexDataToReplace.length() > hexDataReplacement.length()) 
+            ? hexDataToReplace.length() - hexDataReplacement.length()
+            : hexDataReplacement.length() - hexDataToReplace.length();
+        
+        if (hexDataReplacement.length() < hexDataToReplace.length()) {
+            hexDataReplacement.append(lenDiff, '\0');
+        } else if (hexDataToReplace.length() < hexDataReplacement.length()) {
+            hexDataToReplace.append(lenDiff, '\0');
         }
-        ++writeIndex;
+        occurrenceArgIndex = 4;
+        
+    } else if (commandName == "hex-by-decimal") {
+        if (fourthArg.empty()) {
+            hexDataToReplace = decimalToHex(secondArg);
+            hexDataReplacement = decimalToHex(thirdArg);
+        } else {
+            if (!isValidNumber(fourthArg))
+                return false;
+            const size_t byteSize = ult::stoi(fourthArg);
+            hexDataToReplace = decimalToHex(secondArg, byteSize);
+            hexDataReplacement = decimalToHex(thirdArg, byteSize);
+        }
+        occurrenceArgIndex = 5;
+        
+    } else if (commandName == "hex-by-rdecimal") {
+        if (fourthArg.empty()) {
+            hexDataToReplace = decimalToReversedHex(secondArg);
+            hexDataReplacement = decimalToReversedHex(thirdArg);
+        } else {
+            if (!isValidNumber(fourthArg))
+                return false;
+            const size_t byteSize = ult::stoi(fourthArg);
+            hexDataToReplace = decimalToReversedHex(secondArg, byteSize);
+            hexDataReplacement = decimalToReversedHex(thirdArg, byteSize);
+        }
+        occurrenceArgIndex = 5;
+        
+    } else {
+        return false;
     }
     
-    // Resize to keep only the commands we want
-    commands.resize(writeIndex);
-    commands.shrink_to_fit();  // Always - maximize memory efficiency
-
-    // Shrink capacity if we removed a lot of commands
-    //if (commands.capacity() > commands.size() * 2) {
-    //    commands.shrink_to_fit();
-    //}
-
+    // Handle occurrence parameter if present
+    edit.occurrence = 0;
+    if (cmd.size() >= occurrenceArgIndex + 1) {
+        std::string occurrenceStr = cmd[occurrenceArgIndex];
+        removeQuotes(occurrenceStr);
+        if (!isValidNumber(occurrenceStr))
+            return false;
+        edit.occurrence = ult::stoi(occurrenceStr);
+    }
     return true;
 }
 
+void handleHexEdit(const std::string& sourcePath, const std::string& secondArg, const std::string& thirdArg, const std::string& fourthArg, const std::string& fifthArg, const std::string& commandName, const std::vector<std::string>& cmd) {
+    
+    if (commandName == "hex-by-offset") {
+        if (hexEditByOffset(sourcePath, secondArg, thirdArg) && isValidNumber(secondArg))
+            hexOffsetIndex.noteWrite(sourcePath, ult::stoi(secondArg), thirdArg.size() / 2);
+        else
+            hexOffsetIndex.invalidate(sourcePath);
+        return;
+    }
+    
+    HexFindReplaceEdit edit;
+    if (!buildHexFindReplace(secondArg, thirdArg, fourthArg, commandName, cmd, edit))
+        return;
 
+    if (edit.occurrence != 0) {
+        hexEditFindReplace(sourcePath, edit.findHex, edit.replacementHex, edit.occurrence);
+    } else {
+        hexEditFindReplace(sourcePath, edit.findHex, edit.replacementHex);
+    }
+    hexOffsetIndex.invalidate(sourcePath);
+}
 
 /**
- * @brief Interpret and execute a list of commands.
+ * @brief Applies several find/replace hex edits to one file with a single read pass.
  *
- * This function interprets and executes a list of commands based on their names and arguments.
- * Optimized for minimal memory usage by clearing processed commands immediately.
+ * All patterns are matched in one streaming scan (HEX_BUFFER_SIZE chunks, overlapping by the
+ * longest pattern) and the resulting patches are written back through one file handle. The
+ * result must equal running the edits one after another, so the function refuses (returns
+ * false, leaving the file untouched) whenever an edit could see bytes changed by an earlier
+ * one, when matches of one edit overlap, or when a pattern is not plain same-length hex.
  *
- * @param commands A list of commands, where each command is represented as a vector of strings.
+ * @param filePath The file to patch.
+ * @param edits The edits, in command order.
+ * @return true if the edits were applied.
  */
-bool interpretAndExecuteCommands(std::vector<std::vector<std::string>>&& commands, 
-                                const std::string& packagePath = "", 
-                                const std::string& selectedCommand = "") {
-    
-    #if USING_LOGGING_DIRECTIVE
-    if (!packagePath.empty()) {
-        disableLogging = !(parseValueFromIniSection(PACKAGES_INI_FILEPATH, getNameFromPath(packagePath), USE_LOGGING_STR) == TRUE_STR);
-        logFilePath = packagePath + "log.txt";
+bool hexEditFindReplaceFused(const std::string& filePath, const std::vector<HexFindReplaceEdit>& edits) {
+    struct Pattern {
+        std::string find;
+        std::string replacement;
+        size_t occurrence;
+        std::vector<size_t> matches;
+    };
+
+    std::vector<Pattern> patterns(edits.size());
+    std::array<std::vector<u16>, 256> patternsByFirstByte;
+    size_t maxLen = 0;
+
+    for (size_t e = 0; e < edits.size(); ++e) {
+        Pattern& pattern = patterns[e];
+        if (!decodeHexString(edits[e].findHex, pattern.find) ||
+            !decodeHexString(edits[e].replacementHex, pattern.replacement) ||
+            pattern.find.size() != pattern.replacement.size())
+            return false;
+        pattern.occurrence = edits[e].occurrence;
+        maxLen = std::max(maxLen, pattern.find.size());
+        patternsByFirstByte[static_cast<u8>(pattern.find[0])].push_back(static_cast<u16>(e));
     }
-    #endif
 
-    // Initialize buffer sizes based on expanded memory setting
-    //if (expandedMemory) {
-    //    COPY_BUFFER_SIZE = 262144;
-    //    HEX_BUFFER_SIZE = 8192;
-    //    UNZIP_READ_BUFFER = 262144;
-    //    UNZIP_WRITE_BUFFER = 131072;
-    //    DOWNLOAD_READ_BUFFER = 262144;
-    //    DOWNLOAD_WRITE_BUFFER = 131072;
-    //}
+    FILE* file = fopen(filePath.c_str(), "rb");
+    if (!file)
+        return false;
+
+    // Single pass over the file; positions whose longest pattern could run past the
+    // buffer are carried over into the next chunk. A few patterns each sweep the chunk with
+    // findBytePattern while it is still in cache; past FUSED_KERNEL_MAX_PATTERNS one byte-wise
+    // pass dispatching on the first byte is cheaper than that many sweeps.
+    static constexpr size_t FUSED_KERNEL_MAX_PATTERNS = 8;
+    const bool useKernel = patterns.size() <= FUSED_KERNEL_MAX_PATTERNS;
+    const size_t chunkSize = std::max<size_t>(HEX_BUFFER_SIZE, maxLen);
+    std::vector<u8> buffer(chunkSize + maxLen - 1);
+    size_t carried = 0;
+    size_t baseOffset = 0;
+    size_t pendingPatterns = patterns.size();
+    bool endOfFile = false;
+
+    while (!endOfFile && pendingPatterns > 0) {
+        const size_t bytesRead = fread(buffer.data() + carried, 1, chunkSize, file);
+        endOfFile = (bytesRead < chunkSize);
+        const size_t available = carried + bytesRead;
+        const size_t scanEnd = endOfFile ? available : available - (maxLen - 1);
+
+        if (useKernel) {
+            // Each pattern sweeps the cached chunk with the SIMD kernel
+            for (Pattern& pattern : patterns) {
+                const size_t len = pattern.find.size();
+                const size_t searchEnd = std::min(available, scanEnd + len - 1);
+                for (size_t pos = 0; pos < scanEnd; ++pos) {
+                    if (pattern.occurrence != 0 && pattern.matches.size() >= pattern.occurrence)
+                        break;
+                    const size_t hit = findBytePattern(buffer.data() + pos, searchEnd - pos,
+                                                       reinterpret_cast<const u8*>(pattern.find.data()), len);
+                    if (hit == std::string::npos || pos + hit >= scanEnd)
+                        break;
+                    pos += hit;
+                    pattern.matches.push_back(baseOffset + pos);
+                    if (pattern.occurrence != 0 && pattern.matches.size() == pattern.occurrence)
+                        --pendingPatterns;
+                }
+            }
+        } else {
+            for (size_t pos = 0; pos < scanEnd; ++pos) {
+                for (const u16 index : patternsByFirstByte[buffer[pos]]) {
+                    Pattern& pattern = patterns[index];
+                    const size_t len = pattern.find.size();
+                    if (pos + len > available || (pattern.occurrence != 0 && pattern.matches.size() >= pattern.occurrence))
+                        continue;
+                    if (std::memcmp(buffer.data() + pos, pattern.find.data(), len) == 0) {
+                        pattern.matches.push_back(baseOffset + pos);
+                        if (pattern.occurrence != 0 && pattern.matches.size() == pattern.occurrence)
+                            --pendingPatterns;
+                    }
+                }
+            }
+        }
 
-    // Load and apply buffer configuration from INI file
-    const auto bufferSection = getKeyValuePairsFromSection(ULTRAHAND_CONFIG_INI_PATH, MEMORY_STR);
-    
-    if (!bufferSection.empty()) {
-        struct BufferConfig {
-            const char* key;
-            size_t* target;
-        };
-        
-        const BufferConfig configs[] = {
-            {"copy_buffer_size", &COPY_BUFFER_SIZE},
-            {"unzip_read_buffer", &UNZIP_READ_BUFFER},
-            {"unzip_write_buffer", &UNZIP_WRITE_BUFFER},
-            {"download_read_buffer", &DOWNLOAD_READ_BUFFER},
-            {"download_write_buffer", &DOWNLOAD_WRITE_BUFFER},
-            {"hex_buffer_size", &HEX_BUFFER_SIZE}
-        };
-        
-        for (const auto& config : configs) {
-            const auto it = bufferSection.find(config.key);
-            if (it != bufferSection.end()) {
-                *config.target = ult::stoi(it->second);
+        carried = available - scanEnd;
+        std::memmove(buffer.data(), buffer.data() + scanEnd, carried);
+        baseOffset += scanEnd;
+    }
+
+    // Patches per edit: every match, or only the requested occurrence
+    struct Patch {
+        size_t offset;
+        size_t edit;
+    };
+    std::vector<Patch> patches;
+    for (size_t e = 0; e < patterns.size(); ++e) {
+        const Pattern& pattern = patterns[e];
+        if (pattern.occurrence == 0) {
+            for (size_t m = 0; m < pattern.matches.size(); ++m) {
+                if (m > 0 && pattern.matches[m] - pattern.matches[m - 1] < pattern.find.size()) {
+                    fclose(file);
+                    return false;  // overlapping matches depend on replacement order
+                }
+                patches.push_back({pattern.matches[m], e});
             }
+        } else if (pattern.matches.size() >= pattern.occurrence) {
+            patches.push_back({pattern.matches[pattern.occurrence - 1], e});
         }
     }
 
-    // Initialize state variables
-    bool inEristaSection = false;
-    bool inMarikoSection = false;
-    bool inTrySection = false;
-    
-    // String buffers for command processing
-    std::string listString, listPath, jsonString, jsonPath, hexPath, iniPath;
-    
-    #if USING_LOGGING_DIRECTIVE
-    std::string messageBuffer;
-    #endif
+    if (patches.size() * patterns.size() > 4096) {
+        fclose(file);
+        return false;  // too many patches to verify cheaply
+    }
+
+    // Verify that no edit could observe an earlier edit's bytes: neither through a match that
+    // overlaps an earlier patch nor through a match that the earlier patches would create
+    std::string window;
+    for (size_t j = 1; j < patterns.size(); ++j) {
+        const Pattern& later = patterns[j];
+        const size_t len = later.find.size();
 
-    // Reset global state
-    commandSuccess.store(true, std::memory_order_release);
-    refreshPage.store(false, std::memory_order_release);
-    refreshPackage.store(false, std::memory_order_release);
-    interpreterLogging.store(false, std::memory_order_release);
+        for (const Patch& patch : patches) {
+            if (patch.edit >= j)
+                continue;
+            const Pattern& earlier = patterns[patch.edit];
+            const size_t patchEnd = patch.offset + earlier.find.size();
 
-    // Process commands one by one, clearing each after processing
-    for (size_t i = 0; i < commands.size(); ++i) {
-        // Check for abort signal
-        if (abortCommand.exchange(false, std::memory_order_acq_rel)) {
-            //abortCommand.store(false, std::memory_order_release);
-            commandSuccess.store(false, std::memory_order_release);
-            // Clear all remaining commands
-            //for (size_t j = i; j < commands.size(); ++j) {
-            //    commands[j].clear();
-            //    commands[j].shrink_to_fit();
-            //}
-            commands = {};
-            //commands.clear();
-            //commands.shrink_to_fit();
-            #if USING_LOGGING_DIRECTIVE
-            disableLogging = true;
-            logFilePath = defaultLogFilePath;
-            #endif
-            return commandSuccess;
-        }
+            const auto firstAfter = std::lower_bound(later.matches.begin(), later.matches.end(),
+                patch.offset > len - 1 ? patch.offset - (len - 1) : 0);
+            if (firstAfter != later.matches.end() && *firstAfter < patchEnd) {
+                fclose(file);
+                return false;
+            }
 
-        auto& cmd = commands[i];
-        
-        // Skip empty commands
-        if (cmd.empty()) {
-            continue;
-        }
+            if (earlier.find == earlier.replacement)
+                continue;
 
-        // Use string_view to avoid copying command name
-        const std::string_view commandName = cmd[0];
+            const size_t windowStart = patch.offset > len - 1 ? patch.offset - (len - 1) : 0;
+            window.resize(patchEnd - windowStart + len - 1);
+            fseek(file, static_cast<long>(windowStart), SEEK_SET);
+            window.resize(fread(window.data(), 1, window.size(), file));
 
-        // Handle control flow commands
-        if (commandName == "try:") {
-            if (inTrySection && commandSuccess.load(std::memory_order_acquire)) {
-                // Clear remaining commands and exit
-                //for (size_t j = i; j < commands.size(); ++j) {
-                //    commands[j].clear();
-                //    commands[j].shrink_to_fit();
-                //}
-                //commands.clear();
-                //commands.shrink_to_fit();
-                commands = {};
-                #if USING_LOGGING_DIRECTIVE
-                disableLogging = true;
-                logFilePath = defaultLogFilePath;
-                #endif
-                return true;
+            for (const Patch& other : patches) {
+                if (other.edit >= j)
+                    continue;
+                const std::string& bytes = patterns[other.edit].replacement;
+                const size_t from = std::max(other.offset, windowStart);
+                const size_t to = std::min(other.offset + bytes.size(), windowStart + window.size());
+                for (size_t pos = from; pos < to; ++pos)
+                    window[pos - windowStart] = bytes[pos - other.offset];
             }
-            commandSuccess.store(true, std::memory_order_release);
-            inTrySection = true;
-            // Clear and continue
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue;
-        }
-        
-        if (commandName == "erista:") {
-            inEristaSection = true;
-            inMarikoSection = false;
-            // Clear and continue
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue;
-        }
-        
-        if (commandName == "mariko:") {
-            inEristaSection = false;
-            inMarikoSection = true;
-            // Clear and continue
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue;
-        }
 
-        // Skip commands in try section if previous command failed
-        if (!commandSuccess.load(std::memory_order_acquire) && inTrySection) {
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue;
+            if (findBytePattern(window, later.find) != std::string::npos) {
+                fclose(file);
+                return false;
+            }
         }
+    }
+    fclose(file);
 
-        // Determine if command should execute based on platform sections
-        const bool shouldExecute = 
-            (inEristaSection && !inMarikoSection && usingErista) ||
-            (!inEristaSection && inMarikoSection && usingMariko) ||
-            (!inEristaSection && !inMarikoSection);
+    if (patches.empty())
+        return true;
 
-        if (!shouldExecute) {
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue;
-        }
+    std::sort(patches.begin(), patches.end(), [](const Patch& a, const Patch& b) {
+        return a.offset < b.offset;
+    });
 
-        // Only execute if not in try section or if we're succeeding in try section
-        if (inTrySection && !commandSuccess.load(std::memory_order_acquire)) {
-            cmd = {};
-            //cmd.clear();
-            //cmd.shrink_to_fit();
-            continue;
+    file = fopen(filePath.c_str(), "r+b");
+    if (!file)
+        return false;
+
+    for (const Patch& patch : patches) {
+        const std::string& bytes = patterns[patch.edit].replacement;
+        if (fseek(file, static_cast<long>(patch.offset), SEEK_SET) != 0 ||
+            fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+            fclose(file);
+            // Earlier patches may already be on disk
+            clearHexSumCache();
+            hexOffsetIndex.invalidate(filePath);
+            return false;
         }
+    }
+    fclose(file);
 
-        // Apply placeholder replacements only if needed
-        bool hasPlaceholders = false;
-        for (const auto& arg : cmd) {
-            if (arg.find('{') != std::string::npos) {
-                hasPlaceholders = true;
+    clearHexSumCache();
+    hexOffsetIndex.invalidate(filePath);
+    return true;
+}
+
+// Find/replace hex commands that can be fused into one pass over their file
+inline bool isFindReplaceHexCommand(std::string_view commandName) {
+    return commandName == "hex-by-swap" || commandName == "hex-by-string" ||
+           commandName == "hex-by-decimal" || commandName == "hex-by-rdecimal";
+}
+
+/**
+ * @brief Runs a group of consecutive find/replace hex commands that target the same file.
+ *
+ * Starting at commands[first], collects following hex-by-swap/string/decimal/rdecimal commands
+ * on the same path (without pending placeholders) and applies them with
+ * hexEditFindReplaceFused, falling back to one hexEditFindReplace per edit when fusing is not
+ * safe. Consumed commands are cleared.
+ *
+ * @return The number of commands consumed, or 0 if fewer than two edits could be grouped.
+ */
+size_t handleFusedHexEdits(std::vector<std::vector<std::string>>& commands, size_t first, const std::string& packagePath) {
+    std::string sourcePath = commands[first][1];
+    preprocessPath(sourcePath, packagePath);
+
+    std::vector<HexFindReplaceEdit> edits;
+    std::string candidatePath;
+    size_t next = first;
+
+    for (; next < commands.size(); ++next) {
+        const auto& cmd = commands[next];
+        if (cmd.size() < 4 || !isFindReplaceHexCommand(cmd[0]))
+            break;
+
+        if (next != first) {
+            if (std::any_of(cmd.begin(), cmd.end(), [](const std::string& arg) { return arg.find('{') != std::string::npos; }))
+                break;
+            candidatePath = cmd[1];
+            preprocessPath(candidatePath, packagePath);
+            if (candidatePath != sourcePath)
                 break;
-            }
-        }
-        
-        if (hasPlaceholders) {
-            applyPlaceholderReplacements(cmd, hexPath, iniPath, listString, listPath, jsonString, jsonPath);
         }
 
-        #if USING_LOGGING_DIRECTIVE
-        if (interpreterLogging.load(std::memory_order_acquire)) {
-            disableLogging = false;
-        }
+        HexFindReplaceEdit edit;
+        if (!buildHexFindReplace(getUnquoted(cmd, 2), getUnquoted(cmd, 3), cmd.size() >= 5 ? getUnquoted(cmd, 4) : std::string(), cmd[0], cmd, edit))
+            break;
+        edits.push_back(std::move(edit));
+    }
 
-        if (!disableLogging) {
-            // Build log message efficiently
-            messageBuffer.clear();
-            messageBuffer += "Executing command: ";
-            for (const auto& token : cmd) {
-                messageBuffer += token;
-                messageBuffer += ' ';
-            }
-            
-            logMessage(messageBuffer);
-        }
-        #endif
+    if (edits.size() < 2)
+        return 0;
 
-        const size_t cmdSize = cmd.size();
+    #if USING_LOGGING_DIRECTIVE
+    // The first command was already logged by the interpreter loop
+    if (!disableLogging) {
+        std::string messageBuffer;
+        for (size_t index = first + 1; index < first + edits.size(); ++index)
+            logExecutingCommand(commands[index], messageBuffer);
+    }
+    #endif
 
-        // Process different command types with direct assignment to reuse string buffers
-        if (commandName == LIST_STR) {
-            if (cmdSize >= 2) {
-                listString = cmd[1]; // Reuses existing string buffer
-                removeQuotes(listString);
-            }
-        } 
-        else if (commandName == LIST_FILE_STR) {
-            if (cmdSize >= 2) {
-                listPath = cmd[1];
-                preprocessPath(listPath, packagePath);
-            }
-        } 
-        else if (commandName == JSON_STR) {
-            if (cmdSize >= 2) {
-                jsonString = cmd[1];
-            }
-        } 
-        else if (commandName == JSON_FILE_STR) {
-            if (cmdSize >= 2) {
-                jsonPath = cmd[1];
-                preprocessPath(jsonPath, packagePath);
-            }
-        } 
-        else if (commandName == INI_FILE_STR) {
-            if (cmdSize >= 2) {
-                iniPath = cmd[1];
-                preprocessPath(iniPath, packagePath);
-            }
-        } 
-        else if (commandName == HEX_FILE_STR) {
-            if (cmdSize >= 2) {
-                hexPath = cmd[1];
-                preprocessPath(hexPath, packagePath);
+    if (!hexEditFindReplaceFused(sourcePath, edits)) {
+        #if USING_LOGGING_DIRECTIVE
+        if (!disableLogging)
+            logMessage("Hex edits on " + sourcePath + " could not be fused, applying them one by one.");
+        #endif
+        for (const auto& edit : edits) {
+            if (edit.occurrence != 0) {
+                hexEditFindReplace(sourcePath, edit.findHex, edit.replacementHex, edit.occurrence);
+            } else {
+                hexEditFindReplace(sourcePath, edit.findHex, edit.replacementHex);
             }
-        } 
-        else {
-            // Process all other commands
-            processCommand(cmd, packagePath, selectedCommand);
         }
-        
-        // Clear the processed command immediately to free its memory
-        cmd = {};
-        //cmd.clear();
-        //cmd.shrink_to_fit();
+        hexOffsetIndex.invalidate(sourcePath);
     }
-
-    // Final cleanup
-    commands = {};
-    //commands.clear();
-    //commands.shrink_to_fit();
-
     #if USING_LOGGING_DIRECTIVE
-    disableLogging = true;
-    logFilePath = defaultLogFilePath;
+    else if (!disableLogging) {
+        logMessage("Applied " + ult::to_string(edits.size()) + " hex edits to " + sourcePath + " in one pass.");
+    }
     #endif
 
-    return commandSuccess.load(std::memory_order_acquire);
-}
+    for (size_t index = first; index < first + edits.size(); ++index)
+        commands[index] = {};
 
+    return edits.size();
+}
 
-// Helper function to parse command arguments
-void parseCommandArguments(const std::vector<std::string>& cmd, const std::string& packagePath, std::string& sourceListPath, std::string& destinationListPath, std::string& logSource, std::string& logDestination, std::string& sourcePath, std::string& destinationPath, std::string& copyFilterListPath, std::string& filterListPath) {
-    for (size_t i = 1; i < cmd.size(); ++i) {
-        if (cmd[i] == "-src" && i + 1 < cmd.size()) {
-            sourceListPath = cmd[++i];
-            preprocessPath(sourceListPath, packagePath);
-        } else if (cmd[i] == "-dest" && i + 1 < cmd.size()) {
-            destinationListPath = cmd[++i];
-            preprocessPath(destinationListPath, packagePath);
-        } else if (cmd[i] == "-log_src" && i + 1 < cmd.size()) {
-            logSource = cmd[++i];
-            preprocessPath(logSource, packagePath);
-        } else if (cmd[i] == "-log_dest" && i + 1 < cmd.size()) {
-            logDestination = cmd[++i];
-            preprocessPath(logDestination, packagePath);
-        } else if ((cmd[i] == "-copy_filter" || cmd[i] == "-cp_filter") && i + 1 < cmd.size()) {
-            copyFilterListPath = cmd[++i];
-            preprocessPath(copyFilterListPath, packagePath);
-        } else if (cmd[i] == "-filter" && i + 1 < cmd.size()) {
-            filterListPath = cmd[++i];
-            preprocessPath(filterListPath, packagePath);
-        } else if (sourcePath.empty()) {
-            sourcePath = cmd[i];
-            preprocessPath(sourcePath, packagePath);
-        } else if (destinationPath.empty()) {
-            destinationPath = cmd[i];
-            preprocessPath(destinationPath, packagePath);
+void handleHexByCustom(const std::string& sourcePath, const std::string& customPattern, const std::string& offset, std::string hexDataReplacement, const std::string& commandName, std::string byteGroupSize) {
+    if (hexDataReplacement != NULL_STR) {
+        if (commandName == "hex-by-custom-decimal-offset") {
+            if (!byteGroupSize.empty()) {
+                if (!isValidNumber(byteGroupSize)) {
+                    return;
+                }
+                hexDataReplacement = decimalToHex(hexDataReplacement, ult::stoi(byteGroupSize));
+            } else {
+                hexDataReplacement = decimalToHex(hexDataReplacement);
+            }
+        } else if (commandName == "hex-by-custom-rdecimal-offset") {
+            if (!byteGroupSize.empty()) {
+                if (!isValidNumber(byteGroupSize)) {
+                    return;
+                }
+                hexDataReplacement = decimalToReversedHex(hexDataReplacement, ult::stoi(byteGroupSize));
+            } else {
+                hexDataReplacement = decimalToReversedHex(hexDataReplacement);
+            }
+        }
+
+        // Resolve the anchor through the persistent index; fall back to a full scan otherwise
+        size_t anchorOffset;
+        if (isValidNumber(offset) && hexOffsetIndex.lookup(sourcePath, customPattern, 0, anchorOffset)) {
+            const size_t totalOffset = anchorOffset + ult::stoi(offset);
+            if (hexEditByOffset(sourcePath, ult::to_string(totalOffset), hexDataReplacement))
+                hexOffsetIndex.noteWrite(sourcePath, totalOffset, hexDataReplacement.size() / 2);
+            else
+                hexOffsetIndex.invalidate(sourcePath);
+        } else {
+            hexEditByCustomOffset(sourcePath, customPattern, offset, hexDataReplacement);
+            hexOffsetIndex.invalidate(sourcePath);
         }
     }
 }
 
 
-void handleMakeDirCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
-    if (cmd.size() >= 2) {
-        std::string sourcePath = cmd[1];
-        preprocessPath(sourcePath, packagePath);
-        createDirectory(sourcePath);
-    }
-}
+/**
+ * @brief Streaming pchtxt to IPS converter.
+ *
+ * Parses a pchtxt file line by line into fixed buffers and writes records through a buffered
+ * writer, so memory use does not grow with the patch size. Output goes to
+ * "<outputFolder><nsobid>.ips"; IPS32 is used when a patch lies beyond the 24-bit IPS offset
+ * range. One converter can be reused for any number of files.
+ */
+class PchtxtIpsConverter {
+public:
+    PchtxtIpsConverter() : lineBuffer(LINE_BUFFER_SIZE), valueBuffer(LINE_BUFFER_SIZE), writeBuffer(WRITE_BUFFER_SIZE) {}
 
-void handleCopyCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
-    // Declare only the strings we always need
-    std::string sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath;
-    parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
-    
-    if (!sourceListPath.empty() && !destinationListPath.empty()) {
-        // Process list-based copying
-        auto sourceFilesList = readListFromFile(sourceListPath);
-        auto destinationFilesList = readListFromFile(destinationListPath);
-        
-        // Only create filterSet if filter file exists
-        std::unique_ptr<std::unordered_set<std::string>> filterSet;
-        if (!filterListPath.empty()) {
-            filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath));
+    bool convert(const std::string& pchtxtPath, std::string outputFolder) {
+        FILE* input = fopen(pchtxtPath.c_str(), "r");
+        if (!input)
+            return false;
+
+        // First pass only sizes the patch so the IPS flavour is known before writing
+        std::string buildId;
+        size_t maxEnd = 0;
+        bool needsIps32 = false;
+        const bool parsed = parse(input, buildId, [&](size_t offset, const u8*, size_t length) {
+            maxEnd = std::max(maxEnd, offset + length);
+            if (offset == IPS_EOF_OFFSET)
+                needsIps32 = true;
+            return true;
+        });
+        if (!parsed || buildId.empty() || maxEnd > 0xFFFFFFFFULL) {
+            fclose(input);
+            return false;
         }
-        
-        const size_t listSize = std::min(sourceFilesList.size(), destinationFilesList.size());
-        for (size_t i = 0; i < listSize; ++i) {
-            // Reuse existing sourcePath and destinationPath strings
-            sourcePath = std::move(sourceFilesList[i]);
-            sourceFilesList[i].shrink_to_fit();     // Free the capacity
-            preprocessPath(sourcePath, packagePath);
-            
-            destinationPath = std::move(destinationFilesList[i]);
-            destinationFilesList[i].shrink_to_fit(); // Free the capacity
-            preprocessPath(destinationPath, packagePath);
-            
-            // Only check filter if it exists
-            const bool shouldCopy = !filterSet || filterSet->find(sourcePath) == filterSet->end();
-            
-            if (shouldCopy) {
-                const long long totalSize = getTotalSize(sourcePath);
-                long long totalBytesCopied = 0;
-                copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
+        needsIps32 = needsIps32 || maxEnd > 0x1000000;
+
+        if (!outputFolder.empty() && outputFolder.back() != '/')
+            outputFolder += '/';
+        createDirectory(outputFolder);
+
+        const std::string outputPath = outputFolder + buildId + ".ips";
+        output = fopen(outputPath.c_str(), "wb");
+        if (!output) {
+            fclose(input);
+            return false;
+        }
+        writeUsed = 0;
+        writeFailed = false;
+
+        write(needsIps32 ? "IPS32" : "PATCH", 5);
+        rewind(input);
+        const bool written = parse(input, buildId, [&](size_t offset, const u8* data, size_t length) {
+            if (needsIps32 && offset == IPS32_EOF_OFFSET)
+                return false;
+            u8 header[6];
+            size_t headerSize = 0;
+            if (needsIps32)
+                header[headerSize++] = static_cast<u8>(offset >> 24);
+            header[headerSize++] = static_cast<u8>(offset >> 16);
+            header[headerSize++] = static_cast<u8>(offset >> 8);
+            header[headerSize++] = static_cast<u8>(offset);
+            header[headerSize++] = static_cast<u8>(length >> 8);
+            header[headerSize++] = static_cast<u8>(length);
+            write(header, headerSize);
+            write(data, length);
+            return !writeFailed;
+        });
+        if (written)
+            write(needsIps32 ? "EEOF" : "EOF", needsIps32 ? 4 : 3);
+        flushOutput();
+
+        fclose(input);
+        const bool success = (fclose(output) == 0) && written && !writeFailed;
+        output = nullptr;
+        if (!success)
+            deleteFileOrDirectory(outputPath);
+        return success;
+    }
+
+private:
+    static constexpr size_t LINE_BUFFER_SIZE = 4096;
+    static constexpr size_t WRITE_BUFFER_SIZE = 16384;
+    static constexpr size_t IPS_EOF_OFFSET = 0x454F46;      // "EOF" read as an offset
+    static constexpr size_t IPS32_EOF_OFFSET = 0x45454F46;  // "EEOF" read as an offset
+
+    std::vector<char> lineBuffer;
+    std::vector<u8> valueBuffer;  // as large as a line, so no decoded value can outgrow it
+    std::vector<u8> writeBuffer;
+    size_t writeUsed = 0;
+    bool writeFailed = false;
+    FILE* output = nullptr;
+
+    void write(const void* data, size_t length) {
+        const u8* bytes = static_cast<const u8*>(data);
+        while (length > 0 && !writeFailed) {
+            if (writeUsed == writeBuffer.size())
+                flushOutput();
+            const size_t chunk = std::min(length, writeBuffer.size() - writeUsed);
+            std::memcpy(writeBuffer.data() + writeUsed, bytes, chunk);
+            writeUsed += chunk;
+            bytes += chunk;
+            length -= chunk;
+        }
+    }
+
+    void flushOutput() {
+        if (writeUsed > 0 && fwrite(writeBuffer.data(), 1, writeUsed, output) != writeUsed)
+            writeFailed = true;
+        writeUsed = 0;
+    }
+
+    static int hexNibble(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Decodes a patch value (hex bytes or a quoted string) into valueBuffer
+    bool parseValue(const char* text, size_t& length) {
+        length = 0;
+        if (*text == '"') {
+            for (++text; *text && *text != '"'; ++text) {
+                char c = *text;
+                if (c == '\\' && text[1]) {
+                    ++text;
+                    switch (*text) {
+                        case 'n': c = '\n'; break;
+                        case 't': c = '\t'; break;
+                        case 'r': c = '\r'; break;
+                        case '0': c = '\0'; break;
+                        default: c = *text; break;
+                    }
+                }
+                if (length == valueBuffer.size())
+                    return false;
+                valueBuffer[length++] = static_cast<u8>(c);
             }
+            return *text == '"' && length > 0;
         }
-        
-    } else {
-        // Single file/directory copying - early returns to avoid unnecessary work
-        if (sourcePath.empty() || destinationPath.empty()) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Source and destination paths must be specified.");
-            #endif
-            return;
+
+        for (; *text && !std::isspace(static_cast<unsigned char>(*text)) && *text != '/'; text += 2) {
+            const int high = hexNibble(text[0]);
+            const int low = high < 0 ? -1 : hexNibble(text[1]);
+            if (low < 0 || length == valueBuffer.size())
+                return false;
+            valueBuffer[length++] = static_cast<u8>((high << 4) | low);
         }
-        
-        if (!isFileOrDirectory(sourcePath)) {
+        return length > 0;
+    }
+
+    template <typename OnPatch>
+    bool parse(FILE* input, std::string& buildId, OnPatch&& onPatch) {
+        size_t offsetShift = 0;
+        bool enabled = false;
+
+        while (fgets(lineBuffer.data(), static_cast<int>(lineBuffer.size()), input)) {
+            char* line = lineBuffer.data();
+            size_t lineLength = std::strlen(line);
+
+            // Lines longer than the buffer cannot hold a valid patch; skip the remainder
+            if (lineLength == lineBuffer.size() - 1 && line[lineLength - 1] != '\n') {
+                int c;
+                while ((c = fgetc(input)) != EOF && c != '\n') {}
+                continue;
+            }
+
+            while (lineLength > 0 && std::isspace(static_cast<unsigned char>(line[lineLength - 1])))
+                line[--lineLength] = '\0';
+            while (*line && std::isspace(static_cast<unsigned char>(*line)))
+                ++line;
+            if (*line == '\0' || *line == '#' || (line[0] == '/' && line[1] == '/'))
+                continue;
+
+            if (*line == '@') {
+                if (std::strncmp(line, "@nsobid-", 8) == 0) {
+                    buildId.assign(line + 8, std::strcspn(line + 8, " \t"));
+                } else if (std::strncmp(line, "@flag offset_shift", 18) == 0) {
+                    offsetShift = std::strtoull(line + 18, nullptr, 0);
+                } else if (std::strncmp(line, "@enabled", 8) == 0) {
+                    enabled = true;
+                } else if (std::strncmp(line, "@disabled", 9) == 0) {
+                    enabled = false;
+                } else if (std::strncmp(line, "@stop", 5) == 0) {
+                    break;
+                }
+                continue;
+            }
+
+            if (!enabled)
+                continue;
+
+            char* valueStart = nullptr;
+            const size_t offset = std::strtoull(line, &valueStart, 16);
+            if (valueStart == line || !std::isspace(static_cast<unsigned char>(*valueStart)))
+                continue;
+            while (std::isspace(static_cast<unsigned char>(*valueStart)))
+                ++valueStart;
+
+            size_t length;
+            if (!parseValue(valueStart, length))
+                continue;
+            if (!onPatch(offset + offsetShift, valueBuffer.data(), length))
+                return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Converts one pchtxt file, or every file matched by a wildcard, to IPS patches.
+ */
+bool convertPchtxtToIps(const std::string& sourcePath, const std::string& outputFolder) {
+    PchtxtIpsConverter converter;
+    if (sourcePath.find('*') == std::string::npos)
+        return converter.convert(sourcePath, outputFolder);
+
+    const auto fileList = getFilesListByWildcards(sourcePath);
+    bool success = !fileList.empty();
+    for (const auto& pchtxtPath : fileList) {
+        if (abortFileOp.load(std::memory_order_acquire))
+            return false;
+        if (!converter.convert(pchtxtPath, outputFolder)) {
+            success = false;
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Source file or directory doesn't exist: " + sourcePath);
+                logMessage("Failed to convert " + pchtxtPath + " to IPS.");
             #endif
-            return;
-        }
-        
-        if (sourcePath.find('*') != std::string::npos) {
-            copyFileOrDirectoryByPattern(sourcePath, destinationPath, logSource, logDestination);
-        } else {
-            const long long totalSize = getTotalSize(sourcePath);
-            long long totalBytesCopied = 0;
-            copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize, logSource, logDestination);
         }
     }
+    return success;
 }
 
-void handleDeleteCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
-    // Declare only the strings we need
-    std::string sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath;
-    parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
-    
-    if (!sourceListPath.empty()) {
-        // Process list-based deletion
-        auto sourceFilesList = readListFromFile(sourceListPath);
-        
-        // Only create filterSet if filter file exists
-        std::unique_ptr<std::unordered_set<std::string>> filterSet;
-        if (!filterListPath.empty()) {
-            filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath));
-        }
-        
-        for (size_t i = 0; i < sourceFilesList.size(); ++i) {
-            // Move string to avoid copy
-            sourcePath = std::move(sourceFilesList[i]);
-            sourceFilesList[i].shrink_to_fit();     // Free the capacity
-            preprocessPath(sourcePath, packagePath);
-            
-            // Only check filter if it exists
-            const bool shouldDelete = !filterSet || filterSet->find(sourcePath) == filterSet->end();
-            
-            if (shouldDelete) {
-                deleteFileOrDirectory(sourcePath);
-            }
-            
-            // Clear the vector element immediately to free memory
-            //sourceFilesList[i].clear();
+/**
+ * @brief Converts one pchtxt file, or every file matched by a wildcard, to cheats.
+ */
+bool convertPchtxtToCheat(const std::string& sourcePath) {
+    if (sourcePath.find('*') == std::string::npos)
+        return pchtxt2cheat(sourcePath);
+
+    const auto fileList = getFilesListByWildcards(sourcePath);
+    bool success = !fileList.empty();
+    for (const auto& pchtxtPath : fileList) {
+        if (abortFileOp.load(std::memory_order_acquire))
+            return false;
+        success = pchtxt2cheat(pchtxtPath) && success;
+    }
+    return success;
+}
+
+
+/**
+ * @brief Persistent HTTP validators for downloaded files.
+ *
+ * Remembers the ETag/Last-Modified a URL was served with, the path it was saved to and
+ * that file's stamp (see readFileStamp). While the saved copy is unchanged, downloads of
+ * the URL become conditional requests and a 304 keeps the local file. The cache lives in
+ * SETTINGS_PATH/http_cache.ini with one section per URL.
+ */
+class HttpValidatorCache {
+public:
+    // Validators for a conditional request, if the cached copy at localPath is intact
+    bool lookup(const std::string& url, const std::string& localPath, std::string& etag, std::string& lastModified) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ensureLoaded();
+
+        const auto sectionIt = cacheData.find(url);
+        if (sectionIt == cacheData.end())
+            return false;
+        auto& section = sectionIt->second;
+
+        std::string stamp;
+        if (section["path"] != localPath || !readFileStamp(localPath, stamp) || section["stamp"] != stamp) {
+            cacheData.erase(sectionIt);
+            save();
+            return false;
         }
-        
-    } else {
-        // Single file/directory deletion - early returns for error conditions
-        if (sourcePath.empty()) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Source path must be specified.");
-            #endif
+        etag = section["etag"];
+        lastModified = section["last_modified"];
+        return !etag.empty() || !lastModified.empty();
+    }
+
+    void store(const std::string& url, const std::string& localPath, const std::string& etag, const std::string& lastModified) {
+        // Section names cannot carry brackets or line breaks
+        if (url.find_first_of("[]\r\n") != std::string::npos)
             return;
-        }
-        
-        if (isDangerousCombination(sourcePath)) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Dangerous combination detected.");
-            #endif
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ensureLoaded();
+
+        std::string stamp;
+        if ((etag.empty() && lastModified.empty()) || !readFileStamp(localPath, stamp)) {
+            if (cacheData.erase(url) > 0)
+                save();
             return;
         }
-        
-        // Perform the delete operation
-        if (sourcePath.find('*') != std::string::npos) {
-            deleteFileOrDirectoryByPattern(sourcePath, logSource);
-        } else {
-            deleteFileOrDirectory(sourcePath, logSource);
-        }
+        auto& section = cacheData[url];
+        section["etag"] = etag;
+        section["last_modified"] = lastModified;
+        section["path"] = localPath;
+        section["stamp"] = stamp;
+        save();
+    }
+
+    // Drops the validators of url so its next download is unconditional
+    void forget(const std::string& url) {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ensureLoaded();
+        if (cacheData.erase(url) > 0)
+            save();
     }
-}
 
+private:
+    std::mutex cacheMutex;
+    tsl::hlp::ini::IniData cacheData;
+    bool loaded = false;
 
-void handleMirrorCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
-    // Early validation
-    if (cmd.size() < 2) {
-        #if USING_LOGGING_DIRECTIVE
-        if (!disableLogging)
-            logMessage("Mirror command requires at least a source path.");
-        #endif
-        return;
+    static std::string cachePath() {
+        return SETTINGS_PATH + "http_cache.ini";
     }
-    
-    // Extract and preprocess source path
-    std::string sourcePath = cmd[1];
-    preprocessPath(sourcePath, packagePath);
-    
-    // Extract destination path or use default
-    std::string destinationPath;
-    if (cmd.size() >= 3) {
-        destinationPath = cmd[2];
-        preprocessPath(destinationPath, packagePath);
-    } else {
-        destinationPath = ROOT_PATH;
+
+    void ensureLoaded() {
+        if (loaded)
+            return;
+        if (isFile(cachePath()))
+            cacheData = getParsedDataFromIniFile(cachePath());
+        loaded = true;
     }
-    
-    // Determine operation type using string_view to avoid string creation
-    const std::string_view commandName = cmd[0];
-    const std::string operation = (commandName == "mirror_copy" || commandName == "mirror_cp") ? "copy" : "delete";
-    
-    if (sourcePath.find('*') == std::string::npos) {
-        // Single directory mirror
-        mirrorFiles(sourcePath, destinationPath, operation);
-    } else {
-        // Wildcard mirror - get file list and process with immediate cleanup
-        auto fileList = getFilesListByWildcards(sourcePath);
-        
-        // Process files one by one, freeing memory as we go
-        for (size_t i = 0; i < fileList.size(); ++i) {
-            // Move the string to avoid copy
-            const auto sourceDirectory = std::move(fileList[i]);
-            fileList[i].shrink_to_fit();     // Free the capacity
-            mirrorFiles(sourceDirectory, destinationPath, operation);
-            
-            // Clear the vector element immediately to free memory
-            //fileList[i].clear();
-        }
+
+    void save() {
+        saveIniFileData(cachePath(), cacheData);
     }
+};
+
+static HttpValidatorCache httpValidatorCache;
+
+/**
+ * @brief Options shared by every HTTP transfer of the interpreter.
+ */
+static void configureTransfer(CURL* curl, const std::string& url) {
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, "Ultrahand");
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+    // Stalled transfers fail fast so a retry can pick them up
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 20L);
+    curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, static_cast<long>(DOWNLOAD_READ_BUFFER));
 }
 
-void handleMoveCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
-    // Declare only the strings we need
-    std::string sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath;
-    parseCommandArguments(cmd, packagePath, sourceListPath, destinationListPath, logSource, logDestination, sourcePath, destinationPath, copyFilterListPath, filterListPath);
-    
-    if (!sourceListPath.empty() && !destinationListPath.empty()) {
-        // Load filter sets (these are typically small)
-        std::unique_ptr<std::unordered_set<std::string>> copyFilterSet;
-        if (!copyFilterListPath.empty()) {
-            copyFilterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(copyFilterListPath));
+/**
+ * @brief Optional integrity checks for `download -sha256 <hex> -size <bytes>`.
+ */
+struct DownloadOptions {
+    std::string expectedSha256;
+    long long expectedSize = -1;
+};
+
+/**
+ * @brief One resumable HTTP download into "<destination>.part".
+ *
+ * Requests are conditional while httpValidatorCache holds an intact copy of the file. The
+ * partial file survives failed attempts together with a small "<destination>.part.meta"
+ * holding the URL and the server's ETag/Last-Modified. The next attempt asks for the
+ * remaining bytes with Range + If-Range, so a changed file is sent whole and restarts
+ * cleanly. The part is only renamed into place once it passes the optional size and
+ * SHA-256 checks. Setup and completion are split so one transfer can drive several
+ * downloads.
+ */
+class ResumableDownload {
+public:
+    ResumableDownload(const std::string& url, const std::string& destinationPath, const DownloadOptions& options = {})
+        : url(url), options(options), finalPath(resolveDestination(url, destinationPath)) {
+        partPath = finalPath + ".part";
+        metaPath = partPath + ".meta";
+    }
+
+    // File a download of url into destinationPath ends up in (directories take the URL's file name)
+    static std::string resolveDestination(const std::string& url, const std::string& destinationPath) {
+        std::string resolvedPath = destinationPath;
+        if (resolvedPath.empty() || resolvedPath.back() == '/') {
+            std::string fileName = url.substr(0, url.find_first_of("?#"));
+            fileName = fileName.substr(fileName.rfind('/') + 1);
+            resolvedPath += fileName.empty() ? "download" : fileName;
+        }
+        return resolvedPath;
+    }
+
+    const std::string& destination() const { return finalPath; }
+
+    // Set when the next attempt has to start over without validators: a 304 kept a file that
+    // failed verification, or the server answered a resume with a different range
+    bool needsRefetch() const { return refetchRequired; }
+
+    // When several downloads share downloadPercentage, the caller aggregates these instead
+    void setReportProgress(bool report) { reportProgress = report; }
+    long long transferredBytes() const { return progressDone; }
+    long long expectedBytes() const { return progressTotal; }
+
+    // Configures a (reset) easy handle for this download
+    void prepare(CURL* curl) {
+        resumeOffset = resumableOffset();
+        baseOffset = resumeOffset;
+        expectedTotal = -1;
+        progressDone = resumeOffset;
+        progressTotal = -1;
+        response = {};
+        writeFailed = false;
+
+        configureTransfer(curl, url);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, this);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progressCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, this);
+
+        if (requestHeaders) {
+            curl_slist_free_all(requestHeaders);
+            requestHeaders = nullptr;
+        }
+        if (resumeOffset > 0) {
+            const std::string range = ult::to_string(resumeOffset) + "-";
+            curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+            requestHeaders = curl_slist_append(requestHeaders, ("If-Range: " + ifRangeValidator).c_str());
+        } else {
+            curl_easy_setopt(curl, CURLOPT_RANGE, nullptr);
+            std::string etag, lastModified;
+            if (!refetchRequired && httpValidatorCache.lookup(url, finalPath, etag, lastModified)) {
+                if (!etag.empty())
+                    requestHeaders = curl_slist_append(requestHeaders, ("If-None-Match: " + etag).c_str());
+                if (!lastModified.empty())
+                    requestHeaders = curl_slist_append(requestHeaders, ("If-Modified-Since: " + lastModified).c_str());
+            }
         }
-        
-        std::unique_ptr<std::unordered_set<std::string>> filterSet;
-        if (!filterListPath.empty()) {
-            filterSet = std::make_unique<std::unordered_set<std::string>>(readSetFromFile(filterListPath));
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, requestHeaders);
+    }
+
+    // Finalizes the attempt; true once the verified file is in place
+    bool complete(CURL* curl, CURLcode result) {
+        long statusCode = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+        if (requestHeaders) {
+            curl_slist_free_all(requestHeaders);
+            requestHeaders = nullptr;
         }
-    
-        // Pre-allocate strings to avoid reallocations in loop
-        //sourcePath.reserve(1024);
-        //destinationPath.reserve(1024);
-    
-        // Stream process both files line by line
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* sourceFile = fopen(sourceListPath.c_str(), "r");
-        FILE* destFile = fopen(destinationListPath.c_str(), "r");
-        
-        if (!sourceFile || !destFile) {
-            if (sourceFile) fclose(sourceFile);
-            if (destFile) fclose(destFile);
+
+        // The cached copy is still current, provided it still passes -size/-sha256
+        if (result == CURLE_OK && statusCode == 304) {
+            if (verifyFile(finalPath, -1))
+                return true;
+            httpValidatorCache.forget(url);
+            refetchRequired = true;
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Failed to open source or destination list files");
+                logMessage("Cached copy of " + url + " failed verification, fetching it again.");
             #endif
-            return;
+            return false;
         }
-        
-        // Set larger buffers for better I/O performance
-        static constexpr size_t FILE_BUFFER_SIZE = 8192;
-        setvbuf(sourceFile, nullptr, _IOFBF, FILE_BUFFER_SIZE);
-        setvbuf(destFile, nullptr, _IOFBF, FILE_BUFFER_SIZE);
-        
-        static constexpr size_t BUFFER_SIZE = 8192;
-        char sourceBuffer[BUFFER_SIZE];
-        char destBuffer[BUFFER_SIZE];
-        
-        // Static string for repeated log messages to reduce allocations
-        #if USING_LOGGING_DIRECTIVE
-        static const std::string skipDirMsg = "Skipping non-empty directory: ";
-        #endif
-        
-        // Process files line by line simultaneously
-        while (fgets(sourceBuffer, BUFFER_SIZE, sourceFile) && 
-               fgets(destBuffer, BUFFER_SIZE, destFile)) {
-            
-            // Optimized newline removal - scan once instead of using strlen
-            char* srcEnd = sourceBuffer;
-            while (*srcEnd && *srcEnd != '\n') ++srcEnd;
-            const size_t sourceLen = srcEnd - sourceBuffer;
-            *srcEnd = '\0';
-            
-            char* destEnd = destBuffer;
-            while (*destEnd && *destEnd != '\n') ++destEnd;
-            const size_t destLen = destEnd - destBuffer;
-            *destEnd = '\0';
-            
-            // Clear and append to reuse existing string capacity
-            sourcePath.clear();
-            sourcePath.append(sourceBuffer, sourceLen);
-            
-            destinationPath.clear();
-            destinationPath.append(destBuffer, destLen);
-            
-            preprocessPath(sourcePath, packagePath);
-            preprocessPath(destinationPath, packagePath);
-            
-            // Cache filter lookup result
-            const bool shouldProcess = !filterSet || filterSet->find(sourcePath) == filterSet->end();
-            
-            if (shouldProcess) {
-                // Check if it's a directory using the buffer directly (avoid string access)
-                const bool isDirectory = sourceLen > 0 && sourcePath[sourceLen - 1] == '/';
-                
-                if (!isDirectory) {
-                    // Check copy filter once and cache result
-                    const bool shouldCopy = copyFilterSet && copyFilterSet->find(sourcePath) != copyFilterSet->end();
-                    
-                    if (shouldCopy) {
-                        const long long totalSize = getTotalSize(sourcePath);
-                        long long totalBytesCopied = 0;
-                        copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
-                    } else {
-                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
-                    }
-                } else {
-                    if (isDirectoryEmpty(sourcePath)) {
-                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
-                    }
-                    #if USING_LOGGING_DIRECTIVE
-                    else if (!disableLogging) {
-                        logMessage(skipDirMsg + sourcePath);
-                    }
-                    #endif
-                }
-            }
-            
-            // Periodically shrink strings if they've grown too large
-            // This prevents unbounded memory growth for very long paths
-            //if (sourcePath.capacity() > 8192) {
-            //    sourcePath.shrink_to_fit();
-            //}
-            //if (destinationPath.capacity() > 8192) {
-            //    destinationPath.shrink_to_fit();
-            //}
+
+        // An empty body never reaches the write callback
+        if (result == CURLE_OK && !outputFile && !writeFailed && !openOutput())
+            writeFailed = true;
+        const bool fileClosed = !outputFile || fclose(outputFile) == 0;
+        outputFile = nullptr;
+
+        if (result != CURLE_OK || !fileClosed || writeFailed) {
+            // The part no longer lines up with the server copy
+            if (statusCode == 416)
+                discardPart();
+
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Download of " + url + " interrupted (" + curl_easy_strerror(result) + ", HTTP " + ult::to_string(statusCode) + ").");
+            #endif
+            return false;
         }
-        
-        fclose(sourceFile);
-        fclose(destFile);
-        
-    #else
-        std::ifstream sourceFile(sourceListPath);
-        std::ifstream destFile(destinationListPath);
-        
-        if (!sourceFile.is_open() || !destFile.is_open()) {
+
+        if (!verifyFile(partPath, expectedTotal)) {
+            discardPart();
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Failed to open source or destination list files");
+                logMessage("Downloaded file failed verification: " + finalPath);
             #endif
+            return false;
+        }
+
+        remove(finalPath.c_str());
+        if (rename(partPath.c_str(), finalPath.c_str()) != 0)
+            return false;
+        remove(metaPath.c_str());
+        httpValidatorCache.store(url, finalPath, response.etag, response.lastModified);
+        return true;
+    }
+
+    ~ResumableDownload() {
+        if (outputFile)
+            fclose(outputFile);
+        if (requestHeaders)
+            curl_slist_free_all(requestHeaders);
+    }
+
+private:
+    struct ResponseState {
+        long statusCode = 0;
+        long long rangeStart = -1;
+        long long contentLength = -1;
+        std::string etag;
+        std::string lastModified;
+    };
+
+    std::string url;
+    DownloadOptions options;
+    std::string finalPath, partPath, metaPath;
+    std::string ifRangeValidator;
+    long long resumeOffset = 0;
+    long long baseOffset = 0;       // bytes already on disk for the running transfer
+    long long expectedTotal = -1;
+    ResponseState response;
+    FILE* outputFile = nullptr;
+    curl_slist* requestHeaders = nullptr;
+    bool writeFailed = false;
+    bool refetchRequired = false;
+    bool reportProgress = true;
+    long long progressDone = 0;
+    long long progressTotal = -1;
+
+    static long long fileSize(const std::string& path) {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0 ? static_cast<long long>(st.st_size) : -1;
+    }
+
+    void discardPart() {
+        remove(partPath.c_str());
+        remove(metaPath.c_str());
+    }
+
+    // Offset to resume from, or 0 when the part cannot be validated against the server
+    long long resumableOffset() {
+        ifRangeValidator.clear();
+        const long long partSize = fileSize(partPath);
+        if (partSize <= 0)
+            return 0;
+
+        FILE* metaFile = fopen(metaPath.c_str(), "r");
+        if (!metaFile) {
+            discardPart();
+            return 0;
+        }
+        std::string storedUrl, etag, lastModified;
+        char line[1024];
+        while (fgets(line, sizeof(line), metaFile)) {
+            std::string entry(line);
+            while (!entry.empty() && (entry.back() == '\n' || entry.back() == '\r'))
+                entry.pop_back();
+            if (entry.compare(0, 4, "url=") == 0) storedUrl = entry.substr(4);
+            else if (entry.compare(0, 5, "etag=") == 0) etag = entry.substr(5);
+            else if (entry.compare(0, 14, "last_modified=") == 0) lastModified = entry.substr(14);
+        }
+        fclose(metaFile);
+
+        // If-Range only accepts strong entity tags
+        if (!etag.empty() && etag.compare(0, 2, "W/") != 0)
+            ifRangeValidator = etag;
+        else
+            ifRangeValidator = lastModified;
+
+        if (storedUrl != url || ifRangeValidator.empty()) {
+            discardPart();
+            return 0;
+        }
+        return partSize;
+    }
+
+    void writeMeta() {
+        if (response.etag.empty() && response.lastModified.empty()) {
+            remove(metaPath.c_str());
             return;
         }
-        
-        // Set larger buffers for better I/O performance
-        char sourceFileBuffer[8192], destFileBuffer[8192];
-        sourceFile.rdbuf()->pubsetbuf(sourceFileBuffer, sizeof(sourceFileBuffer));
-        destFile.rdbuf()->pubsetbuf(destFileBuffer, sizeof(destFileBuffer));
-        
-        // Process files line by line simultaneously
-        while (std::getline(sourceFile, sourcePath) && std::getline(destFile, destinationPath)) {
-            preprocessPath(sourcePath, packagePath);
-            preprocessPath(destinationPath, packagePath);
-            
-            // Cache filter lookup result  
-            const bool shouldProcess = !filterSet || filterSet->find(sourcePath) == filterSet->end();
-            
-            if (shouldProcess) {
-                // Check if it's a directory (ends with /)
-                const bool isDirectory = !sourcePath.empty() && sourcePath.back() == '/';
-                
-                if (!isDirectory) {
-                    // Check copy filter once and cache result
-                    const bool shouldCopy = copyFilterSet && copyFilterSet->find(sourcePath) != copyFilterSet->end();
-                    
-                    if (shouldCopy) {
-                        const long long totalSize = getTotalSize(sourcePath);
-                        long long totalBytesCopied = 0;
-                        copyFileOrDirectory(sourcePath, destinationPath, &totalBytesCopied, totalSize);
-                    } else {
-                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
-                    }
-                } else {
-                    if (isDirectoryEmpty(sourcePath)) {
-                        moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
-                    }
-                    #if USING_LOGGING_DIRECTIVE
-                    else if (!disableLogging) {
-                        logMessage("Skipping non-empty directory: " + sourcePath);
-                    }
-                    #endif
-                }
+        FILE* metaFile = fopen(metaPath.c_str(), "w");
+        if (!metaFile)
+            return;
+        fprintf(metaFile, "url=%s\netag=%s\nlast_modified=%s\n", url.c_str(), response.etag.c_str(), response.lastModified.c_str());
+        fclose(metaFile);
+    }
+
+    // Opens the part for the response that is about to deliver a body
+    bool openOutput() {
+        if (response.statusCode == 206 && response.rangeStart != resumeOffset) {
+            // The part cannot be continued from here; drop it so the retry starts at 0
+            discardPart();
+            refetchRequired = true;
+            return false;
+        } else if (response.statusCode == 206) {
+            outputFile = fopen(partPath.c_str(), "ab");
+            baseOffset = resumeOffset;
+        } else if (response.statusCode == 200) {
+            createDirectory(finalPath.substr(0, finalPath.rfind('/') + 1));
+            outputFile = fopen(partPath.c_str(), "wb");
+            baseOffset = 0;
+            writeMeta();
+        } else {
+            return false;
+        }
+        if (!outputFile)
+            return false;
+
+        setvbuf(outputFile, nullptr, _IOFBF, DOWNLOAD_WRITE_BUFFER);
+        expectedTotal = response.contentLength >= 0 ? baseOffset + response.contentLength : -1;
+        return true;
+    }
+
+    // Checks path against the transfer length (when known) and the -size/-sha256 options
+    bool verifyFile(const std::string& path, long long expectedLength) const {
+        const long long partSize = fileSize(path);
+        if (partSize < 0 ||
+            (expectedLength >= 0 && partSize != expectedLength) ||
+            (options.expectedSize >= 0 && partSize != options.expectedSize))
+            return false;
+        if (options.expectedSha256.empty())
+            return true;
+
+        FILE* partFile = fopen(path.c_str(), "rb");
+        if (!partFile)
+            return false;
+        Sha256Context context;
+        sha256ContextCreate(&context);
+        std::vector<u8> buffer(DOWNLOAD_WRITE_BUFFER);
+        size_t bytesRead;
+        while ((bytesRead = fread(buffer.data(), 1, buffer.size(), partFile)) > 0)
+            sha256ContextUpdate(&context, buffer.data(), bytesRead);
+        fclose(partFile);
+
+        u8 digest[SHA256_HASH_SIZE];
+        sha256ContextGetHash(&context, digest);
+        static constexpr char hexDigits[] = "0123456789abcdef";
+        std::string digestHex;
+        digestHex.reserve(SHA256_HASH_SIZE * 2);
+        for (const u8 byte : digest) {
+            digestHex += hexDigits[byte >> 4];
+            digestHex += hexDigits[byte & 0x0F];
+        }
+        return digestHex == stringToLowercase(options.expectedSha256);
+    }
+
+    static size_t headerCallback(char* data, size_t size, size_t count, void* userData) {
+        auto* self = static_cast<ResumableDownload*>(userData);
+        const size_t length = size * count;
+        std::string line(data, length);
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+
+        // A new status line starts a fresh response (redirects, 100-continue)
+        if (line.compare(0, 5, "HTTP/") == 0) {
+            self->response = {};
+            const size_t space = line.find(' ');
+            if (space != std::string::npos)
+                self->response.statusCode = std::strtol(line.c_str() + space + 1, nullptr, 10);
+            return length;
+        }
+
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            return length;
+        const std::string name = stringToLowercase(line.substr(0, colon));
+        std::string value = line.substr(colon + 1);
+        trim(value);
+
+        if (name == "etag") {
+            self->response.etag = value;
+        } else if (name == "last-modified") {
+            self->response.lastModified = value;
+        } else if (name == "content-length") {
+            self->response.contentLength = std::strtoll(value.c_str(), nullptr, 10);
+        } else if (name == "content-range" && value.compare(0, 6, "bytes ") == 0) {
+            self->response.rangeStart = std::strtoll(value.c_str() + 6, nullptr, 10);
+        }
+        return length;
+    }
+
+    static size_t writeCallback(char* data, size_t size, size_t count, void* userData) {
+        auto* self = static_cast<ResumableDownload*>(userData);
+        const size_t length = size * count;
+        if (!self->outputFile && !self->openOutput()) {
+            self->writeFailed = true;
+            return 0;
+        }
+        if (fwrite(data, 1, length, self->outputFile) != length) {
+            self->writeFailed = true;
+            return 0;
+        }
+        return length;
+    }
+
+    static int progressCallback(void* userData, curl_off_t downloadTotal, curl_off_t downloadNow, curl_off_t, curl_off_t) {
+        auto* self = static_cast<ResumableDownload*>(userData);
+        if (abortDownload.load(std::memory_order_acquire))
+            return 1;
+        if (downloadTotal > 0) {
+            self->progressTotal = self->baseOffset + downloadTotal;
+            self->progressDone = self->baseOffset + downloadNow;
+            if (self->reportProgress)
+                downloadPercentage.store(static_cast<int>(std::min(99LL, self->progressDone * 100 / self->progressTotal)), std::memory_order_release);
+        }
+        return 0;
+    }
+};
+
+/**
+ * @brief Downloads a file, resuming any earlier partial attempt (see ResumableDownload).
+ *
+ * With noPercentagePolling set, downloadPercentage is left untouched (as for the library's
+ * downloadFile), e.g. for the updater payload fetched while a reboot is pending.
+ */
+bool downloadFileResumable(const std::string& url, const std::string& destinationPath, const DownloadOptions& options = {}, bool noPercentagePolling = false) {
+    CURL* curl = networkSession.takeHandle(url);
+    if (!curl)
+        return false;
+
+    ResumableDownload download(url, destinationPath, options);
+    download.setReportProgress(!noPercentagePolling);
+    if (!noPercentagePolling)
+        downloadPercentage.store(0, std::memory_order_release);
+    download.prepare(curl);
+    bool success = download.complete(curl, curl_easy_perform(curl));
+    networkSession.returnHandle(url, curl);
+
+    // A 304 kept a copy that no longer verifies, or the resume was answered with another
+    // range; ask again from the start without validators
+    if (!success && download.needsRefetch() && (curl = networkSession.takeHandle(url))) {
+        download.prepare(curl);
+        success = download.complete(curl, curl_easy_perform(curl));
+        networkSession.returnHandle(url, curl);
+    }
+
+    if (!noPercentagePolling)
+        downloadPercentage.store(success ? 100 : -1, std::memory_order_release);
+    return success;
+}
+
+/**
+ * @brief Runs consecutive download commands with distinct destinations concurrently.
+ *
+ * Starting at commands[first], gathers the following download commands (later ones must be
+ * free of placeholders) and drives them through one curl multi handle. The number of
+ * simultaneous transfers follows a memory budget from the buffer sizes and heap tier.
+ * Failed transfers are retried up to three times, resuming from their partial files.
+ * Progress is aggregated over all transfers into downloadPercentage.
+ *
+ * @return The number of commands handled, or 0 to run them one by one.
+ */
+size_t handleParallelDownloads(std::vector<std::vector<std::string>>& commands, size_t first, const std::string& packagePath) {
+    static constexpr size_t MAX_PARALLEL_DOWNLOADS = 4;
+    static constexpr size_t MAX_ATTEMPTS = 3;
+    static constexpr size_t TLS_OVERHEAD = 64 * 1024;
+
+    if (ult::limitedMemory)
+        return 0;
+
+    const size_t memoryBudget = ult::expandedMemory ? 4 * 1024 * 1024 : 1024 * 1024;
+    const size_t transferCost = DOWNLOAD_READ_BUFFER + DOWNLOAD_WRITE_BUFFER + TLS_OVERHEAD;
+    const size_t concurrency = std::min(MAX_PARALLEL_DOWNLOADS, memoryBudget / std::max<size_t>(transferCost, 1));
+    if (concurrency < 2)
+        return 0;
+
+    struct Transfer {
+        std::string url;
+        std::unique_ptr<ResumableDownload> download;
+        CURL* curl = nullptr;
+        size_t attempts = 0;
+        bool succeeded = false;
+    };
+    std::vector<Transfer> transfers;
+    std::unordered_set<std::string> destinations;
+
+    for (size_t next = first; next < commands.size(); ++next) {
+        const auto& cmd = commands[next];
+        if (cmd.size() < 3 || cmd[0] != "download")
+            break;
+        if (next != first && std::any_of(cmd.begin(), cmd.end(), [](const std::string& arg) { return arg.find('{') != std::string::npos; }))
+            break;
+
+        Transfer transfer;
+        transfer.url = cmd[1];
+        preprocessUrl(transfer.url);
+        std::string destinationPath = cmd[2];
+        preprocessPath(destinationPath, packagePath);
+        DownloadOptions downloadOptions;
+        for (size_t i = 3; i + 1 < cmd.size(); ++i) {
+            if (cmd[i] == "-sha256") {
+                downloadOptions.expectedSha256 = getUnquoted(cmd, ++i);
+            } else if (cmd[i] == "-size") {
+                downloadOptions.expectedSize = std::strtoll(getUnquoted(cmd, ++i).c_str(), nullptr, 10);
+            }
+        }
+        transfer.download = std::make_unique<ResumableDownload>(transfer.url, destinationPath, downloadOptions);
+        if (!destinations.insert(transfer.download->destination()).second)
+            break;
+        transfer.download->setReportProgress(false);
+        transfers.push_back(std::move(transfer));
+    }
+
+    if (transfers.size() < 2)
+        return 0;
+
+    CURLM* multi = curl_multi_init();
+    if (!multi)
+        return 0;
+    if (!networkSession.acquire()) {
+        curl_multi_cleanup(multi);
+        return 0;
+    }
+
+    #if USING_LOGGING_DIRECTIVE
+    if (!disableLogging) {
+        // The first command was already logged by the interpreter loop
+        std::string messageBuffer;
+        for (size_t index = first + 1; index < first + transfers.size(); ++index)
+            logExecutingCommand(commands[index], messageBuffer);
+        logMessage("Downloading " + ult::to_string(transfers.size()) + " files, " + ult::to_string(concurrency) + " at a time.");
+    }
+    #endif
+
+    auto startTransfer = [&](Transfer& transfer) {
+        if (!transfer.curl && !(transfer.curl = networkSession.takeHandle(transfer.url)))
+            return false;
+        ++transfer.attempts;
+        transfer.download->prepare(transfer.curl);
+        curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+        if (curl_multi_add_handle(multi, transfer.curl) == CURLM_OK)
+            return true;
+        networkSession.returnHandle(transfer.url, transfer.curl);
+        transfer.curl = nullptr;
+        return false;
+    };
+
+    downloadPercentage.store(0, std::memory_order_release);
+    size_t nextTransfer = 0;
+    size_t activeTransfers = 0;
+    int runningHandles = 0;
+
+    while (true) {
+        while (activeTransfers < concurrency && nextTransfer < transfers.size()) {
+            if (startTransfer(transfers[nextTransfer]))
+                ++activeTransfers;
+            ++nextTransfer;
+        }
+        if (activeTransfers == 0)
+            break;
+
+        curl_multi_perform(multi, &runningHandles);
+
+        int queuedMessages = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &queuedMessages)) {
+            if (message->msg != CURLMSG_DONE)
+                continue;
+            Transfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&transfer));
+            const CURLcode result = message->data.result;
+            curl_multi_remove_handle(multi, transfer->curl);
+            --activeTransfers;
+
+            transfer->succeeded = transfer->download->complete(transfer->curl, result);
+            const bool aborted = abortDownload.load(std::memory_order_acquire);
+            if (!transfer->succeeded && !aborted && transfer->attempts < MAX_ATTEMPTS && startTransfer(*transfer)) {
+                ++activeTransfers;
+                continue;
+            }
+            networkSession.returnHandle(transfer->url, transfer->curl);
+            transfer->curl = nullptr;
+        }
+
+        long long done = 0, total = 0;
+        for (const auto& transfer : transfers) {
+            if (transfer.download->expectedBytes() > 0) {
+                done += transfer.download->transferredBytes();
+                total += transfer.download->expectedBytes();
             }
         }
-    #endif
-    
-        
-    } else {
-        // Single file/directory moving - early returns for error conditions
-        if (sourcePath.empty() || destinationPath.empty()) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Source and destination paths must be specified.");
-            #endif
-            return;
+        if (total > 0)
+            downloadPercentage.store(static_cast<int>(std::min(99LL, done * 100 / total)), std::memory_order_release);
+
+        if (activeTransfers > 0)
+            curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+    }
+
+    curl_multi_cleanup(multi);
+    networkSession.release();
+
+    bool allSucceeded = !abortDownload.load(std::memory_order_acquire);
+    for (const auto& transfer : transfers) {
+        allSucceeded = allSucceeded && transfer.succeeded;
+        hexOffsetIndex.invalidateUnder(transfer.download->destination());
+        if (activeBatchCache)
+            activeBatchCache->invalidate(transfer.download->destination());
+    }
+    downloadPercentage.store(allSucceeded ? 100 : -1, std::memory_order_release);
+    commandSuccess.store(
+        allSucceeded &&
+        commandSuccess.load(std::memory_order_acquire),
+        std::memory_order_release
+    );
+
+    for (size_t index = first; index < first + transfers.size(); ++index)
+        commands[index] = {};
+    return transfers.size();
+}
+
+/**
+ * @brief Entry selection for `unzip -include/-exclude/-strip`.
+ *
+ * Patterns are comma-separated fnmatch globs matched against the archive path of each
+ * entry. Stripping removes leading path components before the entry is written.
+ */
+struct UnzipFilter {
+    std::vector<std::string> includePatterns;
+    std::vector<std::string> excludePatterns;
+    size_t stripComponents = 0;
+
+    bool empty() const {
+        return includePatterns.empty() && excludePatterns.empty() && stripComponents == 0;
+    }
+
+    // Consumes a -include/-exclude/-strip option at cmd[i]; false if cmd[i] is not one
+    bool parseArgument(const std::vector<std::string>& cmd, size_t& i) {
+        if (i + 1 >= cmd.size())
+            return false;
+        if (cmd[i] == "-include") {
+            appendPatterns(includePatterns, getUnquoted(cmd, ++i));
+        } else if (cmd[i] == "-exclude") {
+            appendPatterns(excludePatterns, getUnquoted(cmd, ++i));
+        } else if (cmd[i] == "-strip") {
+            stripComponents = std::max(0, ult::stoi(getUnquoted(cmd, ++i)));
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // Returns false when the entry should be skipped; otherwise rewrites name to its output path
+    bool apply(std::string& name) const {
+        auto matchesAny = [&name](const std::vector<std::string>& patterns) {
+            for (const auto& pattern : patterns) {
+                if (fnmatch(pattern.c_str(), name.c_str(), 0) == 0)
+                    return true;
+            }
+            return false;
+        };
+
+        if (!includePatterns.empty() && !matchesAny(includePatterns))
+            return false;
+        if (matchesAny(excludePatterns))
+            return false;
+
+        for (size_t i = 0; i < stripComponents; ++i) {
+            const size_t slash = name.find('/');
+            if (slash == std::string::npos)
+                return false;
+            name.erase(0, slash + 1);
         }
-        
-        if (isDangerousCombination(sourcePath)) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Dangerous combination detected.");
-            #endif
-            return;
+
+        // Never write outside the destination
+        return !name.empty() && name[0] != '/' && !hasParentComponent(name);
+    }
+
+private:
+    static bool hasParentComponent(const std::string& name) {
+        size_t start = 0;
+        while (start <= name.size()) {
+            size_t end = name.find('/', start);
+            if (end == std::string::npos)
+                end = name.size();
+            if (name.compare(start, end - start, "..") == 0)
+                return true;
+            start = end + 1;
         }
-        
-        // Perform the move operation
-        if (sourcePath.find('*') != std::string::npos) {
-            moveFilesOrDirectoriesByPattern(sourcePath, destinationPath, logSource, logDestination);
-        } else {
-            moveFileOrDirectory(sourcePath, destinationPath, logSource, logDestination);
+        return false;
+    }
+
+    static void appendPatterns(std::vector<std::string>& patterns, const std::string& list) {
+        for (auto& pattern : splitString(list, ",")) {
+            trim(pattern);
+            if (!pattern.empty())
+                patterns.push_back(std::move(pattern));
         }
     }
+};
+
+/**
+ * @brief Output path for an extracted file, redirected to "<path>.ultra" for PROTECTED_FILES.
+ *
+ * Files that are in use by the running system are staged next to the original and installed
+ * by the updater payload on the next reboot (see the reboot command).
+ */
+inline std::string protectedOutputPath(const std::string& outputPath) {
+    for (const std::string& file : PROTECTED_FILES) {
+        if (outputPath == file)
+            return outputPath + ".ultra";
+    }
+    return outputPath;
 }
 
-void handleIniCommands(const std::vector<std::string>& cmd, const std::string& packagePath) {
-    const std::string& command = cmd[0];
-    const size_t cmdSize = cmd.size();
-    
-    // All commands need at least sourcePath and section
-    if (cmdSize < 3)
-        return;
-    
-    std::string sourcePath = cmd[1];
-    preprocessPath(sourcePath, packagePath);
-    std::string desiredSection = cmd[2];
-    removeQuotes(desiredSection);
-    
-    if (command == "add-ini-section") {
-        addIniSection(sourcePath, desiredSection);
-        
-    } else if (command == "rename-ini-section" && cmdSize >= 4) {
-        std::string desiredNewSection = cmd[3];
-        removeQuotes(desiredNewSection);
-        renameIniSection(sourcePath, desiredSection, desiredNewSection);
-        
-    } else if (command == "remove-ini-section") {
-        removeIniSection(sourcePath, desiredSection);
-        
-    } else if (command == "remove-ini-key" && cmdSize >= 4) {
-        std::string desiredKey = cmd[3];
-        removeQuotes(desiredKey);
-        removeIniKey(sourcePath, desiredSection, desiredKey);
-        
-    } else if ((command == "set-ini-val" || command == "set-ini-value") && cmdSize >= 5) {
-        std::string desiredKey = cmd[3];
-        removeQuotes(desiredKey);
-        
-        std::string desiredValue;
-        for (size_t i = 4; i < cmdSize; ++i) {
-            if (i > 4)
-                desiredValue += ' ';
-            desiredValue += cmd[i];
+/**
+ * @brief Writer stage for zip extraction.
+ *
+ * The inflating thread fills chunks from a small fixed ring and submits them; a second
+ * thread writes them out, so inflate and SD writes overlap. A chunk carrying a path opens
+ * a new output file, and the close flags finish (or discard) the current one. A file opened
+ * with a final path is renamed there only after it closed cleanly, so a failed entry never
+ * replaces an existing file. When the writer thread cannot be created, chunks are written inline.
+ */
+class UnzipWritePipeline {
+public:
+    struct Chunk {
+        std::vector<char> data;
+        size_t size = 0;
+        std::string openPath;   // non-empty: open this file before writing
+        std::string finalPath;  // non-empty: move the opened file here once it is complete
+        bool closeFile = false;
+        bool discardFile = false;
+    };
+
+    UnzipWritePipeline(size_t chunkSize, u64 expectedBytes) : chunks(CHUNK_COUNT), totalBytes(expectedBytes) {
+        for (auto& chunk : chunks) {
+            chunk.data.resize(chunkSize);
+            freeChunks.push(&chunk);
+        }
+        threaded = threadCreate(&writerThread, writerEntry, this, nullptr, WRITER_STACK_SIZE, 0x2C, -2) == 0;
+        if (threaded)
+            threadStart(&writerThread);
+    }
+
+    ~UnzipWritePipeline() {
+        finish();
+    }
+
+    // Returns nullptr once the writer has failed
+    Chunk* acquire() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueCondition.wait(lock, [this] { return !freeChunks.empty() || failed; });
+        if (failed)
+            return nullptr;
+        Chunk* chunk = freeChunks.front();
+        freeChunks.pop();
+        chunk->size = 0;
+        chunk->openPath.clear();
+        chunk->finalPath.clear();
+        chunk->closeFile = chunk->discardFile = false;
+        return chunk;
+    }
+
+    void submit(Chunk* chunk) {
+        if (!threaded) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (!write(*chunk))
+                failed = true;
+            freeChunks.push(chunk);
+            return;
         }
-        removeQuotes(desiredValue);
-        
-        setIniFileValue(sourcePath, desiredSection, desiredKey, desiredValue);
-        
-    } else if (command == "set-ini-key" && cmdSize >= 5) {
-        std::string desiredKey = cmd[3];
-        removeQuotes(desiredKey);
-        
-        std::string desiredNewKey;
-        for (size_t i = 4; i < cmdSize; ++i) {
-            if (i > 4)
-                desiredNewKey += ' ';
-            desiredNewKey += cmd[i];
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            pendingChunks.push(chunk);
         }
-        removeQuotes(desiredNewKey);
-        
-        setIniFileKey(sourcePath, desiredSection, desiredKey, desiredNewKey);
+        queueCondition.notify_all();
     }
-}
 
-void handleJsonCommands(const std::vector<std::string>& cmd, const std::string& packagePath) {
-    const std::string& command = cmd[0];
-    const size_t cmdSize = cmd.size();
-    
-    if (cmdSize < 4)
-        return;
-    
-    std::string sourcePath = cmd[1];
-    preprocessPath(sourcePath, packagePath);
-    
-    std::string key = cmd[2];
-    removeQuotes(key);
-    
-    std::string value;
-    for (size_t i = 3; i < cmdSize; ++i) {
-        if (i > 3)
-            value += ' ';
-        value += cmd[i];
+    // Drains pending chunks and stops the writer; returns false if any write failed
+    bool finish() {
+        if (threaded) {
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                stopping = true;
+            }
+            queueCondition.notify_all();
+            threadWaitForExit(&writerThread);
+            threadClose(&writerThread);
+            threaded = false;
+        }
+        if (outputFile) {
+            fclose(outputFile);
+            deleteFileOrDirectory(outputPath);
+            outputFile = nullptr;
+            failed = true;
+        }
+        return !failed;
+    }
+
+private:
+    static constexpr size_t CHUNK_COUNT = 3;
+    static constexpr size_t WRITER_STACK_SIZE = 0x4000;
+
+    std::vector<Chunk> chunks;
+    std::queue<Chunk*> freeChunks;
+    std::queue<Chunk*> pendingChunks;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    Thread writerThread;
+    bool threaded = false;
+    bool stopping = false;
+    bool failed = false;
+
+    FILE* outputFile = nullptr;
+    std::string outputPath;
+    std::string outputFinalPath;
+    u64 totalBytes;
+    u64 writtenBytes = 0;
+
+    static void writerEntry(void* arg) {
+        static_cast<UnzipWritePipeline*>(arg)->writerLoop();
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        while (true) {
+            queueCondition.wait(lock, [this] { return !pendingChunks.empty() || stopping; });
+            if (pendingChunks.empty())
+                break;
+            Chunk* chunk = pendingChunks.front();
+            pendingChunks.pop();
+
+            lock.unlock();
+            const bool chunkWritten = write(*chunk);
+            lock.lock();
+
+            if (!chunkWritten)
+                failed = true;
+            freeChunks.push(chunk);
+            queueCondition.notify_all();
+        }
     }
-    removeQuotes(value);
-    
-    if (command == "set-json-key") {
-        ult::renameJsonKey(sourcePath, key, value);
-    } else if (command == "set-json-val" || command == "set-json-value") {
-        ult::setJsonValue(sourcePath, key, value, true);
+
+    // Runs on the writer thread (or inline); only the writer touches the output file
+    bool write(const Chunk& chunk) {
+        if (!chunk.openPath.empty()) {
+            outputPath = chunk.openPath;
+            outputFinalPath = chunk.finalPath;
+            outputFile = fopen(outputPath.c_str(), "wb");
+            if (outputFile)
+                setvbuf(outputFile, nullptr, _IOFBF, UNZIP_WRITE_BUFFER);
+        }
+        if (!outputFile)
+            return chunk.openPath.empty() && chunk.size == 0;
+
+        bool success = chunk.size == 0 || fwrite(chunk.data.data(), 1, chunk.size, outputFile) == chunk.size;
+        if (success && totalBytes > 0) {
+            writtenBytes += chunk.size;
+            unzipPercentage.store(static_cast<int>(std::min<u64>(99, writtenBytes * 100 / totalBytes)), std::memory_order_release);
+        }
+
+        if (chunk.closeFile || chunk.discardFile || !success) {
+            success = (fclose(outputFile) == 0) && success;
+            outputFile = nullptr;
+            if (!chunk.discardFile && success && !outputFinalPath.empty()) {
+                remove(outputFinalPath.c_str());
+                success = rename(outputPath.c_str(), outputFinalPath.c_str()) == 0;
+            }
+            if (chunk.discardFile || !success)
+                deleteFileOrDirectory(outputPath);
+        }
+        return success;
     }
-}
+};
 
-void handleHexEdit(const std::string& sourcePath, const std::string& secondArg, const std::string& thirdArg, const std::string& fourthArg, const std::string& fifthArg, const std::string& commandName, const std::vector<std::string>& cmd) {
-    
-    if (commandName == "hex-by-offset") {
-        hexEditByOffset(sourcePath, secondArg, thirdArg);
-        return;
+/**
+ * @brief Extracts a zip archive, optionally limited to the entries selected by a filter.
+ *
+ * Entries are chosen from the central directory before anything is inflated, so skipped
+ * entries are never decompressed or written. Inflating runs on the calling thread while
+ * an UnzipWritePipeline writes the output. Progress, abort and the `.ultra` staging of
+ * PROTECTED_FILES follow `unzipFile`.
+ */
+bool extractZipArchive(const std::string& zipFilePath, std::string destinationPath, const UnzipFilter& filter = {}) {
+    unzFile zipFile = unzOpen64(zipFilePath.c_str());
+    if (!zipFile) {
+        #if USING_LOGGING_DIRECTIVE
+        if (!disableLogging)
+            logMessage("Failed to open zip file: " + zipFilePath);
+        #endif
+        return false;
     }
-    
-    std::string hexDataToReplace;
-    std::string hexDataReplacement;
-    size_t occurrenceArgIndex = 0;
-    
-    if (commandName == "hex-by-swap") {
-        hexDataToReplace = secondArg;
-        hexDataReplacement = thirdArg;
-        occurrenceArgIndex = 4;
-        
-    } else if (commandName == "hex-by-string") {
-        hexDataToReplace = asciiToHex(secondArg);
-        hexDataReplacement = asciiToHex(thirdArg);
-        
-        // Pad to same length
-        const size_t lenDiff = (hexDataToReplace.length() > hexDataReplacement.length()) 
-            ? hexDataToReplace.length() - hexDataReplacement.length()
-            : hexDataReplacement.length() - hexDataToReplace.length();
-        
-        if (hexDataReplacement.length() < hexDataToReplace.length()) {
-            hexDataReplacement.append(lenDiff, '\0');
-        } else if (hexDataToReplace.length() < hexDataReplacement.length()) {
-            hexDataToReplace.append(lenDiff, '\0');
+
+    if (!destinationPath.empty() && destinationPath.back() != '/')
+        destinationPath += '/';
+
+    struct SelectedEntry {
+        unz64_file_pos position;
+        std::string outputName;
+    };
+    std::vector<SelectedEntry> selectedEntries;
+    u64 totalBytes = 0;
+
+    unz_file_info64 fileInfo;
+    char nameBuffer[512];
+    for (int status = unzGoToFirstFile(zipFile); status == UNZ_OK; status = unzGoToNextFile(zipFile)) {
+        if (unzGetCurrentFileInfo64(zipFile, &fileInfo, nameBuffer, sizeof(nameBuffer), nullptr, 0, nullptr, 0) != UNZ_OK)
+            continue;
+        if (fileInfo.size_filename >= sizeof(nameBuffer)) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Skipping zip entry with an overlong name: " + std::string(nameBuffer));
+            #endif
+            continue;
         }
-        occurrenceArgIndex = 4;
-        
-    } else if (commandName == "hex-by-decimal") {
-        if (fourthArg.empty()) {
-            hexDataToReplace = decimalToHex(secondArg);
-            hexDataReplacement = decimalToHex(thirdArg);
-        } else {
-            if (!isValidNumber(fourthArg))
-                return;
-            const size_t byteSize = ult::stoi(fourthArg);
-            hexDataToReplace = decimalToHex(secondArg, byteSize);
-            hexDataReplacement = decimalToHex(thirdArg, byteSize);
+
+        std::string outputName = nameBuffer;
+        if (!filter.apply(outputName))
+            continue;
+
+        SelectedEntry entry;
+        if (unzGetFilePos64(zipFile, &entry.position) != UNZ_OK)
+            continue;
+        if (outputName.back() != '/')
+            totalBytes += fileInfo.uncompressed_size;
+        entry.outputName = std::move(outputName);
+        selectedEntries.push_back(std::move(entry));
+    }
+
+    #if USING_LOGGING_DIRECTIVE
+    if (!disableLogging)
+        logMessage("Extracting " + std::to_string(selectedEntries.size()) + " entries from " + zipFilePath);
+    #endif
+
+    unzipPercentage.store(0, std::memory_order_release);
+    createDirectory(destinationPath);
+
+    bool success = true;
+    {
+        UnzipWritePipeline pipeline(UNZIP_READ_BUFFER, totalBytes);
+
+        for (const auto& entry : selectedEntries) {
+            if (abortUnzip.load(std::memory_order_acquire)) {
+                success = false;
+                break;
+            }
+
+            const std::string outputPath = protectedOutputPath(destinationPath + entry.outputName);
+            if (outputPath.back() == '/') {
+                createDirectory(outputPath);
+                continue;
+            }
+            createDirectory(outputPath.substr(0, outputPath.rfind('/') + 1));
+
+            if (unzGoToFilePos64(zipFile, &entry.position) != UNZ_OK || unzOpenCurrentFile(zipFile) != UNZ_OK) {
+                success = false;
+                break;
+            }
+
+            UnzipWritePipeline::Chunk* chunk = pipeline.acquire();
+            if (!chunk) {
+                unzCloseCurrentFile(zipFile);
+                success = false;
+                break;
+            }
+            chunk->openPath = outputPath;
+
+            // Fill whole chunks so the writer issues few, large writes
+            int bytesRead = 0;
+            while (true) {
+                bytesRead = unzReadCurrentFile(zipFile, chunk->data.data() + chunk->size,
+                    static_cast<unsigned>(chunk->data.size() - chunk->size));
+                if (bytesRead <= 0 || abortUnzip.load(std::memory_order_acquire))
+                    break;
+                chunk->size += bytesRead;
+                if (chunk->size == chunk->data.size()) {
+                    pipeline.submit(chunk);
+                    if (!(chunk = pipeline.acquire()))
+                        break;
+                }
+            }
+
+            // unzCloseCurrentFile reports CRC mismatches of fully read entries
+            const bool entryComplete = chunk && bytesRead == 0 && unzCloseCurrentFile(zipFile) == UNZ_OK;
+            if (!entryComplete && bytesRead != 0)
+                unzCloseCurrentFile(zipFile);
+            if (!chunk) {
+                success = false;
+                break;
+            }
+            chunk->closeFile = true;
+            chunk->discardFile = !entryComplete;
+            pipeline.submit(chunk);
+            if (!entryComplete) {
+                success = false;
+                break;
+            }
         }
-        occurrenceArgIndex = 5;
-        
-    } else if (commandName == "hex-by-rdecimal") {
-        if (fourthArg.empty()) {
-            hexDataToReplace = decimalToReversedHex(secondArg);
-            hexDataReplacement = decimalToReversedHex(thirdArg);
-        } else {
-            if (!isValidNumber(fourthArg))
-                return;
-            const size_t byteSize = ult::stoi(fourthArg);
-            hexDataToReplace = decimalToReversedHex(secondArg, byteSize);
-            hexDataReplacement = decimalToReversedHex(thirdArg, byteSize);
+
+        success = pipeline.finish() && success;
+    }
+
+    unzClose(zipFile);
+    unzipPercentage.store(success ? 100 : -1, std::memory_order_release);
+
+    #if USING_LOGGING_DIRECTIVE
+    if (!success && !disableLogging)
+        logMessage("Failed to extract " + zipFilePath);
+    #endif
+    return success;
+}
+
+/**
+ * @brief Extracts a zip archive from a byte stream using only its local headers.
+ *
+ * Fed the HTTP body chunk by chunk, it inflates entries straight into an UnzipWritePipeline,
+ * so the archive itself never touches the SD card. Only header and descriptor bytes are
+ * buffered, and those are bounded by the zip format. Parsing stops at the central
+ * directory. Encrypted entries, unknown methods and stored entries with a trailing data
+ * descriptor cannot be delimited this way; they mark the stream unsupported so the caller
+ * can fall back to a temporary file.
+ */
+class ZipStreamExtractor {
+public:
+    ZipStreamExtractor(const std::string& destination, const UnzipFilter& filter)
+        : destinationPath(destination), filter(filter), pipeline(UNZIP_READ_BUFFER, 0), scratch(SCRATCH_SIZE) {
+        if (!destinationPath.empty() && destinationPath.back() != '/')
+            destinationPath += '/';
+        createDirectory(destinationPath);
+        std::memset(&inflater, 0, sizeof(inflater));
+        if (inflateInit2(&inflater, -MAX_WBITS) == Z_OK)
+            inflaterReady = true;
+        else
+            state = State::Failed;
+    }
+
+    ~ZipStreamExtractor() {
+        finish();
+        if (inflaterReady)
+            inflateEnd(&inflater);
+    }
+
+    // Consumes the next piece of the archive; false once the stream cannot continue
+    bool feed(const u8* data, size_t length) {
+        while (length > 0) {
+            size_t used = 0;
+            switch (state) {
+                case State::LocalHeader: used = consumeLocalHeader(data, length); break;
+                case State::EntryData:   used = consumeEntryData(data, length); break;
+                case State::Descriptor:  used = consumeDescriptor(data, length); break;
+                case State::Done:        return true;  // central directory and trailer are not needed
+                default:                 return false;
+            }
+            data += used;
+            length -= used;
         }
-        occurrenceArgIndex = 5;
-        
-    } else {
-        return;
+        return state != State::Failed && state != State::Unsupported;
     }
-    
-    // Handle occurrence parameter if present
-    if (cmd.size() >= occurrenceArgIndex + 1) {
-        std::string occurrenceStr = cmd[occurrenceArgIndex];
-        removeQuotes(occurrenceStr);
-        if (!isValidNumber(occurrenceStr))
-            return;
-        const size_t occurrence = ult::stoi(occurrenceStr);
-        hexEditFindReplace(sourcePath, hexDataToReplace, hexDataReplacement, occurrence);
-    } else {
-        hexEditFindReplace(sourcePath, hexDataToReplace, hexDataReplacement);
+
+    // Flushes the writer; true once the whole archive was extracted
+    bool finish() {
+        if (chunk) {
+            chunk->closeFile = chunk->discardFile = true;
+            pipeline.submit(chunk);
+            chunk = nullptr;
+        }
+        return pipeline.finish() && state == State::Done;
     }
-}
 
-void handleHexByCustom(const std::string& sourcePath, const std::string& customPattern, const std::string& offset, std::string hexDataReplacement, const std::string& commandName, std::string byteGroupSize) {
-    if (hexDataReplacement != NULL_STR) {
-        if (commandName == "hex-by-custom-decimal-offset") {
-            if (!byteGroupSize.empty()) {
-                if (!isValidNumber(byteGroupSize)) {
+    bool unsupported() const {
+        return state == State::Unsupported;
+    }
+
+    static size_t writeCallback(char* data, size_t size, size_t count, void* userData) {
+        const size_t length = size * count;
+        if (abortUnzip.load(std::memory_order_acquire))
+            return 0;
+        return static_cast<ZipStreamExtractor*>(userData)->feed(reinterpret_cast<const u8*>(data), length) ? length : 0;
+    }
+
+private:
+    enum class State { LocalHeader, EntryData, Descriptor, Done, Failed, Unsupported };
+
+    static constexpr u32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+    static constexpr u32 DESCRIPTOR_SIGNATURE = 0x08074b50;
+    static constexpr u32 CENTRAL_DIRECTORY_SIGNATURE = 0x02014b50;
+    static constexpr u32 END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+    static constexpr size_t LOCAL_HEADER_SIZE = 30;
+    static constexpr size_t SCRATCH_SIZE = 65536;
+    static constexpr u64 UNKNOWN_SIZE = ~0ULL;
+
+    std::string destinationPath;
+    const UnzipFilter& filter;
+    UnzipWritePipeline pipeline;
+    UnzipWritePipeline::Chunk* chunk = nullptr;
+    std::vector<u8> pending;   // header or descriptor bytes split across feeds
+    std::vector<u8> scratch;   // inflate target for skipped entries
+    z_stream inflater;
+    bool inflaterReady = false;
+    State state = State::LocalHeader;
+
+    // Current entry
+    u16 method = 0;
+    bool hasDescriptor = false;
+    bool zip64 = false;
+    bool writing = false;
+    u32 expectedCrc = 0;
+    u32 runningCrc = 0;
+    u64 remainingCompressed = 0;
+
+    static u16 read16(const u8* p) { return static_cast<u16>(p[0] | (p[1] << 8)); }
+    static u32 read32(const u8* p) { return static_cast<u32>(read16(p)) | (static_cast<u32>(read16(p + 2)) << 16); }
+    static u64 read64(const u8* p) { return static_cast<u64>(read32(p)) | (static_cast<u64>(read32(p + 4)) << 32); }
+
+    // Buffers bytes until pending holds target bytes; returns the bytes taken
+    size_t takeBytes(const u8* data, size_t length, size_t target) {
+        const size_t taken = std::min(length, target > pending.size() ? target - pending.size() : 0);
+        pending.insert(pending.end(), data, data + taken);
+        return taken;
+    }
+
+    size_t consumeLocalHeader(const u8* data, size_t length) {
+        size_t used = takeBytes(data, length, 4);
+        if (pending.size() < 4)
+            return used;
+
+        const u32 signature = read32(pending.data());
+        if (signature == CENTRAL_DIRECTORY_SIGNATURE || signature == END_OF_CENTRAL_DIRECTORY_SIGNATURE) {
+            state = State::Done;
+            return length;
+        }
+        if (signature != LOCAL_HEADER_SIGNATURE) {
+            state = State::Failed;
+            return length;
+        }
+
+        used += takeBytes(data + used, length - used, LOCAL_HEADER_SIZE);
+        if (pending.size() < LOCAL_HEADER_SIZE)
+            return used;
+        const size_t headerSize = LOCAL_HEADER_SIZE + read16(&pending[26]) + read16(&pending[28]);
+        used += takeBytes(data + used, length - used, headerSize);
+        if (pending.size() == headerSize)
+            beginEntry();
+        return used;
+    }
+
+    void beginEntry() {
+        const u8* header = pending.data();
+        const u16 flags = read16(header + 6);
+        method = read16(header + 8);
+        expectedCrc = read32(header + 14);
+        u64 compressedSize = read32(header + 18);
+        u64 uncompressedSize = read32(header + 22);
+        const size_t nameLength = read16(header + 26);
+        const size_t extraEnd = LOCAL_HEADER_SIZE + nameLength + read16(header + 28);
+        std::string name(reinterpret_cast<const char*>(header) + LOCAL_HEADER_SIZE, nameLength);
+
+        // ZIP64 extended information carries the real sizes
+        zip64 = false;
+        for (size_t pos = LOCAL_HEADER_SIZE + nameLength; pos + 4 <= extraEnd; pos += 4 + read16(header + pos + 2)) {
+            if (read16(header + pos) != 0x0001)
+                continue;
+            zip64 = true;
+            size_t field = pos + 4;
+            if (uncompressedSize == 0xFFFFFFFF && field + 8 <= extraEnd) {
+                uncompressedSize = read64(header + field);
+                field += 8;
+            }
+            if (compressedSize == 0xFFFFFFFF && field + 8 <= extraEnd)
+                compressedSize = read64(header + field);
+        }
+        pending.clear();
+
+        hasDescriptor = (flags & 0x0008) != 0;
+        if ((flags & 0x0001) || (method != 0 && method != 8) || (method == 0 && hasDescriptor)) {
+            state = State::Unsupported;
+            return;
+        }
+
+        remainingCompressed = hasDescriptor ? UNKNOWN_SIZE : compressedSize;
+        runningCrc = crc32(0L, Z_NULL, 0);
+        writing = false;
+        if (method == 8)
+            inflateReset(&inflater);
+
+        if (filter.apply(name)) {
+            const std::string outputPath = destinationPath + name;
+            if (outputPath.back() == '/') {
+                createDirectory(outputPath);
+            } else {
+                createDirectory(outputPath.substr(0, outputPath.rfind('/') + 1));
+                if (!(chunk = pipeline.acquire())) {
+                    state = State::Failed;
                     return;
                 }
-                hexDataReplacement = decimalToHex(hexDataReplacement, ult::stoi(byteGroupSize));
-            } else {
-                hexDataReplacement = decimalToHex(hexDataReplacement);
+                // Entries are written beside their target and only replace it once complete
+                chunk->openPath = outputPath + ".tmp";
+                chunk->finalPath = protectedOutputPath(outputPath);
+                writing = true;
             }
-        } else if (commandName == "hex-by-custom-rdecimal-offset") {
-            if (!byteGroupSize.empty()) {
-                if (!isValidNumber(byteGroupSize)) {
-                    return;
+        }
+
+        state = State::EntryData;
+        if (remainingCompressed == 0)
+            endEntryData();
+    }
+
+    // Space for the next output bytes of the current entry
+    bool outputSpace(u8*& out, size_t& space) {
+        if (!writing) {
+            out = scratch.data();
+            space = scratch.size();
+            return true;
+        }
+        if (chunk->size == chunk->data.size()) {
+            pipeline.submit(chunk);
+            if (!(chunk = pipeline.acquire()))
+                return false;
+        }
+        out = reinterpret_cast<u8*>(chunk->data.data()) + chunk->size;
+        space = chunk->data.size() - chunk->size;
+        return true;
+    }
+
+    void commitOutput(const u8* out, size_t produced) {
+        if (!writing)
+            return;
+        runningCrc = crc32(runningCrc, out, static_cast<uInt>(produced));
+        chunk->size += produced;
+    }
+
+    size_t consumeEntryData(const u8* data, size_t length) {
+        const size_t available = static_cast<size_t>(std::min<u64>(length, remainingCompressed));
+        size_t used = 0;
+        bool entryEnded = false;
+
+        if (method == 0) {
+            while (used < available) {
+                u8* out;
+                size_t space;
+                if (!outputSpace(out, space)) {
+                    state = State::Failed;
+                    return length;
                 }
-                hexDataReplacement = decimalToReversedHex(hexDataReplacement, ult::stoi(byteGroupSize));
-            } else {
-                hexDataReplacement = decimalToReversedHex(hexDataReplacement);
+                const size_t copied = std::min(space, available - used);
+                std::memcpy(out, data + used, copied);
+                commitOutput(out, copied);
+                used += copied;
+            }
+            entryEnded = remainingCompressed == used;
+        } else {
+            inflater.next_in = const_cast<Bytef*>(data);
+            inflater.avail_in = static_cast<uInt>(available);
+            int result;
+            do {
+                u8* out;
+                size_t space;
+                if (!outputSpace(out, space)) {
+                    state = State::Failed;
+                    return length;
+                }
+                inflater.next_out = out;
+                inflater.avail_out = static_cast<uInt>(space);
+                result = inflate(&inflater, Z_NO_FLUSH);
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                    state = State::Failed;
+                    return length;
+                }
+                commitOutput(out, space - inflater.avail_out);
+            // A full output buffer may hide more pending output
+            } while (result == Z_OK && (inflater.avail_in > 0 || inflater.avail_out == 0));
+
+            used = available - inflater.avail_in;
+            entryEnded = result == Z_STREAM_END;
+            // With a known size, the deflate stream must end exactly with the compressed data
+            if (remainingCompressed != UNKNOWN_SIZE && entryEnded != (remainingCompressed == used) && inflater.avail_out != 0) {
+                state = State::Failed;
+                return length;
             }
         }
-        hexEditByCustomOffset(sourcePath, customPattern, offset, hexDataReplacement);
+
+        if (remainingCompressed != UNKNOWN_SIZE)
+            remainingCompressed -= used;
+        if (entryEnded)
+            endEntryData();
+        return used;
+    }
+
+    void endEntryData() {
+        if (hasDescriptor)
+            state = State::Descriptor;
+        else
+            completeEntry();
+    }
+
+    size_t consumeDescriptor(const u8* data, size_t length) {
+        const size_t descriptorSize = zip64 ? 20 : 12;
+        size_t used = takeBytes(data, length, 4);
+        if (pending.size() < 4)
+            return used;
+
+        // The descriptor signature is optional
+        const size_t target = (read32(pending.data()) == DESCRIPTOR_SIGNATURE) ? 4 + descriptorSize : descriptorSize;
+        used += takeBytes(data + used, length - used, target);
+        if (pending.size() < target)
+            return used;
+
+        expectedCrc = read32(pending.data() + target - descriptorSize);
+        pending.clear();
+        completeEntry();
+        return used;
+    }
+
+    void completeEntry() {
+        state = State::LocalHeader;
+        if (!writing)
+            return;
+
+        const bool crcMatches = runningCrc == expectedCrc;
+        chunk->closeFile = true;
+        chunk->discardFile = !crcMatches;
+        pipeline.submit(chunk);
+        chunk = nullptr;
+        writing = false;
+        if (!crcMatches)
+            state = State::Failed;
+    }
+};
+
+static int streamTransferProgress(void*, curl_off_t downloadTotal, curl_off_t downloadNow, curl_off_t, curl_off_t) {
+    if (abortDownload.load(std::memory_order_acquire))
+        return 1;
+    if (downloadTotal > 0)
+        downloadPercentage.store(static_cast<int>(std::min<curl_off_t>(99, downloadNow * 100 / downloadTotal)), std::memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Downloads a zip and extracts it while it arrives (see ZipStreamExtractor).
+ *
+ * Archives the stream parser cannot delimit are downloaded to a temporary file and
+ * extracted from there instead.
+ */
+bool downloadAndExtractZip(const std::string& url, const std::string& destinationPath, const UnzipFilter& filter = {}) {
+    CURL* curl = networkSession.takeHandle(url);
+    if (!curl)
+        return false;
+
+    bool streamed = false;
+    bool unsupported = false;
+    {
+        ZipStreamExtractor extractor(destinationPath, filter);
+        configureTransfer(curl, url);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, ZipStreamExtractor::writeCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &extractor);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, streamTransferProgress);
+
+        downloadPercentage.store(0, std::memory_order_release);
+        const CURLcode result = curl_easy_perform(curl);
+        streamed = extractor.finish() && result == CURLE_OK;
+        unsupported = extractor.unsupported();
+    }
+    networkSession.returnHandle(url, curl);
+
+    if (!unsupported) {
+        downloadPercentage.store(streamed ? 100 : -1, std::memory_order_release);
+        return streamed;
+    }
+
+    #if USING_LOGGING_DIRECTIVE
+    if (!disableLogging)
+        logMessage("Archive cannot be streamed, extracting from a temporary file: " + url);
+    #endif
+    const std::string archivePath = DOWNLOADS_PATH + "download-unzip.zip";
+    const bool success = downloadFileResumable(url, archivePath) && extractZipArchive(archivePath, destinationPath, filter);
+    deleteFileOrDirectory(archivePath);
+    return success;
+}
+
+void handleUnzipCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    std::string sourcePath, destinationPath;
+    UnzipFilter filter;
+
+    for (size_t i = 1; i < cmd.size(); ++i) {
+        if (filter.parseArgument(cmd, i)) {
+            continue;
+        } else if (sourcePath.empty()) {
+            sourcePath = cmd[i];
+            preprocessPath(sourcePath, packagePath);
+        } else if (destinationPath.empty()) {
+            destinationPath = cmd[i];
+            preprocessPath(destinationPath, packagePath);
+        }
+    }
+
+    if (sourcePath.empty() || destinationPath.empty())
+        return;
+
+    const bool extractSuccess = extractZipArchive(sourcePath, destinationPath, filter);
+    hexOffsetIndex.invalidateUnder(destinationPath);
+
+    commandSuccess.store(
+        extractSuccess &&
+        commandSuccess.load(std::memory_order_acquire),
+        std::memory_order_release
+    );
+}
+
+
+void handleDownloadUnzipCommand(const std::vector<std::string>& cmd, const std::string& packagePath) {
+    std::string fileUrl, destinationPath;
+    UnzipFilter filter;
+
+    for (size_t i = 1; i < cmd.size(); ++i) {
+        if (filter.parseArgument(cmd, i)) {
+            continue;
+        } else if (fileUrl.empty()) {
+            fileUrl = cmd[i];
+            preprocessUrl(fileUrl);
+        } else if (destinationPath.empty()) {
+            destinationPath = cmd[i];
+            preprocessPath(destinationPath, packagePath);
+        }
+    }
+
+    if (fileUrl.empty() || destinationPath.empty() || ult::limitedMemory)
+        return;
+    if (!networkSession.acquire())
+        return;
+
+    bool extractSuccess = false;
+    for (size_t i = 0; i < 3; ++i) {
+        extractSuccess = downloadAndExtractZip(fileUrl, destinationPath, filter);
+        if (abortDownload.load(std::memory_order_acquire) || abortUnzip.load(std::memory_order_acquire)) {
+            extractSuccess = false;
+            break;
+        }
+        if (extractSuccess)
+            break;
+        if (i < 2)
+            svcSleepThread(200'000'000);
     }
+    networkSession.release();
+    hexOffsetIndex.invalidateUnder(destinationPath);
+
+    commandSuccess.store(
+        extractSuccess &&
+        commandSuccess.load(std::memory_order_acquire),
+        std::memory_order_release
+    );
 }
 
 
@@ -4309,12 +8622,6 @@ void rebootToHekateConfig(Payload::HekateConfigList& configList, const std::stri
     }
 }
 
-inline std::string getUnquoted(const std::vector<std::string>& cmd, size_t index) {
-    std::string value = cmd[index];
-    removeQuotes(value);
-    return value;
-}
-
 inline void setCommandFailed() {
     commandSuccess.store(false, std::memory_order_release);
 }
@@ -4416,18 +8723,22 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
             preprocessUrl(fileUrl);
             std::string destinationPath = cmd[2];
             preprocessPath(destinationPath, packagePath);
+            DownloadOptions downloadOptions;
+            for (size_t i = 3; i + 1 < cmdSize; ++i) {
+                if (cmd[i] == "-sha256") {
+                    downloadOptions.expectedSha256 = getUnquoted(cmd, ++i);
+                } else if (cmd[i] == "-size") {
+                    downloadOptions.expectedSize = std::strtoll(getUnquoted(cmd, ++i).c_str(), nullptr, 10);
+                }
+            }
             bool downloadSuccess = false;
             if (!ult::limitedMemory) {
-                Result rc;
-                if (R_FAILED(rc = socketInitializeDefault())) {
-                    return;
-                }
-                if (R_FAILED(rc = nifmInitialize(NifmServiceType_User))) {
-                    socketExit();
+                if (!networkSession.acquire()) {
                     return;
                 }
                 for (size_t i = 0; i < 3; ++i) {
-                    downloadSuccess = downloadFile(fileUrl, destinationPath);
+                    // Retries continue from the partial file instead of byte zero
+                    downloadSuccess = downloadFileResumable(fileUrl, destinationPath, downloadOptions);
                     if (abortDownload.load(std::memory_order_acquire)) {
                         downloadSuccess = false;
                         break;
@@ -4439,8 +8750,10 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                         svcSleepThread(200'000'000);
                     }
                 }
-                nifmExit();
-                socketExit();
+                networkSession.release();
+                hexOffsetIndex.invalidateUnder(destinationPath);
+                if (activeBatchCache)
+                    activeBatchCache->invalidate(ResumableDownload::resolveDestination(fileUrl, destinationPath));
             }
             commandSuccess.store(
                 downloadSuccess &&
@@ -4449,17 +8762,9 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
             );
         }
     } else if (commandName == "unzip") {
-        if (cmdSize >= 3) {
-            std::string sourcePath = cmd[1];
-            preprocessPath(sourcePath, packagePath);
-            std::string destinationPath = cmd[2];
-            preprocessPath(destinationPath, packagePath);
-            commandSuccess.store(
-                unzipFile(sourcePath, destinationPath) &&
-                commandSuccess.load(std::memory_order_acquire),
-                std::memory_order_release
-            );
-        }
+        handleUnzipCommand(cmd, packagePath);
+    } else if (commandName == "download-unzip") {
+        handleDownloadUnzipCommand(cmd, packagePath);
     } else if (commandName == "pchtxt2ips") {
         if (cmdSize >= 3) {
             std::string sourcePath = cmd[1];
@@ -4467,7 +8772,7 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
             std::string destinationPath = cmd[2];
             preprocessPath(destinationPath, packagePath);
             commandSuccess.store(
-                pchtxt2ips(sourcePath, destinationPath) &&
+                convertPchtxtToIps(sourcePath, destinationPath) &&
                 commandSuccess.load(std::memory_order_acquire),
                 std::memory_order_release
             );
@@ -4477,7 +8782,7 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
             std::string sourcePath = cmd[1];
             preprocessPath(sourcePath, packagePath);
             commandSuccess.store(
-                pchtxt2cheat(sourcePath) &&
+                convertPchtxtToCheat(sourcePath) &&
                 commandSuccess.load(std::memory_order_acquire),
                 std::memory_order_release
             );
@@ -4512,17 +8817,11 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
         if (launchUpdaterPayload) {
             const std::string rebootOption = PAYLOADS_PATH + "ultrahand_updater.bin";
             if (!isFile(rebootOption)) {
-                Result rc;
-                if (R_FAILED(rc = socketInitializeDefault())) {
-                    return;
-                }
-                if (R_FAILED(rc = nifmInitialize(NifmServiceType_User))) {
-                    socketExit();
+                if (!networkSession.acquire()) {
                     return;
                 }
-                downloadFile(UPDATER_PAYLOAD_URL, PAYLOADS_PATH, true);
-                nifmExit();
-                socketExit();
+                downloadFileResumable(UPDATER_PAYLOAD_URL, PAYLOADS_PATH, {}, true);
+                networkSession.release();
                 downloadPercentage.store(-1, std::memory_order_release);
             }
             if (isFile(rebootOption)) {
@@ -4607,10 +8906,10 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
         if (cmdSize >= 2) {
             const std::string selection = getUnquoted(cmd, 1);
             if (selection == "overlays") {
-                setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, TRUE_STR);
+                settingsStore.setBool(Setting::InOverlay, true);
             } else if (selection == "packages") {
-                setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "to_packages", TRUE_STR);
-                setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, TRUE_STR);
+                settingsStore.setBool(Setting::ToPackages, true);
+                settingsStore.setBool(Setting::InOverlay, true);
             }
         }
         exitingUltrahand.store(true, std::memory_order_release);
@@ -4794,8 +9093,10 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
                 deleteFileOrDirectory(defaultLogFilePath);
                 #endif
             }
-            else if (clearOption == "hex_sum_cache") 
+            else if (clearOption == "hex_sum_cache") {
                 hexSumCache.clear();
+                hexOffsetIndex.clear();
+            }
         }
     }
 }
@@ -4829,6 +9130,9 @@ struct InterpreterWorkData {
     std::vector<std::vector<std::string>> commands;
     std::string packagePath;
     std::string selectedCommand;
+    std::vector<std::string> batchEntries;  // non-empty: commands is a template applied per entry
+    std::vector<u32> batchIndices;
+    std::function<void()> task;             // when set, runs instead of commands
     
     InterpreterWorkData(std::vector<std::vector<std::string>>&& cmds, 
                        const std::string& path, 
@@ -4861,7 +9165,7 @@ void backgroundInterpreter(void* workPtr) {
     
 
     // Process the work if we have commands
-    if (!workData->commands.empty()) {
+    if (!workData->commands.empty() || workData->task) {
         // Clear flags and setup for execution
         clearInterpreterFlags();
         resetPercentages();
@@ -4870,9 +9174,16 @@ void backgroundInterpreter(void* workPtr) {
         runningInterpreter.store(true, std::memory_order_release);
         
         // Execute the commands
-        interpretAndExecuteCommands(std::move(workData->commands), 
-                                   std::move(workData->packagePath), 
-                                   std::move(workData->selectedCommand));
+        if (workData->task) {
+            workData->task();
+        } else if (!workData->batchEntries.empty()) {
+            interpretAndExecuteBatch(workData->commands, workData->batchEntries, workData->batchIndices,
+                                     workData->packagePath, workData->selectedCommand);
+        } else {
+            interpretAndExecuteCommands(std::move(workData->commands), 
+                                       std::move(workData->packagePath), 
+                                       std::move(workData->selectedCommand));
+        }
 
         // Brief sleep before cleanup
         svcSleepThread(200'000'000);
@@ -4944,20 +9255,8 @@ int getInterpreterStackSize(const std::string& packagePath = "") {
 
 
 
-// Combined function - creates thread with work data directly
-void executeInterpreterCommands(std::vector<std::vector<std::string>>&& commands, 
-                               const std::string& packagePath = "", 
-                               const std::string& selectedCommand = "") {
-    
-    // Wait for the existing thread to finish
-    threadWaitForExit(&interpreterThread);
-    threadClose(&interpreterThread);
-
-    // Early exit if no commands
-    if (commands.empty()) {
-        return;
-    }
-
+// Starts the interpreter thread on prepared work data (the thread takes ownership); false if it could not be created
+static bool launchInterpreterThread(InterpreterWorkData* workData) {
     if (ult::expandedMemory && ult::useSoundEffects) {
         //clearSoundCacheNow.store(true, std::memory_order_release);
         if (triggerEnterSound.exchange(false)) {
@@ -4975,14 +9274,11 @@ void executeInterpreterCommands(std::vector<std::vector<std::string>>&& commands
     }
     
     // Get stack size and setup logging
-    const int stackSize = getInterpreterStackSize(packagePath);
+    const int stackSize = getInterpreterStackSize(workData->packagePath);
     
     // Ensure exit flag is clear before starting
     interpreterThreadExit.store(false, std::memory_order_release);
     
-    // Create work data (will be cleaned up by the thread)
-    auto workData = new InterpreterWorkData(std::move(commands), packagePath, selectedCommand);
-    
     // Create and start thread directly with work data
     const int result = threadCreate(&interpreterThread, backgroundInterpreter, workData, nullptr, stackSize, 0x2B, -2);
     if (result != 0) {
@@ -5000,7 +9296,191 @@ void executeInterpreterCommands(std::vector<std::vector<std::string>>&& commands
         logFilePath = defaultLogFilePath;
         disableLogging = true;
         #endif
-        return;
+        return false;
     }
     threadStart(&interpreterThread);
+    return true;
+}
+
+// Combined function - creates thread with work data directly
+void executeInterpreterCommands(std::vector<std::vector<std::string>>&& commands, 
+                               const std::string& packagePath = "", 
+                               const std::string& selectedCommand = "") {
+    
+    // Wait for the existing thread to finish
+    threadWaitForExit(&interpreterThread);
+    threadClose(&interpreterThread);
+
+    // Early exit if no commands
+    if (commands.empty()) {
+        return;
+    }
+
+    // Create work data (will be cleaned up by the thread)
+    launchInterpreterThread(new InterpreterWorkData(std::move(commands), packagePath, selectedCommand));
+}
+
+// Runs a command template over many entries on the interpreter thread (see interpretAndExecuteBatch)
+void executeInterpreterBatch(const std::vector<std::vector<std::string>>& commandTemplate,
+                             std::vector<std::string>&& entries,
+                             std::vector<u32>&& entryIndices,
+                             const std::string& packagePath = "", 
+                             const std::string& selectedCommand = "") {
+    
+    // Wait for the existing thread to finish
+    threadWaitForExit(&interpreterThread);
+    threadClose(&interpreterThread);
+
+    if (commandTemplate.empty() || entries.empty()) {
+        return;
+    }
+
+    auto workData = new InterpreterWorkData(std::vector<std::vector<std::string>>(commandTemplate), packagePath, selectedCommand);
+    workData->batchEntries = std::move(entries);
+    workData->batchIndices = std::move(entryIndices);
+    launchInterpreterThread(workData);
 }
+
+/**
+ * @brief Boot commands that run on their own thread instead of blocking startup.
+ *
+ * add() runs every command up to the last `barrier` line right away, for work the menu depends
+ * on, and queues the rest with the try:/erista:/mariko: state the split left them in; start()
+ * hands the queue to a worker, which works through it (showing each completion notification)
+ * whether or not the overlay is visible. Runs are serialized with interpreter runs through
+ * interpreterStateMutex, but do not set runningInterpreter, so menus stay usable meanwhile.
+ * They cannot be aborted from the UI; abort() stops them when the overlay exits.
+ */
+class DeferredBootCommands {
+public:
+    void add(std::vector<std::vector<std::string>>&& commands, const std::string& packagePath,
+             const std::string& section, const std::string& notification = "") {
+        size_t barrierIndex = commands.size();
+        for (size_t i = commands.size(); i-- > 0;) {
+            if (!commands[i].empty() && commands[i][0] == BARRIER_STR) {
+                barrierIndex = i;
+                break;
+            }
+        }
+
+        Job job{{}, packagePath, section, notification, {}};
+        if (barrierIndex != commands.size()) {
+            std::vector<std::vector<std::string>> blockingCommands;
+            for (size_t i = 0; i < barrierIndex; ++i) {
+                if (commands[i].empty() || commands[i][0] != BARRIER_STR)
+                    blockingCommands.push_back(std::move(commands[i]));
+            }
+            job.commands.assign(std::make_move_iterator(commands.begin() + barrierIndex + 1),
+                                std::make_move_iterator(commands.end()));
+
+            // The deferred part continues in the sections the blocking part ended in
+            runNow(std::move(blockingCommands), packagePath, section, &job.state);
+        } else {
+            job.commands = std::move(commands);
+        }
+
+        job.commands.erase(std::remove_if(job.commands.begin(), job.commands.end(),
+            [](const std::vector<std::string>& command) { return !command.empty() && command[0] == BARRIER_STR; }),
+            job.commands.end());
+
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        jobs.push_back(std::move(job));
+    }
+
+    // Starts the worker on the queued sections unless it is already working through them
+    void start() {
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            if (jobs.empty() || running.load(std::memory_order_acquire))
+                return;
+            running.store(true, std::memory_order_release);
+        }
+
+        if (!worker.tryStart([this]() { runQueued(); }, static_cast<size_t>(getInterpreterStackSize()), 0x2B))
+            runRemaining();
+    }
+
+    // Boot runs ignore the abort input so a section is never left half applied
+    bool active() const {
+        return running.load(std::memory_order_acquire);
+    }
+
+    // Runs whatever is still queued on the calling thread (no worker could be started)
+    void runRemaining() {
+        std::deque<Job> remaining;
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            remaining.swap(jobs);
+        }
+        for (auto& job : remaining)
+            runNow(std::move(job.commands), job.packagePath, job.section, &job.state);
+        running.store(false, std::memory_order_release);
+    }
+
+    // Overlay exit: drops queued sections and aborts the one in progress instead of waiting it out
+    void abort() {
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex);
+            jobs.clear();
+        }
+        if (running.load(std::memory_order_acquire))
+            clearInterpreterFlags(true);
+        worker.join();
+        clearInterpreterFlags();
+        running.store(false, std::memory_order_release);
+    }
+
+private:
+    inline static const std::string BARRIER_STR = "barrier";
+
+    struct Job {
+        std::vector<std::vector<std::string>> commands;
+        std::string packagePath;
+        std::string section;
+        std::string notification;
+        CommandListState state;
+    };
+
+    std::mutex jobsMutex;
+    std::deque<Job> jobs;
+    std::atomic<bool> running{false};
+    BackgroundJob worker;
+
+    // Worker thread: drains the queue, including sections added while it runs
+    void runQueued() {
+        while (true) {
+            Job job;
+            {
+                std::lock_guard<std::mutex> lock(jobsMutex);
+                if (jobs.empty()) {
+                    running.store(false, std::memory_order_release);
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            runNow(std::move(job.commands), job.packagePath, job.section, &job.state);
+            if (!job.notification.empty() && tsl::notification)
+                tsl::notification->show(job.notification);
+        }
+    }
+
+    static void runNow(std::vector<std::vector<std::string>>&& commands, const std::string& packagePath,
+                       const std::string& section, CommandListState* state) {
+        if (commands.empty())
+            return;
+        const bool resetCommandSuccess = !commandSuccess.load(std::memory_order_acquire);
+        {
+            std::lock_guard<std::recursive_mutex> stateLock(interpreterStateMutex);
+            beginInterpreterRun(packagePath);
+            bool aborted = false;
+            runCommandList(std::move(commands), packagePath, section, aborted, state);
+            endInterpreterRun();
+        }
+        resetPercentages();
+        if (resetCommandSuccess)
+            commandSuccess.store(false, std::memory_order_release);
+    }
+};
+
+static DeferredBootCommands deferredBootCommands;